@@ -297,6 +297,8 @@ struct FlowGraph {
 		const RTLIL::Process *process = nullptr;
 		const Mem *mem = nullptr;
 		int portidx;
+		int cluster = -1; // activity cluster guarding this node in eval(), if any
+		int partition = 0; // thread evaluating this node in eval(), or -1 for the calling thread after the others
 	};
 
 	std::vector<Node*> nodes;
@@ -486,6 +488,15 @@ struct FlowGraph {
 		Node *node = new Node;
 		node->type = Node::Type::EFFECT_SYNC;
 		node->cells = cells;
+		// The node is added after inlining is decided, so its uses are only recorded for partitioning.
+		for (auto cell : cells)
+			for (auto conn : cell->connections())
+				if (cell->input(conn.first))
+					for (auto chunk : conn.second.chunks())
+						if (chunk.wire) {
+							wire_uses[chunk.wire].insert(node);
+							node_uses[node].insert(chunk.wire);
+						}
 		nodes.push_back(node);
 		return node;
 	}
@@ -738,6 +749,9 @@ struct CxxrtlWorker {
 	bool debug_alias = false;
 	bool debug_eval = false;
 
+	bool activity = false;
+	int parallel = 1;
+
 	std::ostringstream f;
 	std::string indent;
 	int temporary = 0;
@@ -753,6 +767,10 @@ struct CxxrtlWorker {
 	dict<RTLIL::SigBit, bool> bit_has_state;
 	dict<const RTLIL::Module*, pool<std::string>> blackbox_specializations;
 	dict<const RTLIL::Module*, bool> eval_converges;
+	dict<const RTLIL::Module*, std::vector<std::vector<const RTLIL::Wire*>>> activity_inputs;
+	dict<const RTLIL::Module*, int> eval_partitions;
+	dict<const RTLIL::Wire*, int> local_partitions;
+	dict<const RTLIL::Module*, bool> serial_modules;
 
 	void inc_indent() {
 		indent += "\t";
@@ -2101,6 +2119,8 @@ struct CxxrtlWorker {
 	{
 		int mem_init_idx = 0;
 		inc_indent();
+			if (activity_inputs.count(module) && !activity_inputs.at(module).empty())
+				f << indent << "activity_valid = false;\n";
 			for (auto wire : module->wires()) {
 				const auto &wire_type = wire_types[wire];
 				if (!wire_type.is_named() || wire_type.is_local()) continue;
@@ -2164,58 +2184,154 @@ struct CxxrtlWorker {
 		dec_indent();
 	}
 
-	void dump_eval_method(RTLIL::Module *module)
+	void dump_activity_guard(RTLIL::Module *module, int cluster)
 	{
+		const auto &inputs = activity_inputs.at(module).at(cluster);
+		f << indent << "// activity cluster " << cluster << "\n";
+		f << indent << "if (!activity_valid";
+		for (int i = 0; i < GetSize(inputs); i++) {
+			f << " ||\n" << indent << "    activity_" << cluster << "_" << i << " != ";
+			dump_sigspec_rhs(RTLIL::SigSpec(const_cast<RTLIL::Wire*>(inputs[i])));
+		}
+		f << ") {\n";
 		inc_indent();
-			f << indent << "bool converged = " << (eval_converges.at(module) ? "true" : "false") << ";\n";
-			if (!module->get_bool_attribute(ID(cxxrtl_blackbox))) {
-				for (auto wire : module->wires()) {
-					if (edge_wires[wire]) {
-						for (auto edge_type : edge_types) {
-							if (edge_type.first.wire == wire) {
-								if (edge_type.second != RTLIL::STn) {
-									f << indent << "bool posedge_" << mangle(edge_type.first) << " = ";
-									f << "this->posedge_" << mangle(edge_type.first) << "();\n";
-								}
-								if (edge_type.second != RTLIL::STp) {
-									f << indent << "bool negedge_" << mangle(edge_type.first) << " = ";
-									f << "this->negedge_" << mangle(edge_type.first) << "();\n";
-								}
-							}
+			for (int i = 0; i < GetSize(inputs); i++) {
+				f << indent << "activity_" << cluster << "_" << i << " = ";
+				dump_sigspec_rhs(RTLIL::SigSpec(const_cast<RTLIL::Wire*>(inputs[i])));
+				f << ";\n";
+			}
+		dec_indent();
+	}
+
+	void dump_eval_edges(RTLIL::Module *module)
+	{
+		for (auto wire : module->wires()) {
+			if (edge_wires[wire]) {
+				for (auto edge_type : edge_types) {
+					if (edge_type.first.wire == wire) {
+						if (edge_type.second != RTLIL::STn) {
+							f << indent << "bool posedge_" << mangle(edge_type.first) << " = ";
+							f << "this->posedge_" << mangle(edge_type.first) << "();\n";
+						}
+						if (edge_type.second != RTLIL::STp) {
+							f << indent << "bool negedge_" << mangle(edge_type.first) << " = ";
+							f << "this->negedge_" << mangle(edge_type.first) << "();\n";
 						}
 					}
 				}
-				for (auto wire : module->wires())
-					dump_wire(wire, /*is_local=*/true);
-				for (auto node : schedule[module]) {
-					switch (node.type) {
-						case FlowGraph::Node::Type::CONNECT:
-							dump_connect(node.connect);
-							break;
-						case FlowGraph::Node::Type::CELL_SYNC:
-							dump_cell_sync(node.cell);
-							break;
-						case FlowGraph::Node::Type::CELL_EVAL:
-							dump_cell_eval(node.cell);
-							break;
-						case FlowGraph::Node::Type::EFFECT_SYNC:
-							dump_cell_effect_sync(node.cells);
-							break;
-						case FlowGraph::Node::Type::PROCESS_CASE:
-							dump_process_case(node.process);
-							break;
-						case FlowGraph::Node::Type::PROCESS_SYNC:
-							dump_process_syncs(node.process);
-							break;
-						case FlowGraph::Node::Type::MEM_RDPORT:
-							dump_mem_rdport(node.mem, node.portidx);
-							break;
-						case FlowGraph::Node::Type::MEM_WRPORTS:
-							dump_mem_wrports(node.mem);
-							break;
+			}
+		}
+	}
+
+	void dump_eval_locals(RTLIL::Module *module, int partition)
+	{
+		for (auto wire : module->wires()) {
+			int wire_partition = local_partitions.count(wire) ? local_partitions.at(wire) : 0;
+			if (wire_partition == partition)
+				dump_wire(wire, /*is_local=*/true);
+		}
+	}
+
+	void dump_eval_nodes(RTLIL::Module *module, int partition)
+	{
+		int cluster = -1;
+		for (auto node : schedule[module]) {
+			if (node.partition != partition)
+				continue;
+			if (node.cluster != cluster) {
+				if (cluster != -1) {
+					dec_indent();
+					f << indent << "}\n";
+				}
+				cluster = node.cluster;
+				if (cluster != -1) {
+					dump_activity_guard(module, cluster);
+					inc_indent();
+				}
+			}
+			switch (node.type) {
+				case FlowGraph::Node::Type::CONNECT:
+					dump_connect(node.connect);
+					break;
+				case FlowGraph::Node::Type::CELL_SYNC:
+					dump_cell_sync(node.cell);
+					break;
+				case FlowGraph::Node::Type::CELL_EVAL:
+					dump_cell_eval(node.cell);
+					break;
+				case FlowGraph::Node::Type::EFFECT_SYNC:
+					dump_cell_effect_sync(node.cells);
+					break;
+				case FlowGraph::Node::Type::PROCESS_CASE:
+					dump_process_case(node.process);
+					break;
+				case FlowGraph::Node::Type::PROCESS_SYNC:
+					dump_process_syncs(node.process);
+					break;
+				case FlowGraph::Node::Type::MEM_RDPORT:
+					dump_mem_rdport(node.mem, node.portidx);
+					break;
+				case FlowGraph::Node::Type::MEM_WRPORTS:
+					dump_mem_wrports(node.mem);
+					break;
+			}
+		}
+		if (cluster != -1) {
+			dec_indent();
+			f << indent << "}\n";
+		}
+	}
+
+	void dump_eval_method(RTLIL::Module *module)
+	{
+		inc_indent();
+			if (eval_partitions.count(module)) {
+				// Partitions run concurrently and report convergence separately; the nodes that have to run in order
+				// (i.e. effects, and the instances and logic that depend on them) are evaluated afterwards on
+				// the calling thread.
+				int partitions = eval_partitions.at(module);
+				f << indent << "bool converged = " << (eval_converges.at(module) ? "true" : "false") << ";\n";
+				f << indent << "bool partition_converged[" << partitions << "] = {};\n";
+				f << indent << "eval_pool.run([&](size_t partition) {\n";
+				inc_indent();
+					f << indent << "switch (partition) {\n";
+					for (int partition = 0; partition < partitions; partition++) {
+						f << indent << "\tcase " << partition << ": partition_converged[" << partition << "] = ";
+						f << "eval_partition_" << partition << "(performer); break;\n";
 					}
+					f << indent << "}\n";
+				dec_indent();
+				f << indent << "});\n";
+				dump_eval_edges(module);
+				dump_eval_locals(module, -1);
+				dump_eval_nodes(module, -1);
+				if (activity_inputs.count(module) && !activity_inputs.at(module).empty())
+					f << indent << "activity_valid = true;\n";
+				f << indent << "return converged";
+				for (int partition = 0; partition < partitions; partition++)
+					f << " && partition_converged[" << partition << "]";
+				f << ";\n";
+			} else {
+				f << indent << "bool converged = " << (eval_converges.at(module) ? "true" : "false") << ";\n";
+				if (!module->get_bool_attribute(ID(cxxrtl_blackbox))) {
+					dump_eval_edges(module);
+					dump_eval_locals(module, 0);
+					dump_eval_nodes(module, 0);
+					if (activity_inputs.count(module) && !activity_inputs.at(module).empty())
+						f << indent << "activity_valid = true;\n";
 				}
+				f << indent << "return converged;\n";
 			}
+		dec_indent();
+	}
+
+	void dump_eval_partition_method(RTLIL::Module *module, int partition)
+	{
+		inc_indent();
+			f << indent << "bool converged = " << (eval_converges.at(module) ? "true" : "false") << ";\n";
+			dump_eval_edges(module);
+			dump_eval_locals(module, partition);
+			dump_eval_nodes(module, partition);
 			f << indent << "return converged;\n";
 		dec_indent();
 	}
@@ -2700,6 +2816,20 @@ struct CxxrtlWorker {
 				}
 				if (has_cells)
 					f << "\n";
+				if (eval_partitions.count(module)) {
+					f << indent << "worker_pool eval_pool { " << eval_partitions.at(module) << " };\n";
+					f << "\n";
+				}
+				if (activity_inputs.count(module) && !activity_inputs.at(module).empty()) {
+					// Values of the inputs of each activity cluster when it was last evaluated.
+					f << indent << "bool activity_valid = false;\n";
+					for (int cluster = 0; cluster < GetSize(activity_inputs.at(module)); cluster++) {
+						const auto &inputs = activity_inputs.at(module).at(cluster);
+						for (int i = 0; i < GetSize(inputs); i++)
+							f << indent << "value<" << inputs[i]->width << "> activity_" << cluster << "_" << i << ";\n";
+					}
+					f << "\n";
+				}
 				f << indent << mangle(module) << "(interior) {}\n";
 				f << indent << mangle(module) << "() {\n";
 				inc_indent();
@@ -2710,6 +2840,9 @@ struct CxxrtlWorker {
 				f << indent << "void reset() override;\n";
 				f << "\n";
 				f << indent << "bool eval(performer *performer = nullptr) override;\n";
+				if (eval_partitions.count(module))
+					for (int partition = 0; partition < eval_partitions.at(module); partition++)
+						f << indent << "bool eval_partition_" << partition << "(performer *performer);\n";
 				f << "\n";
 				f << indent << "template<class ObserverT>\n";
 				f << indent << "bool commit(ObserverT &observer) {\n";
@@ -2752,6 +2885,13 @@ struct CxxrtlWorker {
 		f << indent << "bool " << mangle(module) << "::eval(performer *performer) {\n";
 		dump_eval_method(module);
 		f << indent << "}\n";
+		if (eval_partitions.count(module))
+			for (int partition = 0; partition < eval_partitions.at(module); partition++) {
+				f << "\n";
+				f << indent << "bool " << mangle(module) << "::eval_partition_" << partition << "(performer *performer) {\n";
+				dump_eval_partition_method(module, partition);
+				f << indent << "}\n";
+			}
 		if (debug_info) {
 			if (debug_eval) {
 				f << "\n";
@@ -2825,6 +2965,8 @@ struct CxxrtlWorker {
 			f << "#ifdef __cplusplus\n";
 			f << "\n";
 			f << "#include <cxxrtl/cxxrtl.h>\n";
+			if (!eval_partitions.empty())
+				f << "#include <cxxrtl/cxxrtl_parallel.h>\n";
 			f << "\n";
 			f << "using namespace cxxrtl;\n";
 			f << "\n";
@@ -2840,13 +2982,17 @@ struct CxxrtlWorker {
 			*intf_f << f.str(); f.str("");
 		}
 
-		if (split_intf)
+		if (split_intf) {
 			f << "#include \"" << basename(intf_filename) << "\"\n";
-		else
+		} else {
 			f << "#include <cxxrtl/cxxrtl.h>\n";
+			if (!eval_partitions.empty())
+				f << "#include <cxxrtl/cxxrtl_parallel.h>\n";
+		}
 		f << "\n";
 		f << "#if defined(CXXRTL_INCLUDE_CAPI_IMPL) || \\\n";
-		f << "    defined(CXXRTL_INCLUDE_VCD_CAPI_IMPL)\n";
+		f << "    defined(CXXRTL_INCLUDE_VCD_CAPI_IMPL) || \\\n";
+		f << "    defined(CXXRTL_INCLUDE_FST_CAPI_IMPL)\n";
 		f << "#include <cxxrtl/capi/cxxrtl_capi.cc>\n";
 		f << "#endif\n";
 		f << "\n";
@@ -2854,6 +3000,10 @@ struct CxxrtlWorker {
 		f << "#include <cxxrtl/capi/cxxrtl_capi_vcd.cc>\n";
 		f << "#endif\n";
 		f << "\n";
+		f << "#if defined(CXXRTL_INCLUDE_FST_CAPI_IMPL)\n";
+		f << "#include <cxxrtl/capi/cxxrtl_capi_fst.cc>\n";
+		f << "#endif\n";
+		f << "\n";
 		f << "using namespace cxxrtl_yosys;\n";
 		f << "\n";
 		f << "namespace " << design_ns << " {\n";
@@ -2905,6 +3055,290 @@ struct CxxrtlWorker {
 		edge_wires.insert(sigbit.wire);
 	}
 
+	// Nodes that compute combinational values from wires only, and can therefore be skipped as long as none of
+	// the wires they read changed.
+	static bool is_activity_node(const FlowGraph::Node *node)
+	{
+		switch (node->type) {
+			case FlowGraph::Node::Type::CONNECT:
+				return true;
+			case FlowGraph::Node::Type::CELL_EVAL:
+				return is_internal_cell(node->cell->type) && !is_ff_cell(node->cell->type) &&
+				       !is_effectful_cell(node->cell->type);
+			default:
+				return false;
+		}
+	}
+
+	// Collects the wires read by the code emitted for a node, looking through inlined wires, and counts the nodes
+	// that code evaluates.
+	void collect_node_uses(const FlowGraph &flow, FlowGraph::Node *node, pool<const RTLIL::Wire*> &uses, int &weight)
+	{
+		weight++;
+		if (!flow.node_uses.count(node))
+			return;
+		for (auto wire : flow.node_uses.at(node)) {
+			if (wire_types[wire].type == WireType::INLINE)
+				collect_node_uses(flow, *flow.wire_comb_defs.at(wire).begin(), uses, weight);
+			else
+				uses.insert(wire);
+		}
+	}
+
+	// Groups the combinational nodes of eval() into clusters that are only evaluated when one of the wires they read
+	// from outside of the cluster has changed since the last time they were evaluated.
+	void partition_activity(RTLIL::Module *module, FlowGraph &flow, std::vector<FlowGraph::Node*> &order,
+	                        dict<FlowGraph::Node*, int> &node_clusters)
+	{
+		// Clusters evaluating fewer nodes than this are not worth the cost of the guard.
+		const int min_cluster_weight = 4;
+
+		// Nothing in eval() depends on nodes without combinational defs (flip-flops, memory write ports, and so on),
+		// so they can be moved to the end, where they do not split up runs of combinational nodes.
+		std::stable_partition(order.begin(), order.end(), [&](FlowGraph::Node *node) {
+			return flow.node_comb_defs.count(node) != 0;
+		});
+
+		dict<FlowGraph::Node*, pool<const RTLIL::Wire*>> uses;
+		dict<FlowGraph::Node*, int> weights;
+		mfp<FlowGraph::Node*> components;
+		for (auto node : order) {
+			collect_node_uses(flow, node, uses[node], weights[node]);
+			if (is_activity_node(node))
+				components(node);
+		}
+		for (auto node : order) {
+			if (!is_activity_node(node))
+				continue;
+			for (auto wire : uses[node])
+				for (auto def_node : flow.wire_comb_defs[wire])
+					if (uses.count(def_node) && is_activity_node(def_node))
+						components.merge(def_node, node);
+		}
+
+		auto &clusters = activity_inputs[module];
+		std::vector<FlowGraph::Node*> new_order;
+		for (size_t i = 0; i < order.size(); ) {
+			if (!is_activity_node(order[i])) {
+				new_order.push_back(order[i++]);
+				continue;
+			}
+
+			// Within a run of skippable nodes, only nodes of the same component depend on each other, so grouping
+			// the run by component preserves the topological order.
+			std::vector<std::vector<FlowGraph::Node*>> groups;
+			dict<FlowGraph::Node*, int> group_index;
+			for (; i < order.size() && is_activity_node(order[i]); i++) {
+				FlowGraph::Node *root = components.find(order[i]);
+				if (!group_index.count(root)) {
+					group_index[root] = GetSize(groups);
+					groups.emplace_back();
+				}
+				groups[group_index[root]].push_back(order[i]);
+			}
+
+			for (auto &group : groups) {
+				new_order.insert(new_order.end(), group.begin(), group.end());
+
+				int weight = 0;
+				for (auto node : group)
+					weight += weights[node];
+				if (weight < min_cluster_weight)
+					continue;
+
+				pool<FlowGraph::Node*> members(group.begin(), group.end());
+				pool<const RTLIL::Wire*> inputs;
+				for (auto node : group)
+					for (auto wire : uses[node]) {
+						bool is_internal = flow.wire_sync_defs.count(wire) == 0 && !flow.wire_comb_defs[wire].empty();
+						for (auto def_node : flow.wire_comb_defs[wire])
+							if (!members.count(def_node))
+								is_internal = false;
+						if (!is_internal)
+							inputs.insert(wire);
+					}
+
+				for (auto node : group)
+					node_clusters[node] = GetSize(clusters);
+				clusters.emplace_back(inputs.begin(), inputs.end());
+			}
+		}
+		order.swap(new_order);
+
+		// Locals only hold a value while the code that computes them runs, so any local computed in a cluster but read
+		// elsewhere has to become a member.
+		for (auto node : order)
+			for (auto wire : uses[node]) {
+				auto &wire_type = wire_types[wire];
+				if (wire_type.type != WireType::LOCAL)
+					continue;
+				for (auto def_node : flow.wire_comb_defs[wire])
+					if (node_clusters.count(def_node) &&
+					    (!node_clusters.count(node) || node_clusters.at(node) != node_clusters.at(def_node)))
+						wire_type = {WireType::MEMBER};
+			}
+
+		if (!clusters.empty())
+			log("Module `%s' has %d activity clusters.\n", log_id(module), GetSize(clusters));
+	}
+
+	// Instances of a module have to be evaluated on the calling thread if the module is a black box (whose code is
+	// provided by the user, and so may not be thread-safe), or if it contains effects or such instances at any depth.
+	bool is_serial_module(RTLIL::Module *module)
+	{
+		if (serial_modules.count(module))
+			return serial_modules.at(module);
+		bool serial = module->get_bool_attribute(ID(cxxrtl_blackbox));
+		serial_modules[module] = serial;
+		for (auto cell : module->cells()) {
+			if (serial)
+				break;
+			if (is_effectful_cell(cell->type))
+				serial = true;
+			else if (!is_internal_cell(cell->type)) {
+				// an instance of a module we don't know anything about is treated like a black box
+				RTLIL::Module *cell_module = module->design->module(cell->type);
+				serial = cell_module == nullptr || is_serial_module(cell_module);
+			}
+		}
+		serial_modules[module] = serial;
+		return serial;
+	}
+
+	// Splits the nodes of eval() into at most `parallel` partitions that can be evaluated concurrently. Nodes that read
+	// each other's results, or write parts of the same wire, memory or cell, always end up in the same partition.
+	// Effects and instances of serial modules are left to the calling thread, which evaluates them in order once all
+	// partitions are done, together with every node that reads a combinational result of theirs.
+	void partition_eval(RTLIL::Module *module, FlowGraph &flow, const std::vector<FlowGraph::Node*> &order,
+	                    dict<FlowGraph::Node*, int> &node_partitions)
+	{
+		dict<FlowGraph::Node*, pool<const RTLIL::Wire*>> uses;
+		dict<FlowGraph::Node*, int> weights;
+		for (auto node : order)
+			collect_node_uses(flow, node, uses[node], weights[node]);
+
+		pool<FlowGraph::Node*> serial_nodes;
+		for (auto node : order)
+			if (node->type == FlowGraph::Node::Type::EFFECT_SYNC ||
+			    ((node->type == FlowGraph::Node::Type::CELL_EVAL || node->type == FlowGraph::Node::Type::CELL_SYNC) &&
+			     (is_effectful_cell(node->cell->type) ||
+			      (!is_internal_cell(node->cell->type) && is_serial_module(module->design->module(node->cell->type))))))
+				serial_nodes.insert(node);
+		// Feedback arcs can make a node read a result computed later in the order, so repeat until nothing changes.
+		bool changed = !serial_nodes.empty();
+		while (changed) {
+			changed = false;
+			for (auto node : order) {
+				if (serial_nodes.count(node))
+					continue;
+				for (auto wire : uses[node])
+					for (auto def_node : flow.wire_comb_defs[wire])
+						if (serial_nodes.count(def_node) && !serial_nodes.count(node)) {
+							serial_nodes.insert(node);
+							changed = true;
+						}
+			}
+		}
+		auto is_serial = [&](FlowGraph::Node *node) {
+			return serial_nodes.count(node) != 0;
+		};
+
+		mfp<FlowGraph::Node*> components;
+		for (auto node : order)
+			if (!is_serial(node))
+				components(node);
+
+		dict<const RTLIL::Wire*, FlowGraph::Node*> wire_writers;
+		dict<RTLIL::IdString, FlowGraph::Node*> memory_writers;
+		dict<const RTLIL::Cell*, FlowGraph::Node*> cell_owners;
+		auto merge_by_key = [&](auto &owners, const auto &key, FlowGraph::Node *node) {
+			if (owners.count(key))
+				components.merge(owners.at(key), node);
+			else
+				owners[key] = node;
+		};
+		for (auto node : order) {
+			if (is_serial(node))
+				continue;
+			for (auto wire : uses[node])
+				for (auto def_node : flow.wire_comb_defs[wire])
+					if (uses.count(def_node) && !is_serial(def_node))
+						components.merge(def_node, node);
+			if (flow.node_comb_defs.count(node))
+				for (auto wire : flow.node_comb_defs.at(node))
+					merge_by_key(wire_writers, wire, node);
+			if (flow.node_sync_defs.count(node))
+				for (auto wire : flow.node_sync_defs.at(node))
+					merge_by_key(wire_writers, wire, node);
+			if (node->type == FlowGraph::Node::Type::MEM_WRPORTS)
+				merge_by_key(memory_writers, node->mem->memid, node);
+			if (node->type == FlowGraph::Node::Type::PROCESS_SYNC)
+				for (auto sync : node->process->syncs)
+					for (auto &memwr : sync->mem_write_actions)
+						merge_by_key(memory_writers, memwr.memid, node);
+			if ((node->type == FlowGraph::Node::Type::CELL_EVAL || node->type == FlowGraph::Node::Type::CELL_SYNC) &&
+			    !is_internal_cell(node->cell->type))
+				merge_by_key(cell_owners, node->cell, node);
+		}
+
+		// Distribute the components over the partitions, heaviest first, each to the lightest partition so far.
+		std::vector<FlowGraph::Node*> roots;
+		dict<FlowGraph::Node*, int> root_weights;
+		for (auto node : order) {
+			if (is_serial(node))
+				continue;
+			FlowGraph::Node *root = components.find(node);
+			if (!root_weights.count(root))
+				roots.push_back(root);
+			root_weights[root] += weights[node];
+		}
+		std::stable_sort(roots.begin(), roots.end(), [&](FlowGraph::Node *a, FlowGraph::Node *b) {
+			return root_weights.at(a) > root_weights.at(b);
+		});
+		std::vector<int> partition_weights(parallel, 0);
+		dict<FlowGraph::Node*, int> root_partitions;
+		for (auto root : roots) {
+			int partition = std::min_element(partition_weights.begin(), partition_weights.end()) - partition_weights.begin();
+			partition_weights[partition] += root_weights.at(root);
+			root_partitions[root] = partition;
+		}
+		int partitions = 0;
+		for (auto weight : partition_weights)
+			if (weight > 0)
+				partitions++;
+		if (partitions < 2)
+			return;
+
+		for (auto node : order)
+			node_partitions[node] = is_serial(node) ? -1 : root_partitions.at(components.find(node));
+		eval_partitions[module] = partitions;
+
+		// Every partition declares its own locals, so a local shared between partitions has to become a member.
+		dict<const RTLIL::Wire*, pool<int>> wire_partitions;
+		for (auto node : order) {
+			for (auto wire : uses[node])
+				wire_partitions[wire].insert(node_partitions.at(node));
+			if (flow.node_comb_defs.count(node))
+				for (auto wire : flow.node_comb_defs.at(node))
+					wire_partitions[wire].insert(node_partitions.at(node));
+		}
+		for (auto &it : wire_partitions) {
+			auto &wire_type = wire_types[it.first];
+			if (wire_type.type != WireType::LOCAL)
+				continue;
+			if (it.second.size() > 1)
+				wire_type = {WireType::MEMBER};
+			else
+				local_partitions[it.first] = *it.second.begin();
+		}
+
+		log("Module `%s' is evaluated in %d partitions of", log_id(module), partitions);
+		for (auto weight : partition_weights)
+			if (weight > 0)
+				log(" %d", weight);
+		log(" nodes.\n");
+	}
+
 	void analyze_design(RTLIL::Design *design)
 	{
 		bool has_feedback_arcs = false;
@@ -3205,6 +3639,7 @@ struct CxxrtlWorker {
 			// Emit reachable nodes in eval().
 			// Accumulate sync effectful cells per trigger condition.
 			dict<std::pair<RTLIL::SigSpec, RTLIL::Const>, std::vector<const RTLIL::Cell*>> effect_sync_cells;
+			std::vector<FlowGraph::Node*> eval_order;
 			for (auto node : node_order)
 				if (live_nodes[node]) {
 					if (node->type == FlowGraph::Node::Type::CELL_EVAL &&
@@ -3213,12 +3648,23 @@ struct CxxrtlWorker {
 							node->cell->getParam(ID::TRG_WIDTH).as_int() != 0)
 						effect_sync_cells[make_pair(node->cell->getPort(ID::TRG), node->cell->getParam(ID::TRG_POLARITY))].push_back(node->cell);
 					else
-						schedule[module].push_back(*node);
+						eval_order.push_back(node);
 				}
 
-			for (auto &it : effect_sync_cells) {
-				auto node = flow.add_effect_sync_node(it.second);
+			for (auto &it : effect_sync_cells)
+				eval_order.push_back(flow.add_effect_sync_node(it.second));
+
+			dict<FlowGraph::Node*, int> node_clusters, node_partitions;
+			if (activity)
+				partition_activity(module, flow, eval_order, node_clusters);
+			if (parallel > 1 && module->get_bool_attribute(ID::top))
+				partition_eval(module, flow, eval_order, node_partitions);
+			for (auto node : eval_order) {
 				schedule[module].push_back(*node);
+				if (node_clusters.count(node))
+					schedule[module].back().cluster = node_clusters.at(node);
+				if (node_partitions.count(node))
+					schedule[module].back().partition = node_partitions.at(node);
 			}
 
 			// For maximum performance, the state of the simulation (which is the same as the set of its double buffered
@@ -3687,6 +4133,20 @@ struct CxxrtlBackend : public Backend {
 		log("    -O6\n");
 		log("        like -O5, and inline public wires not marked (*keep*) if possible.\n");
 		log("\n");
+		log("    -activity\n");
+		log("        group the combinational logic evaluated by eval() into clusters, and\n");
+		log("        guard each cluster with a comparison of its inputs against their values\n");
+		log("        when it was last evaluated, so that clusters whose inputs did not change\n");
+		log("        are skipped. this speeds up designs where large parts are idle most of\n");
+		log("        the time, at the cost of storing a copy of every cluster input.\n");
+		log("\n");
+		log("    -parallel <N>\n");
+		log("        split the eval() function of the top module into at most <N> partitions\n");
+		log("        of independent logic, which are evaluated concurrently by a pool of\n");
+		log("        threads owned by the module. eval() keeps its interface, and returns\n");
+		log("        once all partitions are done. designs generated this way must be built\n");
+		log("        with thread support (e.g. `-pthread`).\n");
+		log("\n");
 		log("    -g <level>\n");
 		log("        set the debug level. the default is -g%d. higher debug levels provide\n", DEFAULT_DEBUG_LEVEL);
 		log("        more visibility and generate more code, but do not pessimize evaluation.\n");
@@ -3779,6 +4239,16 @@ struct CxxrtlBackend : public Backend {
 				worker.split_intf = true;
 				continue;
 			}
+			if (args[argidx] == "-activity") {
+				worker.activity = true;
+				continue;
+			}
+			if (args[argidx] == "-parallel" && argidx+1 < args.size()) {
+				worker.parallel = std::stoi(args[++argidx]);
+				if (worker.parallel < 1)
+					log_cmd_error("Invalid number of partitions %d.\n", worker.parallel);
+				continue;
+			}
 			if (args[argidx] == "-namespace" && argidx+1 < args.size()) {
 				worker.design_ns = args[++argidx];
 				continue;
@@ -0,0 +1,110 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef CXXRTL_CAPI_FST_H
+#define CXXRTL_CAPI_FST_H
+
+// This file is a part of the CXXRTL C API. It should be used together with `cxxrtl_capi_fst.cc`.
+//
+// The CXXRTL C API for FST writing makes it possible to insert virtual probes into designs and
+// dump waveforms to Fast Signal Trace files. See `cxxrtl/cxxrtl_fst.h` for the libraries that
+// it requires.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <cxxrtl/capi/cxxrtl_capi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Opaque reference to an FST writer.
+typedef struct _cxxrtl_fst *cxxrtl_fst;
+
+// Create an FST writer that writes to the file at `filename`.
+cxxrtl_fst cxxrtl_fst_create(const char *filename);
+
+// Release all resources used by an FST writer, and finish writing the file.
+void cxxrtl_fst_destroy(cxxrtl_fst fst);
+
+// Set FST timescale.
+//
+// The `number` must be 1, 10, or 100, and the `unit` must be one of `"s"`, `"ms"`, `"us"`, `"ns"`,
+// `"ps"`, or `"fs"`.
+//
+// Timescale can only be set before the first call to `cxxrtl_fst_sample`.
+void cxxrtl_fst_timescale(cxxrtl_fst fst, int number, const char *unit);
+
+#ifdef FST_WRITER_PARALLEL
+// Compress and write value change blocks on a separate thread if `enable` is non-zero.
+//
+// Only available if the design and the FST library are built with `-DFST_WRITER_PARALLEL`.
+void cxxrtl_fst_parallel(cxxrtl_fst fst, int enable);
+#endif
+
+// Schedule a specific CXXRTL object to be sampled.
+//
+// The `name` is a full hierarchical name as described for `cxxrtl_get`; it does not need to match
+// the original name of `object`, if any. The `object` must outlive the FST writer, but there are
+// no other requirements; if desired, it can be provided by user code, rather than come from
+// a design.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_fst_sample`.
+void cxxrtl_fst_add(cxxrtl_fst fst, const char *name, struct cxxrtl_object *object);
+
+// Schedule all CXXRTL objects in a simulation.
+//
+// The design `handle` must outlive the FST writer.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_fst_sample`.
+void cxxrtl_fst_add_from(cxxrtl_fst fst, cxxrtl_handle handle);
+
+// Schedule CXXRTL objects in a simulation that match a given predicate.
+//
+// For every object in the simulation, `filter` is called with the provided `data`, the full
+// hierarchical name of the object (see `cxxrtl_get` for details), and the object description.
+// The object will be sampled if the predicate returns a non-zero value.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_fst_sample`.
+void cxxrtl_fst_add_from_if(cxxrtl_fst fst, cxxrtl_handle handle, void *data,
+                            int (*filter)(void *data, const char *name,
+                                          const struct cxxrtl_object *object));
+
+// Schedule all CXXRTL objects in a simulation except for memories.
+//
+// The design `handle` must outlive the FST writer.
+//
+// Objects can only be scheduled before the first call to `cxxrtl_fst_sample`.
+void cxxrtl_fst_add_from_without_memories(cxxrtl_fst fst, cxxrtl_handle handle);
+
+// Sample all scheduled objects.
+//
+// First, `time` is written to the file. Second, the values of every signal changed since
+// the previous call to `cxxrtl_fst_sample` (all values if this is the first call) are written
+// to the file. The FST library buffers value changes, and compresses them in blocks.
+void cxxrtl_fst_sample(cxxrtl_fst fst, uint64_t time);
+
+// Write the value changes buffered by the FST library to the file.
+void cxxrtl_fst_flush(cxxrtl_fst fst);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
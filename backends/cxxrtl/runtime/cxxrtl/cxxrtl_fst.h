@@ -0,0 +1,285 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// This file writes waveforms in the Fast Signal Trace format, using the FST library that is included with Yosys
+// (`libs/fst` in the Yosys source tree, installed as `include/libs/fst` in the Yosys data directory). That directory
+// must be on the include path, and `fstapi.cc`, `fastlz.cc`, and `lz4.cc` from it must be compiled and linked together
+// with the design, as well as zlib (e.g. `-lz`). If all of them are built with `-DFST_WRITER_PARALLEL`,
+// `fst_writer::parallel()` becomes available; this requires the platform's thread library (e.g. `-pthread`).
+
+#ifndef CXXRTL_FST_H
+#define CXXRTL_FST_H
+
+#include <fstapi.h>
+
+#include <cxxrtl/cxxrtl.h>
+
+namespace cxxrtl {
+
+// Unlike `vcd_writer`, which produces text in a buffer, `fst_writer` writes to a file directly. The values are not
+// formatted as text at all (except for the ones wider than 32 bits, which the FST library requires as strings of
+// digits); they are packed into value change blocks that are compressed when the FST library flushes them.
+class fst_writer {
+	struct variable {
+		fstHandle handle;
+		size_t width;
+		chunk_t *curr;
+		size_t cache_offset;
+		debug_outline *outline;
+		bool *outline_warm;
+	};
+
+	void *context;
+	std::vector<std::string> current_scope;
+	std::map<debug_outline*, bool> outlines;
+	std::vector<variable> variables;
+	std::vector<chunk_t> cache;
+	std::map<chunk_t*, fstHandle> aliases;
+	bool streaming = false;
+
+	static_assert(sizeof(chunk_t) == sizeof(uint32_t), "FST value changes are emitted as 32-bit words");
+
+	void emit_scope(const std::vector<std::string> &scope) {
+		assert(!streaming);
+		size_t same_scope_count = 0;
+		while ((same_scope_count < current_scope.size()) &&
+			   (same_scope_count < scope.size()) &&
+			   (current_scope[same_scope_count] == scope[same_scope_count])) {
+			same_scope_count++;
+		}
+		while (current_scope.size() > same_scope_count) {
+			fstWriterSetUpscope(context);
+			current_scope.pop_back();
+		}
+		while (current_scope.size() < scope.size()) {
+			fstWriterSetScope(context, FST_ST_VCD_MODULE, scope[current_scope.size()].c_str(), nullptr);
+			current_scope.push_back(scope[current_scope.size()]);
+		}
+	}
+
+	void emit_var(size_t width, chunk_t *curr, bool constant, debug_outline *outline, enum fstVarType type,
+	              const std::string &name, size_t lsb_at, bool multipart) {
+		assert(!streaming);
+		// Zero-width items have no representation in FST.
+		if (width == 0)
+			return;
+		std::string full_name = name;
+		if (multipart || name.back() == ']' || lsb_at != 0) {
+			if (width == 1)
+				full_name += " [" + std::to_string(lsb_at) + "]";
+			else
+				full_name += " [" + std::to_string(lsb_at + width - 1) + ":" + std::to_string(lsb_at) + "]";
+		}
+		// The FST format has aliases, so an item that shares its storage with another item costs nothing to sample.
+		auto alias_it = aliases.find(curr);
+		if (alias_it != aliases.end()) {
+			fstWriterCreateVar(context, type, FST_VD_IMPLICIT, width, full_name.c_str(), alias_it->second);
+			return;
+		}
+		fstHandle handle = fstWriterCreateVar(context, type, FST_VD_IMPLICIT, width, full_name.c_str(), 0);
+		aliases[curr] = handle;
+		auto outline_it = outlines.emplace(outline, /*warm=*/(outline == nullptr)).first;
+		const size_t chunks = (width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+		if (constant) {
+			variables.emplace_back(variable { handle, width, curr, (size_t)-1, outline_it->first, &outline_it->second });
+		} else {
+			variables.emplace_back(variable { handle, width, curr, cache.size(), outline_it->first, &outline_it->second });
+			cache.insert(cache.end(), &curr[0], &curr[chunks]);
+		}
+	}
+
+	void emit_value(const variable &var) {
+		if (var.width <= 32)
+			fstWriterEmitValueChange32(context, var.handle, var.width, var.curr[0]);
+		else
+			fstWriterEmitValueChangeVec32(context, var.handle, var.width, var.curr);
+	}
+
+	void reset_outlines() {
+		for (auto &outline_it : outlines)
+			outline_it.second = /*warm=*/(outline_it.first == nullptr);
+	}
+
+	bool test_variable(const variable &var) {
+		if (var.cache_offset == (size_t)-1)
+			return false; // constant
+		if (!*var.outline_warm) {
+			var.outline->eval();
+			*var.outline_warm = true;
+		}
+		const size_t chunks = (var.width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+		if (std::equal(&var.curr[0], &var.curr[chunks], &cache[var.cache_offset])) {
+			return false;
+		} else {
+			std::copy(&var.curr[0], &var.curr[chunks], &cache[var.cache_offset]);
+			return true;
+		}
+	}
+
+	static std::vector<std::string> split_hierarchy(const std::string &hier_name) {
+		std::vector<std::string> hierarchy;
+		size_t prev = 0;
+		while (true) {
+			size_t curr = hier_name.find_first_of(' ', prev);
+			if (curr == std::string::npos) {
+				hierarchy.push_back(hier_name.substr(prev));
+				break;
+			} else {
+				hierarchy.push_back(hier_name.substr(prev, curr - prev));
+				prev = curr + 1;
+			}
+		}
+		return hierarchy;
+	}
+
+public:
+	// Creates an FST file. If `compressed_hierarchy` is true, the hierarchy section is compressed as well, which is
+	// worthwhile for large designs. Value change blocks are compressed with LZ4 unless `pack_type()` is used.
+	fst_writer(const std::string &filename, bool compressed_hierarchy = true) {
+		context = fstWriterCreate(filename.c_str(), compressed_hierarchy);
+		assert(context != nullptr);
+		fstWriterSetPackType(context, FST_WR_PT_LZ4);
+	}
+
+	fst_writer(const fst_writer &) = delete;
+	fst_writer &operator=(const fst_writer &) = delete;
+
+	~fst_writer() {
+		fstWriterClose(context);
+	}
+
+	// The `number` must be 1, 10, or 100, and the `unit` must be one of `"s"`, `"ms"`, `"us"`, `"ns"`, `"ps"`, or `"fs"`.
+	void timescale(unsigned number, const std::string &unit) {
+		assert(!streaming);
+		assert(number == 1 || number == 10 || number == 100);
+		assert(unit == "s" || unit == "ms" || unit == "us" ||
+		       unit == "ns" || unit == "ps" || unit == "fs");
+		fstWriterSetTimescaleFromString(context, (std::to_string(number) + unit).c_str());
+	}
+
+	void pack_type(enum fstWriterPackType type) {
+		fstWriterSetPackType(context, type);
+	}
+
+#ifdef FST_WRITER_PARALLEL
+	// Compresses and writes value change blocks on a separate thread.
+	void parallel(bool enable = true) {
+		fstWriterSetParallelMode(context, enable);
+	}
+#endif
+
+	void add(const std::string &hier_name, const debug_item &item, bool multipart = false) {
+		std::vector<std::string> scope = split_hierarchy(hier_name);
+		std::string name = scope.back();
+		scope.pop_back();
+
+		emit_scope(scope);
+		switch (item.type) {
+			// Not the best naming but oh well...
+			case debug_item::VALUE:
+				emit_var(item.width, item.curr, /*constant=*/item.next == nullptr, nullptr,
+				         FST_VT_VCD_WIRE, name, item.lsb_at, multipart);
+				break;
+			case debug_item::WIRE:
+				emit_var(item.width, item.curr, /*constant=*/false, nullptr,
+				         FST_VT_VCD_REG, name, item.lsb_at, multipart);
+				break;
+			case debug_item::MEMORY: {
+				const size_t stride = (item.width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+				for (size_t index = 0; index < item.depth; index++) {
+					chunk_t *nth_curr = &item.curr[stride * index];
+					std::string nth_name = name + '[' + std::to_string(index) + ']';
+					emit_var(item.width, nth_curr, /*constant=*/false, nullptr,
+					         FST_VT_VCD_REG, nth_name, item.lsb_at, multipart);
+				}
+				break;
+			}
+			case debug_item::ALIAS:
+				// See the corresponding comment in `vcd_writer::add()`.
+				emit_var(item.width, item.curr, /*constant=*/false, nullptr,
+				         FST_VT_VCD_WIRE, name, item.lsb_at, multipart);
+				break;
+			case debug_item::OUTLINE:
+				emit_var(item.width, item.curr, /*constant=*/false, item.outline,
+				         FST_VT_VCD_WIRE, name, item.lsb_at, multipart);
+				break;
+		}
+	}
+
+	template<class Filter>
+	void add(const debug_items &items, const Filter &filter) {
+		// `debug_items` is a map, so the items are already sorted in an order optimal for emitting scopes.
+		for (auto &it : items.table)
+			for (auto &part : it.second)
+				if (filter(it.first, part))
+					add(it.first, part, it.second.size() > 1);
+	}
+
+	void add(const debug_items &items) {
+		this->add(items, [](const std::string &, const debug_item &) {
+			return true;
+		});
+	}
+
+	void add_without_memories(const debug_items &items) {
+		this->add(items, [](const std::string &, const debug_item &item) {
+			return item.type != debug_item::MEMORY;
+		});
+	}
+
+	// See `vcd_writer::add_scope()`.
+	template<class Filter>
+	void add_scope(const debug_items &items, const std::string &scope, const Filter &filter) {
+		const std::string prefix = scope.empty() ? scope : scope + ' ';
+		for (auto it = items.table.lower_bound(prefix); it != items.table.end(); ++it) {
+			if (it->first.compare(0, prefix.size(), prefix) != 0)
+				break;
+			for (auto &part : it->second)
+				if (filter(it->first, part))
+					add(it->first, part, it->second.size() > 1);
+		}
+	}
+
+	void add_scope(const debug_items &items, const std::string &scope) {
+		this->add_scope(items, scope, [](const std::string &, const debug_item &) {
+			return true;
+		});
+	}
+
+	void sample(uint64_t timestamp) {
+		bool first_sample = !streaming;
+		if (first_sample) {
+			emit_scope({});
+			streaming = true;
+		}
+		reset_outlines();
+		fstWriterEmitTimeChange(context, timestamp);
+		for (auto &var : variables)
+			if (test_variable(var) || first_sample)
+				emit_value(var);
+	}
+
+	// Writes the value changes buffered by the FST library to the file.
+	void flush() {
+		fstWriterFlushContext(context);
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Copyright (C) 2020  whitequark <whitequark@whitequark.org>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// This file is included by the designs generated with `write_cxxrtl -parallel <N>`. It is not used in any other way.
+// Such designs have to be linked with the platform's thread library (e.g. `-pthread`).
+
+#ifndef CXXRTL_PARALLEL_H
+#define CXXRTL_PARALLEL_H
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace cxxrtl {
+
+// A persistent set of threads that evaluates the partitions of a design. Every call to `run()` executes one task per
+// partition, the first one on the calling thread, and returns once all of them are done; i.e. each delta cycle ends
+// with a barrier. Workers poll for a short while before going to sleep, since delta cycles usually follow each other
+// closely.
+class worker_pool {
+	static constexpr unsigned spin_count = 256;
+
+	std::vector<std::thread> threads;
+	std::mutex mutex;
+	std::condition_variable start_cond, done_cond;
+	std::atomic<size_t> generation { 0 };
+	std::atomic<size_t> pending { 0 };
+	bool stopping = false;
+
+	void *job_data = nullptr;
+	void (*job_func)(void *, size_t) = nullptr;
+
+	void work(size_t index) {
+		size_t seen = 0;
+		while (true) {
+			unsigned spins = 0;
+			while (generation.load(std::memory_order_acquire) == seen && spins++ < spin_count)
+				std::this_thread::yield();
+			if (generation.load(std::memory_order_acquire) == seen) {
+				std::unique_lock<std::mutex> lock(mutex);
+				start_cond.wait(lock, [&] { return stopping || generation.load(std::memory_order_acquire) != seen; });
+				if (stopping)
+					return;
+			}
+			seen = generation.load(std::memory_order_acquire);
+			job_func(job_data, index);
+			if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				std::lock_guard<std::mutex> lock(mutex);
+				done_cond.notify_one();
+			}
+		}
+	}
+
+public:
+	// Creates a pool that runs `partitions` tasks at once, using `partitions - 1` additional threads.
+	explicit worker_pool(size_t partitions) {
+		for (size_t index = 1; index < partitions; index++)
+			threads.emplace_back(&worker_pool::work, this, index);
+	}
+
+	worker_pool(const worker_pool &) = delete;
+	worker_pool &operator=(const worker_pool &) = delete;
+
+	~worker_pool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+		start_cond.notify_all();
+		for (auto &thread : threads)
+			thread.join();
+	}
+
+	size_t size() const {
+		return threads.size() + 1;
+	}
+
+	// Calls `func(index)` for every `index` in `[0, size())`, concurrently.
+	template<class FuncT>
+	void run(FuncT &&func) {
+		if (threads.empty()) {
+			func(0);
+			return;
+		}
+		job_data = static_cast<void *>(&func);
+		job_func = [](void *data, size_t index) { (*static_cast<typename std::remove_reference<FuncT>::type *>(data))(index); };
+		pending.store(threads.size(), std::memory_order_relaxed);
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			generation.fetch_add(1, std::memory_order_release);
+		}
+		start_cond.notify_all();
+		func(0);
+		unsigned spins = 0;
+		while (pending.load(std::memory_order_acquire) != 0 && spins++ < spin_count)
+			std::this_thread::yield();
+		if (pending.load(std::memory_order_acquire) != 0) {
+			std::unique_lock<std::mutex> lock(mutex);
+			done_cond.wait(lock, [&] { return pending.load(std::memory_order_acquire) == 0; });
+		}
+	}
+};
+
+} // namespace cxxrtl
+
+#endif
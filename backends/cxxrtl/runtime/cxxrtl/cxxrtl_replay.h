@@ -31,6 +31,12 @@
 #include <cstdio>
 #include <atomic>
 #include <unordered_map>
+#ifdef CXXRTL_REPLAY_BACKGROUND
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#endif
 
 #include <cxxrtl/cxxrtl.h>
 #include <cxxrtl/cxxrtl_time.h>
@@ -61,6 +67,21 @@
 // <packet-assume>  ::= 0xc0000013 <message> <source-location>
 // <packet-end>     ::= 0xFFFFFFFF
 //
+// A compressed replay log has the same contents, split into frames at sample boundaries:
+//
+// <compressed-file> ::= <file-header-compressed> <frame>+
+// <file-header-compressed> ::= 0x52585843 0x04014c54
+// <frame>           ::= 0xc0000020 <flags> <word-count> <byte-count> <pointer> <time> <frame-data>
+// <frame-data>      ::= 0x????????*
+//
+// The frame data are the <word-count> words of the log (starting with <definitions> in the first frame), either stored
+// as-is or compressed in the LZ4 block format to <byte-count> bytes, and padded to a word boundary. Within a frame,
+// the chunks of a <packet-change> (but not of a memory row) are stored as a difference (XOR) from the previous value
+// of the same debug item in that frame; every frame can therefore be decoded independently. A frame that begins with
+// a sample has its pointer and time in the header, and a frame that begins with a complete sample is a _checkpoint_.
+// The recorder makes the sample that begins a frame a complete one (except for the samples with diagnostics), so
+// the frame headers form an index of checkpoints that can be read without decompressing any of the data.
+//
 // The replay log contains sample data, however, it does not cover the entire design. Rather, it only contains sample
 // data for the subset of debug items containing _design state_: inputs and registers/latches. This keeps its size to
 // a minimum, and recording speed to a maximum. The player samples any missing data by setting the design state items
@@ -101,6 +122,7 @@
 // During rewinding, the player begins reading at the latest non-incremental sample that still lies before the requested
 // sample time. It continues reading incremental samples after that point until it reaches the requested sample time.
 // This process is very cheap as the design is not evaluated; it is essentially a (convoluted) memory copy operation.
+// In a compressed log, the latest checkpoint before the requested sample is used even if it was never read before.
 //
 // During replaying, the player evaluates the design at the current time, which causes all debug items to assume
 // the values they had before recording. This process is expensive. Once done, the player advances to the next state
@@ -155,6 +177,7 @@ public:
 	typedef uint32_t ident_t;
 
 	static constexpr uint16_t VERSION = 0x0400;
+	static constexpr uint16_t VERSION_COMPRESSED = 0x0401;
 
 	static constexpr uint64_t HEADER_MAGIC = 0x00004c5452585843;
 	static constexpr uint64_t VERSION_MASK = 0xffff000000000000;
@@ -180,18 +203,313 @@ public:
 
 	static constexpr uint32_t PACKET_END     = 0xffffffff;
 
+	static constexpr uint32_t FRAME_HEADER   = 0xc0000020;
+	enum frame_flag : uint32_t {
+		FRAME_SAMPLE     = 1, // the frame begins with a sample packet, whose pointer and timestamp are in the header
+		FRAME_CHECKPOINT = 2, // ... and that sample is a complete one
+		FRAME_PACKED     = 4, // the frame data is compressed
+	};
+
+	static constexpr size_t FRAME_HEADER_WORDS = 8;
+	static constexpr size_t MAXIMUM_FRAME_WORDS = 0x0fffffff;
+
+	// Options for writing spools.
+	enum writer_flag : unsigned {
+		// Split the log into frames that are delta encoded and compressed independently of each other.
+		COMPRESSED = 1,
+#ifdef CXXRTL_REPLAY_BACKGROUND
+		// Hand over the buffered log data to a thread that compresses and writes it. Only available if
+		// `CXXRTL_REPLAY_BACKGROUND` is defined; designs using it have to be linked with the platform's thread library
+		// (e.g. `-pthread`).
+		BACKGROUND = 2,
+#endif
+	};
+
+	static constexpr size_t DEFAULT_FRAME_WORDS = 1024 * 1024;
+
+private:
+	struct frame_header {
+		uint32_t flags = 0;
+		uint32_t words = 0;
+		uint32_t bytes = 0;
+		pointer_t pointer = 0;
+		time timestamp;
+	};
+
+	// The frame compressor produces LZ4 block format sequences, but only looks for matches at word boundaries and
+	// extends them by whole words, which is several times faster than a byte-wise search and loses little, since
+	// the log consists entirely of words. Together with the delta encoding of values this turns the long runs of
+	// unchanged chunks into long matches.
+	static constexpr unsigned PACK_HASH_BITS = 16;
+	static constexpr size_t PACK_MAXIMUM_OFFSET = 0xffff / sizeof(uint32_t);
+
+	static void pack_length(std::vector<uint8_t> &packed, size_t length) {
+		for (; length >= 255; length -= 255)
+			packed.push_back(255);
+		packed.push_back(length);
+	}
+
+	static void pack_sequence(std::vector<uint8_t> &packed, const uint32_t *literals, size_t literal_words,
+	                          size_t offset_words, size_t match_words) {
+		size_t literal_length = literal_words * sizeof(uint32_t);
+		size_t token = packed.size();
+		packed.push_back((literal_length < 15 ? literal_length : 15) << 4);
+		if (literal_length >= 15)
+			pack_length(packed, literal_length - 15);
+		const uint8_t *literal_bytes = reinterpret_cast<const uint8_t *>(literals);
+		packed.insert(packed.end(), literal_bytes, literal_bytes + literal_length);
+		if (match_words == 0)
+			return; // last sequence
+		size_t offset = offset_words * sizeof(uint32_t);
+		packed.push_back(offset >> 0);
+		packed.push_back(offset >> 8);
+		size_t match_length = match_words * sizeof(uint32_t) - 4;
+		packed[token] |= (match_length < 15 ? match_length : 15);
+		if (match_length >= 15)
+			pack_length(packed, match_length - 15);
+	}
+
+	static void pack(const uint32_t *words, size_t count, std::vector<uint8_t> &packed, std::vector<uint32_t> &table) {
+		table.assign(1 << PACK_HASH_BITS, 0);
+		packed.clear();
+		size_t anchor = 0;
+		// As required by the LZ4 block format, the last match must start at least 12 bytes before the end of the block,
+		// and the last 5 bytes must be literals.
+		for (size_t index = 0; index + 3 < count;) {
+			uint32_t hash = (words[index] * 2654435761u) >> (32 - PACK_HASH_BITS);
+			size_t candidate = table[hash];
+			table[hash] = index + 1;
+			if (candidate == 0 || index - (candidate - 1) > PACK_MAXIMUM_OFFSET || words[candidate - 1] != words[index]) {
+				index++;
+				continue;
+			}
+			candidate--;
+			size_t length = 1;
+			while (index + length + 2 < count && words[candidate + length] == words[index + length])
+				length++;
+			pack_sequence(packed, &words[anchor], index - anchor, index - candidate, length);
+			index += length;
+			anchor = index;
+		}
+		pack_sequence(packed, &words[anchor], count - anchor, 0, 0);
+	}
+
+	static bool unpack_length(const uint8_t *packed, size_t size, size_t &offset, size_t &length) {
+		uint8_t byte;
+		do {
+			if (offset == size)
+				return false;
+			byte = packed[offset++];
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	static bool unpack(const uint8_t *packed, size_t size, uint8_t *data, size_t data_size) {
+		size_t in = 0, out = 0;
+		while (in < size) {
+			uint8_t token = packed[in++];
+			size_t literal_length = token >> 4;
+			if (literal_length == 15 && !unpack_length(packed, size, in, literal_length))
+				return false;
+			if (literal_length > size - in || literal_length > data_size - out)
+				return false;
+			memcpy(&data[out], &packed[in], literal_length);
+			in += literal_length;
+			out += literal_length;
+			if (in == size)
+				break; // last sequence
+			if (size - in < 2)
+				return false;
+			size_t offset = packed[in] | (packed[in + 1] << 8);
+			in += 2;
+			if (offset == 0 || offset > out)
+				return false;
+			size_t match_length = token & 15;
+			if (match_length == 15 && !unpack_length(packed, size, in, match_length))
+				return false;
+			match_length += 4;
+			if (match_length > data_size - out)
+				return false;
+			// Matches may overlap the data they produce; copy in steps no longer than the distance to the source.
+			size_t source = out - offset;
+			while (match_length > 0) {
+				size_t step = out - source < match_length ? out - source : match_length;
+				memcpy(&data[out], &data[source], step);
+				out += step;
+				match_length -= step;
+			}
+		}
+		return out == data_size;
+	}
+
+public:
 	// Writing spools.
 
 	class writer {
+		struct block {
+			std::vector<uint32_t> words;
+			size_t size;
+			bool framed;
+			frame_header header;
+		};
+
+		struct scratch {
+			std::vector<uint32_t> table;
+			std::vector<uint8_t> packed;
+		};
+
+#ifdef CXXRTL_REPLAY_BACKGROUND
+		// The background thread receives filled buffers through a short queue, and returns them for reuse once they are
+		// written. The queue is bounded so that a simulation that produces data faster than it can be compressed
+		// eventually waits instead of exhausting memory.
+		struct background {
+			static constexpr size_t MAXIMUM_QUEUED = 4;
+
+			std::mutex mutex;
+			std::condition_variable cond;
+			std::deque<block> queue;
+			std::vector<std::vector<uint32_t>> spare;
+			bool busy = false;
+			bool stopping = false;
+			std::thread thread;
+
+			void run(int fd) {
+				scratch buffers;
+				std::unique_lock<std::mutex> lock(mutex);
+				while (true) {
+					cond.wait(lock, [&] { return stopping || !queue.empty(); });
+					if (queue.empty())
+						return;
+					block item = std::move(queue.front());
+					queue.pop_front();
+					busy = true;
+					lock.unlock();
+					output(fd, item, buffers);
+					lock.lock();
+					busy = false;
+					spare.push_back(std::move(item.words));
+					cond.notify_all();
+				}
+			}
+
+			void push(block &&item, std::vector<uint32_t> &buffer) {
+				std::unique_lock<std::mutex> lock(mutex);
+				cond.wait(lock, [&] { return queue.size() < MAXIMUM_QUEUED; });
+				queue.push_back(std::move(item));
+				if (!spare.empty()) {
+					buffer = std::move(spare.back());
+					spare.pop_back();
+				}
+				cond.notify_all();
+			}
+
+			void drain() {
+				std::unique_lock<std::mutex> lock(mutex);
+				cond.wait(lock, [&] { return queue.empty() && !busy; });
+			}
+
+			void stop() {
+				{
+					std::lock_guard<std::mutex> lock(mutex);
+					stopping = true;
+				}
+				cond.notify_all();
+				thread.join();
+			}
+		};
+#endif
+
 		int fd;
+		unsigned flags;
+		size_t frame_words;
 		size_t position;
 		std::vector<uint32_t> buffer;
+		frame_header frame;
+		std::vector<std::vector<chunk_t>> delta;
+		std::vector<ident_t> delta_idents;
+		scratch foreground;
+#ifdef CXXRTL_REPLAY_BACKGROUND
+		std::unique_ptr<background> worker;
+#endif
+
+		static void output(int fd, const block &block, scratch &scratch) {
+			const void *data = block.words.data();
+			size_t data_size = block.size * sizeof(uint32_t);
+			if (block.framed) {
+				assert(block.size <= MAXIMUM_FRAME_WORDS);
+				uint32_t header[FRAME_HEADER_WORDS] = { FRAME_HEADER, block.header.flags, (uint32_t)block.size };
+				pack(block.words.data(), block.size, scratch.packed, scratch.table);
+				if (scratch.packed.size() < data_size) {
+					header[1] |= FRAME_PACKED;
+					header[3] = scratch.packed.size();
+					scratch.packed.resize((scratch.packed.size() + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1));
+				} else {
+					header[3] = data_size;
+					scratch.packed.resize(data_size);
+					memcpy(scratch.packed.data(), block.words.data(), data_size);
+				}
+				const value<time::bits> &raw_timestamp(block.header.timestamp);
+				header[4] = block.header.pointer;
+				header[5] = raw_timestamp.data[0];
+				header[6] = raw_timestamp.data[1];
+				header[7] = raw_timestamp.data[2];
+				scratch.packed.insert(scratch.packed.begin(), reinterpret_cast<const uint8_t *>(header),
+				                      reinterpret_cast<const uint8_t *>(header) + sizeof(header));
+				data = scratch.packed.data();
+				data_size = scratch.packed.size();
+			}
+			size_t data_written = write(fd, data, data_size);
+			assert(data_size == data_written);
+		}
+
+		// Hands over the buffered data, either to be written immediately, or to the background thread.
+		void submit(bool framed) {
+			block item { std::move(buffer), position, framed, frame };
+			buffer.clear();
+#ifdef CXXRTL_REPLAY_BACKGROUND
+			if (worker) {
+				worker->push(std::move(item), buffer);
+			} else
+#endif
+			{
+				output(fd, item, foreground);
+				buffer = std::move(item.words);
+			}
+			if (buffer.size() < frame_words)
+				buffer.resize(frame_words);
+			position = 0;
+			frame = frame_header();
+			for (ident_t ident : delta_idents)
+				delta[ident].clear();
+			delta_idents.clear();
+		}
+
+		// Frames of a compressed log only end at sample boundaries, so the buffer grows to fit the current sample.
+		void overflow() {
+			if (flags & COMPRESSED)
+				buffer.resize(buffer.size() * 2);
+			else
+				submit(/*framed=*/false);
+		}
+
+		// Values in a compressed log are stored as a difference from the previous value of the same debug item in
+		// the same frame, which turns unchanged chunks into zeroes.
+		chunk_t *delta_base(ident_t ident, size_t chunks) {
+			if (ident >= delta.size())
+				delta.resize(ident + 1);
+			if (delta[ident].empty()) {
+				delta[ident].resize(chunks);
+				delta_idents.push_back(ident);
+			}
+			return delta[ident].data();
+		}
 
 		// These functions aren't overloaded because of implicit numeric conversions.
 
 		void emit_word(uint32_t word) {
-			if (position + 1 == buffer.size())
-				flush();
+			if (position == buffer.size())
+				overflow();
 			buffer[position++] = word;
 		}
 
@@ -234,22 +552,43 @@ public:
 		}
 
 	public:
-		// Creates a writer, and transfers ownership of `fd`, which must be open for appending.
+		// Creates a writer, and transfers ownership of `fd`, which must be open for appending. The `flags` are
+		// a combination of `writer_flag` values.
 		//
-		// The buffer size is currently fixed to a "reasonably large" size, determined empirically by measuring writer
-		// performance on a representative design; large but not so large it would e.g. cause address space exhaustion
-		// on 32-bit platforms.
-		writer(spool &spool) : fd(spool.take_write()), position(0), buffer(32 * 1024 * 1024) {
+		// The buffer size of an uncompressed log written on the calling thread is currently fixed to a "reasonably
+		// large" size, determined empirically by measuring writer performance on a representative design; large but
+		// not so large it would e.g. cause address space exhaustion on 32-bit platforms. Otherwise, the buffer holds
+		// one frame of (approximately) `frame_words` words, which is also the distance between checkpoints.
+		writer(spool &spool, unsigned flags = 0, size_t frame_words = DEFAULT_FRAME_WORDS)
+		: fd(spool.take_write()), flags(flags), frame_words(frame_words), position(0) {
 			assert(fd != -1);
+			assert(frame_words > 0 && frame_words <= MAXIMUM_FRAME_WORDS / 2);
+			unsigned framed_flags = COMPRESSED;
+#ifdef CXXRTL_REPLAY_BACKGROUND
+			framed_flags |= BACKGROUND;
+#endif
+			buffer.resize((flags & framed_flags) ? frame_words : 32 * 1024 * 1024);
 #if !defined(WIN32)
 			int result = ftruncate(fd, 0);
 #else
 			int result = _chsize_s(fd, 0);
 #endif
 			assert(result == 0);
+#ifdef CXXRTL_REPLAY_BACKGROUND
+			if (flags & BACKGROUND) {
+				worker.reset(new background);
+				worker->thread = std::thread(&background::run, worker.get(), fd);
+			}
+#endif
 		}
 
-		writer(writer &&moved) : fd(moved.fd), position(moved.position), buffer(moved.buffer) {
+		writer(writer &&moved)
+		: fd(moved.fd), flags(moved.flags), frame_words(moved.frame_words), position(moved.position),
+		  buffer(std::move(moved.buffer)), frame(moved.frame), delta(std::move(moved.delta)),
+		  delta_idents(std::move(moved.delta_idents)) {
+#ifdef CXXRTL_REPLAY_BACKGROUND
+			worker = std::move(moved.worker);
+#endif
 			moved.fd = -1;
 			moved.position = 0;
 		}
@@ -258,26 +597,45 @@ public:
 		writer &operator=(const writer &) = delete;
 
 		// Both write() calls and fwrite() calls are too expensive to perform implicitly. The API consumer must determine
-		// the optimal time to flush the writer and do that explicitly for best performance.
+		// the optimal time to flush the writer and do that explicitly for best performance. Once this function returns,
+		// all of the data written so far is in the file, even if it is written by the background thread.
 		void flush() {
 			assert(fd != -1);
-			size_t data_size = position * sizeof(uint32_t);
-			size_t data_written = write(fd, buffer.data(), data_size);
-			assert(data_size == data_written);
-			position = 0;
+			if (position > 0)
+				submit(/*framed=*/flags & COMPRESSED);
+#ifdef CXXRTL_REPLAY_BACKGROUND
+			if (worker)
+				worker->drain();
+#endif
 		}
 
 		~writer() {
 			if (fd != -1) {
 				flush();
+#ifdef CXXRTL_REPLAY_BACKGROUND
+				if (worker)
+					worker->stop();
+#endif
 				close(fd);
 			}
 		}
 
+		// Returns `true` if the next sample would begin a new frame, and should therefore be a complete sample to make
+		// that frame a checkpoint.
+		bool checkpoint_due() const {
+			return (flags & COMPRESSED) && position >= frame_words;
+		}
+
 		void write_magic() {
 			// `CXXRTL` followed by version in binary. This header will read backwards on big-endian machines, which allows
 			// detection of this case, both visually and programmatically.
-			emit_dword(((uint64_t)VERSION << 48) | HEADER_MAGIC);
+			if (flags & COMPRESSED) {
+				assert(position == 0);
+				emit_dword(((uint64_t)VERSION_COMPRESSED << 48) | HEADER_MAGIC);
+				submit(/*framed=*/false);
+			} else {
+				emit_dword(((uint64_t)VERSION << 48) | HEADER_MAGIC);
+			}
 		}
 
 		void write_define(ident_t ident, const std::string &name, size_t part_index, size_t chunks, size_t depth) {
@@ -290,6 +648,18 @@ public:
 		}
 
 		void write_sample(bool incremental, pointer_t pointer, const time &timestamp) {
+			if (flags & COMPRESSED) {
+				// Every complete sample begins a frame, which makes it a checkpoint; other samples begin a frame only
+				// once the current one is large enough.
+				if (position > 0 && (!incremental || position >= frame_words))
+					submit(/*framed=*/true);
+				if (position == 0) {
+					frame.flags = FRAME_SAMPLE | (incremental ? 0 : FRAME_CHECKPOINT);
+					frame.pointer = pointer;
+					frame.timestamp = timestamp;
+				}
+			}
+
 			uint32_t flags = (incremental ? sample_flag::INCREMENTAL : 0);
 			emit_word(PACKET_SAMPLE);
 			emit_word(flags);
@@ -300,6 +670,7 @@ public:
 		void write_change(ident_t ident, size_t chunks, const chunk_t *data) {
 			assert(ident <= MAXIMUM_IDENT);
 
+			chunk_t *base = (flags & COMPRESSED) ? delta_base(ident, chunks) : nullptr;
 			if (chunks == 1 && *data == 0) {
 				emit_word(PACKET_CHANGEL | ident);
 			} else if (chunks == 1 && *data == 1) {
@@ -307,8 +678,10 @@ public:
 			} else {
 				emit_word(PACKET_CHANGE | ident);
 				for (size_t offset = 0; offset < chunks; offset++)
-					emit_word(data[offset]);
+					emit_word(base ? data[offset] ^ base[offset] : data[offset]);
 			}
+			if (base)
+				std::copy(data, data + chunks, base);
 		}
 
 		void write_change(ident_t ident, size_t chunks, const chunk_t *data, size_t index) {
@@ -334,9 +707,126 @@ public:
 	// Reading spools.
 
 	class reader {
+		// Positions within a compressed log consist of the offset of a frame in words, and of an index within it.
+		static constexpr unsigned INDEX_BITS = 28;
+
+		struct checkpoint {
+			uint64_t offset;
+			pointer_t pointer;
+			time timestamp;
+		};
+
 		FILE *f;
+		bool compressed = false;
+
+		// The frame of a compressed log that is being read.
+		std::vector<uint32_t> frame;
+		size_t frame_index = 0;
+		uint64_t frame_offset = 0;
+		uint64_t next_offset = 0;
+		std::vector<uint8_t> packed;
+		std::vector<std::vector<chunk_t>> delta;
+		std::vector<ident_t> delta_idents;
+
+		// The frame headers of a compressed log are read ahead of the frames themselves (without decompressing any of
+		// the data) when looking for a checkpoint.
+		std::vector<checkpoint> checkpoints;
+		uint64_t index_offset = 0;
+		bool indexed_sample = false;
+		pointer_t indexed_pointer = 0;
+		time indexed_timestamp;
+
+		bool read_frame_header(uint64_t offset, frame_header &header) {
+			uint32_t words[FRAME_HEADER_WORDS];
+			fseek(f, offset, SEEK_SET);
+			// The frame may not have been completely written yet if the log is being recorded at the same time.
+			if (fread(words, sizeof(words), 1, f) != 1) {
+				clearerr(f);
+				return false;
+			}
+			assert(words[0] == FRAME_HEADER);
+			header.flags = words[1];
+			header.words = words[2];
+			header.bytes = words[3];
+			header.pointer = words[4];
+			value<time::bits> raw_timestamp;
+			raw_timestamp.data[0] = words[5];
+			raw_timestamp.data[1] = words[6];
+			raw_timestamp.data[2] = words[7];
+			header.timestamp = time(raw_timestamp);
+			return true;
+		}
+
+		static uint64_t frame_size(const frame_header &header) {
+			return FRAME_HEADER_WORDS * sizeof(uint32_t) + ((header.bytes + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1));
+		}
+
+		bool load_frame(uint64_t offset) {
+			frame_header header;
+			if (!read_frame_header(offset, header))
+				return false;
+			packed.resize(frame_size(header) - FRAME_HEADER_WORDS * sizeof(uint32_t));
+			if (fread(packed.data(), 1, packed.size(), f) != packed.size()) {
+				clearerr(f);
+				return false;
+			}
+			assert(header.words <= MAXIMUM_FRAME_WORDS);
+			frame.resize(header.words);
+			if (header.flags & FRAME_PACKED) {
+				bool valid = unpack(packed.data(), header.bytes, reinterpret_cast<uint8_t *>(frame.data()),
+				                    frame.size() * sizeof(uint32_t));
+				assert(valid && "Corrupted frame");
+				(void)valid;
+			} else {
+				assert(header.bytes == frame.size() * sizeof(uint32_t));
+				memcpy(frame.data(), packed.data(), header.bytes);
+			}
+			frame_offset = offset;
+			frame_index = 0;
+			next_offset = offset + frame_size(header);
+			reset_delta();
+			return true;
+		}
+
+		bool index_frame() {
+			frame_header header;
+			if (!read_frame_header(index_offset, header))
+				return false;
+			if (header.flags & FRAME_CHECKPOINT)
+				checkpoints.push_back({index_offset, header.pointer, header.timestamp});
+			if (header.flags & FRAME_SAMPLE) {
+				indexed_sample = true;
+				indexed_pointer = header.pointer;
+				indexed_timestamp = header.timestamp;
+			}
+			index_offset += frame_size(header);
+			return true;
+		}
+
+		void reset_delta() {
+			for (ident_t ident : delta_idents)
+				delta[ident].clear();
+			delta_idents.clear();
+		}
+
+		chunk_t *delta_base(ident_t ident, size_t chunks) {
+			if (ident >= delta.size())
+				delta.resize(ident + 1);
+			if (delta[ident].empty()) {
+				delta[ident].resize(chunks);
+				delta_idents.push_back(ident);
+			}
+			return delta[ident].data();
+		}
 
 		uint32_t absorb_word() {
+			if (compressed) {
+				while (frame_index == frame.size())
+					if (!load_frame(next_offset))
+						return PACKET_END;
+				return frame[frame_index++];
+			}
+
 			// If we're at end of file, `fread` will not write to `word`, and `PACKET_END` will be returned.
 			uint32_t word = PACKET_END;
 			fread(&word, sizeof(word), 1, f);
@@ -391,7 +881,12 @@ public:
 			assert(f != nullptr);
 		}
 
-		reader(reader &&moved) : f(moved.f) {
+		reader(reader &&moved)
+		: f(moved.f), compressed(moved.compressed), frame(std::move(moved.frame)), frame_index(moved.frame_index),
+		  frame_offset(moved.frame_offset), next_offset(moved.next_offset), delta(std::move(moved.delta)),
+		  delta_idents(std::move(moved.delta_idents)), checkpoints(std::move(moved.checkpoints)),
+		  index_offset(moved.index_offset), indexed_sample(moved.indexed_sample),
+		  indexed_pointer(moved.indexed_pointer), indexed_timestamp(moved.indexed_timestamp) {
 			moved.f = nullptr;
 		}
 
@@ -404,17 +899,82 @@ public:
 		}
 
 		pos_t position() {
+			if (compressed) {
+				if (frame_index == frame.size())
+					return (next_offset / sizeof(uint32_t)) << INDEX_BITS;
+				return ((frame_offset / sizeof(uint32_t)) << INDEX_BITS) | frame_index;
+			}
 			return ftell(f);
 		}
 
+		// In a compressed log, it is only possible to rewind to the beginning of a frame (where every complete sample
+		// is), or within the frame that is being read to a position that was obtained before reading any changes.
 		void rewind(pos_t position) {
+			if (compressed) {
+				uint64_t offset = (position >> INDEX_BITS) * sizeof(uint32_t);
+				size_t index = position & ((1 << INDEX_BITS) - 1);
+				if (!frame.empty() && offset == frame_offset) {
+					assert(index <= frame.size());
+					if (index == 0)
+						reset_delta();
+					frame_index = index;
+				} else {
+					assert(index == 0 && "Cannot rewind into the middle of a frame");
+					frame.clear();
+					frame_index = 0;
+					next_offset = offset;
+				}
+				return;
+			}
 			fseek(f, position, SEEK_SET);
 		}
 
+		// Looks up the last checkpoint with a pointer less than or equal to `at_pointer`. Returns `false` if there is no
+		// such checkpoint, or if the log is not compressed (and has no checkpoints).
+		bool find_checkpoint(pointer_t at_pointer, pointer_t &pointer, pos_t &position) {
+			if (!compressed)
+				return false;
+			while (!(indexed_sample && indexed_pointer > at_pointer) && index_frame())
+				continue;
+			auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), at_pointer,
+				[](pointer_t pointer, const checkpoint &checkpoint) { return pointer < checkpoint.pointer; });
+			if (it == checkpoints.begin())
+				return false;
+			--it;
+			pointer = it->pointer;
+			position = (it->offset / sizeof(uint32_t)) << INDEX_BITS;
+			return true;
+		}
+
+		// Looks up the last checkpoint with a timestamp less than `at_timestamp`, or, failing that, the first one with
+		// a timestamp equal to it (since there may be earlier samples with the same timestamp in the previous frame).
+		// Returns `false` if there is no such checkpoint, or if the log is not compressed (and has no checkpoints).
+		bool find_checkpoint(const time &at_timestamp, time &timestamp, pos_t &position) {
+			if (!compressed)
+				return false;
+			while (!(indexed_sample && indexed_timestamp > at_timestamp) && index_frame())
+				continue;
+			auto it = std::lower_bound(checkpoints.begin(), checkpoints.end(), at_timestamp,
+				[](const checkpoint &checkpoint, const time &timestamp) { return checkpoint.timestamp < timestamp; });
+			if (it == checkpoints.begin()) {
+				if (it == checkpoints.end() || it->timestamp != at_timestamp)
+					return false;
+			} else {
+				--it;
+			}
+			timestamp = it->timestamp;
+			position = (it->offset / sizeof(uint32_t)) << INDEX_BITS;
+			return true;
+		}
+
 		void read_magic() {
 			uint64_t magic = absorb_dword();
 			assert((magic & ~VERSION_MASK) == HEADER_MAGIC);
-			assert((magic >> 48) == VERSION);
+			assert((magic >> 48) == VERSION || (magic >> 48) == VERSION_COMPRESSED);
+			if ((magic >> 48) == VERSION_COMPRESSED) {
+				compressed = true;
+				next_offset = index_offset = ftell(f);
+			}
 		}
 
 		bool read_define(ident_t &ident, std::string &name, size_t &part_index, size_t &chunks, size_t &depth) {
@@ -458,14 +1018,26 @@ public:
 
 		void read_change_data(uint32_t header, size_t chunks, size_t depth, chunk_t *data) {
 			uint32_t index = 0;
+			chunk_t *base = nullptr;
+			if (compressed && (header & CHANGE_MASK) != PACKET_CHANGEI)
+				base = delta_base(header & MAXIMUM_IDENT, chunks);
 			switch (header & CHANGE_MASK) {
 				case PACKET_CHANGEL:
 					*data = 0;
+					if (base)
+						*base = 0;
 					return;
 				case PACKET_CHANGEH:
 					*data = 1;
+					if (base)
+						*base = 1;
 					return;
 				case PACKET_CHANGE:
+					if (base) {
+						for (size_t offset = 0; offset < chunks; offset++)
+							data[offset] = (base[offset] ^= absorb_word());
+						return;
+					}
 					break;
 				case PACKET_CHANGEI:
 					index = absorb_word();
@@ -550,6 +1122,17 @@ class recorder {
 	spool::pointer_t pointer = 0;
 	time timestamp;
 
+	void write_variables() {
+		for (auto var : variables) {
+			assert(var.ident != 0);
+			if (!var.memory)
+				writer.write_change(var.ident, var.chunks, var.curr);
+			else
+				for (size_t index = 0; index < var.depth; index++)
+					writer.write_change(var.ident, var.chunks, &var.curr[var.chunks * index], index);
+		}
+	}
+
 public:
 	template<typename ...Args>
 	recorder(Args &&...args) : writer(std::forward<Args>(args)...) {}
@@ -603,14 +1186,7 @@ public:
 		assert(streaming);
 
 		writer.write_sample(/*incremental=*/false, pointer++, timestamp);
-		for (auto var : variables) {
-			assert(var.ident != 0);
-			if (!var.memory)
-				writer.write_change(var.ident, var.chunks, var.curr);
-			else
-				for (size_t index = 0; index < var.depth; index++)
-					writer.write_change(var.ident, var.chunks, &var.curr[var.chunks * index], index);
-		}
+		write_variables();
 		writer.write_end();
 	}
 
@@ -636,11 +1212,18 @@ public:
 		record_observer.ident_lookup = &ident_lookup;
 		record_observer.writer = &writer;
 
-		writer.write_sample(/*incremental=*/true, pointer++, timestamp);
-		for (auto input_index : inputs) {
-			variable &var = variables.at(input_index);
-			assert(!var.memory);
-			writer.write_change(var.ident, var.chunks, var.curr);
+		// When a compressed spool is about to begin a new frame, the sample is made complete by recording the entire
+		// design state before the changes, which makes that frame a checkpoint the player can seek to.
+		bool checkpoint = writer.checkpoint_due();
+		writer.write_sample(/*incremental=*/!checkpoint, pointer++, timestamp);
+		if (checkpoint) {
+			write_variables();
+		} else {
+			for (auto input_index : inputs) {
+				variable &var = variables.at(input_index);
+				assert(!var.memory);
+				writer.write_change(var.ident, var.chunks, var.curr);
+			}
 		}
 		bool changed = module.commit(record_observer);
 		writer.write_end();
@@ -780,7 +1363,15 @@ public:
 		// function used here is `std::greater`, inverting the direction of `lower_bound`.
 		auto position_it = index_by_pointer.lower_bound(at_pointer);
 		assert(position_it != index_by_pointer.end());
-		reader.rewind(position_it->second);
+		spool::reader::pos_t position = position_it->second;
+
+		// A compressed spool has checkpoints that may be closer to `at_pointer` than any sample that was read so far.
+		spool::pointer_t checkpoint_pointer;
+		spool::reader::pos_t checkpoint_position;
+		if (reader.find_checkpoint(at_pointer, checkpoint_pointer, checkpoint_position) &&
+				checkpoint_pointer > position_it->first)
+			position = checkpoint_position;
+		reader.rewind(position);
 
 		// Replay samples until eventually arriving to `at_pointer` or encountering end of file.
 		while(replay(diagnostics)) {
@@ -810,7 +1401,17 @@ public:
 		// the comparison function used here is `std::greater`, inverting the direction of `lower_bound`.
 		auto position_it = index_by_timestamp.lower_bound(at_or_before_timestamp);
 		assert(position_it != index_by_timestamp.end());
-		reader.rewind(position_it->second);
+		spool::reader::pos_t position = position_it->second;
+
+		// Same as in `rewind_to()`. Since the player may have jumped over some of the samples with a given timestamp,
+		// a complete sample it has read with exactly `at_or_before_timestamp` is not necessarily the first one, but
+		// the checkpoint is.
+		time checkpoint_timestamp;
+		spool::reader::pos_t checkpoint_position;
+		if (reader.find_checkpoint(at_or_before_timestamp, checkpoint_timestamp, checkpoint_position) &&
+				(checkpoint_timestamp > position_it->first || position_it->first == at_or_before_timestamp))
+			position = checkpoint_position;
+		reader.rewind(position);
 
 		// Replay samples until eventually arriving to or past `at_or_before_timestamp` or encountering end of file.
 		while (replay(diagnostics)) {
@@ -843,13 +1444,14 @@ public:
 		// The very first sample that is read must be a complete sample. This is required for the rewind functions to work.
 		assert(initialized || !incremental);
 
-		// It is possible (though not very useful) to have several complete samples with the same timestamp in a row.
-		// Ensure that we associate the timestamp with the position of the first such complete sample. (This condition
-		// works because the player never jumps over a sample.)
+		// It is possible (though not very useful) to have several complete samples with the same timestamp in a row,
+		// and checkpoints of a compressed spool may also fall into a run of delta cycles. Ensure that we associate
+		// the timestamp with the position of the first such complete sample that was read. (Checkpoints that the player
+		// jumps to are found by `find_checkpoint()`, which takes care of the samples it skips.)
 		if (!incremental && !index_by_pointer.count(pointer)) {
-			assert(!index_by_timestamp.count(timestamp));
 			index_by_pointer[pointer] = position;
-			index_by_timestamp[timestamp] = position;
+			if (!index_by_timestamp.count(timestamp))
+				index_by_timestamp[timestamp] = position;
 		}
 
 		uint32_t header;
@@ -19,6 +19,13 @@
 #ifndef CXXRTL_VCD_H
 #define CXXRTL_VCD_H
 
+#ifdef CXXRTL_VCD_BACKGROUND
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#endif
+
 #include <cxxrtl/cxxrtl.h>
 
 namespace cxxrtl {
@@ -66,13 +73,17 @@ class vcd_writer {
 		}
 	}
 
-	void emit_ident(size_t ident) {
+	static void format_ident(std::string &out, size_t ident) {
 		do {
-			buffer += '!' + ident % 94; // "base94"
+			out += '!' + ident % 94; // "base94"
 			ident /= 94;
 		} while (ident != 0);
 	}
 
+	void emit_ident(size_t ident) {
+		format_ident(buffer, ident);
+	}
+
 	void emit_name(const std::string &name) {
 		for (char c : name) {
 			if (c == ':') {
@@ -107,33 +118,152 @@ class vcd_writer {
 		streaming = true;
 	}
 
+	static void format_time(std::string &out, uint64_t timestamp) {
+		out += "#" + std::to_string(timestamp) + "\n";
+	}
+
+	static void format_scalar(std::string &out, const variable &var, const chunk_t *data) {
+		assert(var.width == 1);
+		out += (*data ? '1' : '0');
+		format_ident(out, var.ident);
+		out += '\n';
+	}
+
+	static void format_vector(std::string &out, const variable &var, const chunk_t *data) {
+		out += 'b';
+		for (size_t bit = var.width - 1; bit != (size_t)-1; bit--) {
+			bool bit_curr = data[bit / (8 * sizeof(chunk_t))] & (1 << (bit % (8 * sizeof(chunk_t))));
+			out += (bit_curr ? '1' : '0');
+		}
+		if (var.width == 0)
+			out += '0';
+		out += ' ';
+		format_ident(out, var.ident);
+		out += '\n';
+	}
+
 	void emit_time(uint64_t timestamp) {
 		assert(streaming);
-		buffer += "#" + std::to_string(timestamp) + "\n";
+		format_time(buffer, timestamp);
 	}
 
 	void emit_scalar(const variable &var) {
 		assert(streaming);
-		assert(var.width == 1);
-		buffer += (*var.curr ? '1' : '0');
-		emit_ident(var.ident);
-		buffer += '\n';
+		format_scalar(buffer, var, var.curr);
 	}
 
 	void emit_vector(const variable &var) {
 		assert(streaming);
-		buffer += 'b';
-		for (size_t bit = var.width - 1; bit != (size_t)-1; bit--) {
-			bool bit_curr = var.curr[bit / (8 * sizeof(chunk_t))] & (1 << (bit % (8 * sizeof(chunk_t))));
-			buffer += (bit_curr ? '1' : '0');
-		}
-		if (var.width == 0)
-			buffer += '0';
-		buffer += ' ';
-		emit_ident(var.ident);
-		buffer += '\n';
+		format_vector(buffer, var, var.curr);
 	}
 
+#ifdef CXXRTL_VCD_BACKGROUND
+	// In the background mode, `sample()` only copies the changed values into a ring buffer, and a separate thread
+	// formats them and passes the text to a sink. The ring buffer holds a sequence of records, either a timestamp
+	// (a zero word followed by two words of time) or a value change (the index of a variable plus one, followed by
+	// its chunks), and it is published to the formatting thread once per sample.
+	struct background {
+		std::vector<chunk_t> ring;
+		size_t mask;
+		size_t head = 0; // owned by the simulation thread
+		std::atomic<size_t> published { 0 };
+		std::atomic<size_t> consumed { 0 };
+		std::mutex mutex;
+		std::condition_variable cond;
+		bool stopping = false;
+		bool idle = true;
+		std::function<void(const std::string &)> sink;
+		std::thread thread;
+
+		void put(chunk_t word) {
+			ring[head++ & mask] = word;
+		}
+
+		// Waits until there is space for `words` more words.
+		void reserve(size_t words) {
+			assert(words <= ring.size());
+			if (head + words - consumed.load(std::memory_order_acquire) <= ring.size())
+				return;
+			publish();
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait(lock, [&] { return head + words - consumed.load(std::memory_order_acquire) <= ring.size(); });
+		}
+
+		void publish() {
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				published.store(head, std::memory_order_release);
+			}
+			cond.notify_all();
+		}
+
+		void flush() {
+			publish();
+			std::unique_lock<std::mutex> lock(mutex);
+			cond.wait(lock, [&] { return idle && consumed.load(std::memory_order_acquire) == head; });
+		}
+
+		void run(const variable *variables) {
+			std::string text;
+			size_t tail = 0;
+			while (true) {
+				size_t end;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					idle = true;
+					cond.notify_all();
+					cond.wait(lock, [&] { return stopping || published.load(std::memory_order_acquire) != tail; });
+					end = published.load(std::memory_order_acquire);
+					if (end == tail)
+						return;
+					idle = false;
+				}
+				chunk_t data[64];
+				std::vector<chunk_t> wide_data;
+				while (tail != end) {
+					chunk_t tag = ring[tail++ & mask];
+					if (tag == 0) {
+						uint64_t timestamp = ring[tail++ & mask];
+						timestamp |= (uint64_t)ring[tail++ & mask] << 32;
+						format_time(text, timestamp);
+						continue;
+					}
+					const variable &var = variables[tag - 1];
+					const size_t chunks = (var.width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+					chunk_t *var_data = data;
+					if (chunks > 64) {
+						wide_data.resize(chunks);
+						var_data = wide_data.data();
+					}
+					for (size_t offset = 0; offset < chunks; offset++)
+						var_data[offset] = ring[tail++ & mask];
+					if (var.width == 1)
+						format_scalar(text, var, var_data);
+					else
+						format_vector(text, var, var_data);
+					// Release the space early, so that the simulation thread waits as little as possible.
+					if (text.size() >= (1 << 20)) {
+						consumed.store(tail, std::memory_order_release);
+						cond.notify_all();
+						sink(text);
+						text.clear();
+					}
+				}
+				consumed.store(tail, std::memory_order_release);
+				cond.notify_all();
+				if (!text.empty()) {
+					sink(text);
+					text.clear();
+				}
+			}
+		}
+	};
+
+	std::unique_ptr<background> worker;
+#endif
+
+	bool sampled = false;
+
 	void reset_outlines() {
 		for (auto &outline_it : outlines)
 			outline_it.second = /*warm=*/(outline_it.first == nullptr);
@@ -258,13 +388,123 @@ public:
 		});
 	}
 
+	// Adds the items within `scope` (a hierarchical name, with scopes separated by spaces) for which `filter`
+	// returns `true`. Since `debug_items` is sorted by name, the items outside of the scope are never considered.
+	template<class Filter>
+	void add_scope(const debug_items &items, const std::string &scope, const Filter &filter) {
+		const std::string prefix = scope.empty() ? scope : scope + ' ';
+		for (auto it = items.table.lower_bound(prefix); it != items.table.end(); ++it) {
+			if (it->first.compare(0, prefix.size(), prefix) != 0)
+				break;
+			for (auto &part : it->second)
+				if (filter(it->first, part))
+					add(it->first, part, it->second.size() > 1);
+		}
+	}
+
+	void add_scope(const debug_items &items, const std::string &scope) {
+		this->add_scope(items, scope, [](const std::string &, const debug_item &) {
+			return true;
+		});
+	}
+
+#ifdef CXXRTL_VCD_BACKGROUND
+	// Moves the formatting of value changes to a separate thread, which passes the resulting text to `sink`. This must
+	// be called after all of the items are added, and before the first sample; the definitions are passed to `sink`
+	// right away, and `buffer` is not used afterwards. The ring buffer holds (at least) `ring_words` chunks; when
+	// it is full, `sample()` waits for the formatting thread. This mode is only available if `CXXRTL_VCD_BACKGROUND`
+	// is defined, and designs using it have to be linked with the platform's thread library (e.g. `-pthread`).
+	void start_background(std::function<void(const std::string &)> sink, size_t ring_words = 1 << 22) {
+		assert(!worker && !sampled);
+		emit_scope({});
+		emit_enddefinitions();
+		sink(buffer);
+		buffer.clear();
+
+		size_t ring_size = 1;
+		while (ring_size < ring_words)
+			ring_size <<= 1;
+		worker.reset(new background);
+		worker->ring.resize(ring_size);
+		worker->mask = ring_size - 1;
+		worker->sink = std::move(sink);
+		worker->thread = std::thread(&background::run, worker.get(), variables.data());
+	}
+
+	// Waits until the formatting thread passes every sample so far to the sink.
+	void flush_background() {
+		assert(worker);
+		worker->flush();
+	}
+
+	// Waits until the formatting thread passes every sample so far to the sink, and stops it.
+	void stop_background() {
+		assert(worker);
+		worker->flush();
+		{
+			std::lock_guard<std::mutex> lock(worker->mutex);
+			worker->stopping = true;
+		}
+		worker->cond.notify_all();
+		worker->thread.join();
+		worker.reset();
+	}
+
+	vcd_writer() = default;
+	vcd_writer(vcd_writer &&) = default;
+
+	// The formatting thread of this writer (if any) is stopped before it is replaced.
+	vcd_writer &operator=(vcd_writer &&moved) {
+		if (this != &moved) {
+			if (worker)
+				stop_background();
+			current_scope = std::move(moved.current_scope);
+			outlines = std::move(moved.outlines);
+			variables = std::move(moved.variables);
+			cache = std::move(moved.cache);
+			aliases = std::move(moved.aliases);
+			streaming = moved.streaming;
+			worker = std::move(moved.worker);
+			sampled = moved.sampled;
+			buffer = std::move(moved.buffer);
+		}
+		return *this;
+	}
+
+	~vcd_writer() {
+		if (worker)
+			stop_background();
+	}
+#endif
+
 	void sample(uint64_t timestamp) {
-		bool first_sample = !streaming;
-		if (first_sample) {
+		bool first_sample = !sampled;
+		sampled = true;
+		if (!streaming) {
 			emit_scope({});
 			emit_enddefinitions();
 		}
 		reset_outlines();
+#ifdef CXXRTL_VCD_BACKGROUND
+		if (worker) {
+			worker->reserve(3);
+			worker->put(0);
+			worker->put(timestamp >> 0);
+			worker->put(timestamp >> 32);
+			for (size_t index = 0; index < variables.size(); index++) {
+				const variable &var = variables[index];
+				if (test_variable(var) || first_sample) {
+					const size_t chunks = (var.width + (sizeof(chunk_t) * 8 - 1)) / (sizeof(chunk_t) * 8);
+					worker->reserve(chunks + 1);
+					worker->put(index + 1);
+					for (size_t offset = 0; offset < chunks; offset++)
+						worker->put(var.curr[offset]);
+				}
+			}
+			worker->publish();
+			return;
+		}
+#endif
 		emit_time(timestamp);
 		for (auto var : variables)
 			if (test_variable(var) || first_sample) {
@@ -73,10 +73,18 @@ struct CxxStruct {
 	std::string name;
 	dict<IdString, CxxType> types;
 	CxxScope<IdString> scope;
-	CxxStruct(std::string name) : name(name)
+	CxxStruct(std::string name, bool batch) : name(name)
 	{
 		scope.reserve("fn");
 		scope.reserve("visit");
+		// names used by the batched struct, which shares field names with this one
+		if (batch) {
+			scope.reserve("get");
+			scope.reserve("set");
+			scope.reserve("lane");
+			scope.reserve("value");
+			scope.reserve("N");
+		}
 	}
 	void insert(IdString name, CxxType type) {
 		scope(name, name);
@@ -94,6 +102,26 @@ struct CxxStruct {
 		f.print("\t\t}}\n");
 		f.print("\t}};\n\n");
 	};
+	// In a batch, every field holds one value per lane, so that the same field of all the instances is contiguous.
+	void print_batch(CxxWriter &f, std::string const &module_name) {
+		f.print("\t\tstruct {} {{\n", name);
+		for (auto p : types) {
+			f.print("\t\t\tstd::array<{}, N> {};\n", p.second.to_string(), scope(p.first, p.first));
+		}
+		f.print("\n\t\t\t{}::{} get(size_t lane) const {{\n", module_name, name);
+		f.print("\t\t\t\t{}::{} value;\n", module_name, name);
+		for (auto p : types) {
+			f.print("\t\t\t\tvalue.{0} = {0}[lane];\n", scope(p.first, p.first));
+		}
+		f.print("\t\t\t\treturn value;\n");
+		f.print("\t\t\t}}\n");
+		f.print("\t\t\tvoid set(size_t lane, {}::{} const &value) {{\n", module_name, name);
+		for (auto p : types) {
+			f.print("\t\t\t\t{0}[lane] = value.{0};\n", scope(p.first, p.first));
+		}
+		f.print("\t\t\t}}\n");
+		f.print("\t\t}};\n\n");
+	}
 	std::string operator[](IdString field) {
 		return scope(field, field);
 	}
@@ -118,14 +146,17 @@ template<class NodePrinter> struct CxxPrintVisitor : public Functional::Abstract
 	NodePrinter np;
 	CxxStruct &input_struct;
 	CxxStruct &state_struct;
-	CxxPrintVisitor(CxxWriter &f, NodePrinter np, CxxStruct &input_struct, CxxStruct &state_struct) : f(f), np(np), input_struct(input_struct), state_struct(state_struct) { }
+	std::string lane;
+	// in a batch the operands are elements of arrays of dependent size, so member templates need the keyword
+	std::string member_template;
+	CxxPrintVisitor(CxxWriter &f, NodePrinter np, CxxStruct &input_struct, CxxStruct &state_struct, std::string lane = "") : f(f), np(np), input_struct(input_struct), state_struct(state_struct), lane(lane), member_template(lane.empty() ? "" : "template ") { }
 	template<typename... Args> void print(const char *fmt, Args&&... args) {
 		f.print_with(np, fmt, std::forward<Args>(args)...);
 	}
 	void buf(Node, Node n) override { print("{}", n); }
-	void slice(Node, Node a, int offset, int out_width) override { print("{0}.slice<{2}>({1})", a, offset, out_width); }
-	void zero_extend(Node, Node a, int out_width) override { print("{}.zero_extend<{}>()", a, out_width); }
-	void sign_extend(Node, Node a, int out_width) override { print("{}.sign_extend<{}>()", a, out_width); }
+	void slice(Node, Node a, int offset, int out_width) override { print("{0}.{3}slice<{2}>({1})", a, offset, out_width, member_template); }
+	void zero_extend(Node, Node a, int out_width) override { print("{}.{}zero_extend<{}>()", a, member_template, out_width); }
+	void sign_extend(Node, Node a, int out_width) override { print("{}.{}sign_extend<{}>()", a, member_template, out_width); }
 	void concat(Node, Node a, Node b) override { print("{}.concat({})", a, b); }
 	void add(Node, Node a, Node b) override { print("{} + {}", a, b); }
 	void sub(Node, Node a, Node b) override { print("{} - {}", a, b); }
@@ -151,8 +182,8 @@ template<class NodePrinter> struct CxxPrintVisitor : public Functional::Abstract
 	void arithmetic_shift_right(Node, Node a, Node b) override { print("{}.arithmetic_shift_right({})", a, b); }
 	void mux(Node, Node a, Node b, Node s) override { print("{2}.any() ? {1} : {0}", a, b, s); }
 	void constant(Node, RTLIL::Const const & value) override { print("{}", cxx_const(value)); }
-	void input(Node, IdString name, IdString kind) override { log_assert(kind == ID($input)); print("input.{}", input_struct[name]); }
-	void state(Node, IdString name, IdString kind) override { log_assert(kind == ID($state)); print("current_state.{}", state_struct[name]); }
+	void input(Node, IdString name, IdString kind) override { log_assert(kind == ID($input)); print("input.{}{}", input_struct[name], lane); }
+	void state(Node, IdString name, IdString kind) override { log_assert(kind == ID($state)); print("current_state.{}{}", state_struct[name], lane); }
 	void memory_read(Node, Node mem, Node addr) override { print("{}.read({})", mem, addr); }
 	void memory_write(Node, Node mem, Node addr, Node data) override { print("{}.write({}, {})", mem, addr, data); }
 };
@@ -169,12 +200,14 @@ struct CxxModule {
 	Functional::IR ir;
 	CxxStruct input_struct, output_struct, state_struct;
 	std::string module_name;
+	bool batch;
 
-	explicit CxxModule(Module *module) :
+	explicit CxxModule(Module *module, bool batch = false) :
 		ir(Functional::IR::from_module(module)),
-		input_struct("Inputs"),
-		output_struct("Outputs"),
-		state_struct("State")
+		input_struct("Inputs", batch),
+		output_struct("Outputs", batch),
+		state_struct("State", batch),
+		batch(batch)
 	{
 		for (auto input : ir.inputs())
 			input_struct.insert(input->name, input->sort);
@@ -186,6 +219,8 @@ struct CxxModule {
 	}
 	void write_header(CxxWriter &f) {
 		f.print("#include \"sim.h\"\n\n");
+		if (batch)
+			f.print("#include <array>\n#include <cstddef>\n\n");
 	}
 	void write_struct_def(CxxWriter &f) {
 		f.print("struct {} {{\n", module_name);
@@ -194,6 +229,15 @@ struct CxxModule {
 		state_struct.print(f);
 		f.print("\tstatic void eval(Inputs const &, Outputs &, State const &, State &);\n");
 		f.print("\tstatic void initialize(State &);\n");
+		if (batch) {
+			f.print("\n\ttemplate <size_t N> struct Batch {{\n");
+			input_struct.print_batch(f, module_name);
+			output_struct.print_batch(f, module_name);
+			state_struct.print_batch(f, module_name);
+			f.print("\t\tstatic void eval(Inputs const &, Outputs &, State const &, State &);\n");
+			f.print("\t\tstatic void initialize(State &);\n");
+			f.print("\t}};\n");
+		}
 		f.print("}};\n\n");
 	}
 	void write_initial_def(CxxWriter &f) {
@@ -236,6 +280,39 @@ struct CxxModule {
 			f.print("\toutput.{} = {};\n", output_struct[output->name], node_name(output->value()));
 		f.print("}}\n\n");
 	}
+	// Each node is evaluated for all the lanes in a loop of its own, which the compiler can vectorize since the lanes
+	// of a node are laid out contiguously and do not depend on each other.
+	void write_batch_eval_def(CxxWriter &f) {
+		f.print("template <size_t N>\nvoid {0}::Batch<N>::eval(Inputs const &input, Outputs &output, State const &current_state, State &next_state)\n{{\n", module_name);
+		CxxScope<int> locals;
+		locals.reserve("input");
+		locals.reserve("output");
+		locals.reserve("current_state");
+		locals.reserve("next_state");
+		locals.reserve("lane");
+		locals.reserve("N");
+		auto node_name = [&](Functional::Node n) { return locals(n.id(), n.name()) + "[lane]"; };
+		CxxPrintVisitor printVisitor(f, node_name, input_struct, state_struct, "[lane]");
+		for (auto node : ir) {
+			f.print("\tstd::array<{}, N> {};\n", CxxType(node.sort()).to_string(), locals(node.id(), node.name()));
+			f.print("\tfor (size_t lane = 0; lane < N; lane++)\n\t\t{} = ", node_name(node));
+			node.visit(printVisitor);
+			f.print(";\n");
+		}
+		for (auto state : ir.states())
+			f.print("\tnext_state.{} = {};\n", state_struct[state->name], locals(state->next_value().id(), state->next_value().name()));
+		for (auto output : ir.outputs())
+			f.print("\toutput.{} = {};\n", output_struct[output->name], locals(output->value().id(), output->value().name()));
+		f.print("}}\n\n");
+	}
+	void write_batch_initial_def(CxxWriter &f) {
+		f.print("template <size_t N>\nvoid {0}::Batch<N>::initialize(State &state)\n{{\n", module_name);
+		f.print("\t{}::State initial;\n", module_name);
+		f.print("\t{}::initialize(initial);\n", module_name);
+		f.print("\tfor (size_t lane = 0; lane < N; lane++)\n");
+		f.print("\t\tstate.set(lane, initial);\n");
+		f.print("}}\n\n");
+	}
 };
 
 struct FunctionalCxxBackend : public Backend
@@ -246,30 +323,64 @@ struct FunctionalCxxBackend : public Backend
 	{
 		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
 		log("\n");
-		log("TODO: add help message\n");
+		log("    write_functional_cxx [options] [filename]\n");
+		log("\n");
+		log("Functional C++ backend. Each selected module is written as a struct with the\n");
+		log("nested types `Inputs`, `Outputs` and `State`, and the static functions `eval`\n");
+		log("(computing the outputs and the next state from the inputs and the current\n");
+		log("state) and `initialize`. The generated code includes \"sim.h\" from the\n");
+		log("`backends/functional/cxx_runtime` directory.\n");
+		log("\n");
+		log("    -batch\n");
+		log("        additionally write a `Batch<N>` template that evaluates N independent\n");
+		log("        instances of the module at once. Its `Inputs`, `Outputs` and `State`\n");
+		log("        hold an array of N values per field (structure-of-arrays layout),\n");
+		log("        and `get(lane)` / `set(lane, value)` convert a single instance from\n");
+		log("        and to the non-batched types. Every node is evaluated for all the\n");
+		log("        instances in one loop, which the C++ compiler can vectorize. All the\n");
+		log("        intermediate values are kept on the stack, so N should be moderate\n");
+		log("        for large designs (e.g. 8 to 64).\n");
+		log("\n");
+		log("The header \"yw.h\" from the same directory reads Yosys witness (.yw) files\n");
+		log("and applies their steps to the `Inputs` (and initial `State`) of a model,\n");
+		log("which is useful to drive the batched model with many stimulus files.\n");
 		log("\n");
     }
 
-	void printCxx(std::ostream &stream, std::string, Module *module)
+	void printCxx(std::ostream &stream, std::string, Module *module, bool batch)
 	{
 		CxxWriter f(stream);
-		CxxModule mod(module);
+		CxxModule mod(module, batch);
 		mod.write_header(f);
 		mod.write_struct_def(f);
 		mod.write_eval_def(f);
 		mod.write_initial_def(f);
+		if (batch) {
+			mod.write_batch_eval_def(f);
+			mod.write_batch_initial_def(f);
+		}
 	}
 
 	void execute(std::ostream *&f, std::string filename, std::vector<std::string> args, RTLIL::Design *design) override
 	{
         log_header(design, "Executing Functional C++ backend.\n");
 
-		size_t argidx = 1;
+		bool batch = false;
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++)
+		{
+			if (args[argidx] == "-batch") {
+				batch = true;
+				continue;
+			}
+			break;
+		}
 		extra_args(f, filename, args, argidx, design);
 
 		for (auto module : design->selected_modules()) {
             log("Dumping module `%s'.\n", module->name.c_str());
-			printCxx(*f, filename, module);
+			printCxx(*f, filename, module, batch);
 		}
 	}
 } FunctionalCxxBackend;
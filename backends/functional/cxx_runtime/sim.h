@@ -95,6 +95,7 @@ public:
 
     int size() const { return n; }
     bool operator[](int i) const { assert(n >= 0 && i < n); return _bits[i]; }
+    void set_bit(int i, bool b) { assert(n >= 0 && i < n); _bits[i] = b; }
 
     template<size_t m>
     Signal<m> slice(size_t offset) const
@@ -0,0 +1,282 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+// Reads Yosys witness traces (.yw files, see `kernel/yw.cc` for the reader used by Yosys itself) and applies them
+// to the structs generated by `write_functional_cxx`. Only signals at the top of the hierarchy (with a path of a
+// single element) can be matched against the fields of a struct; all other signals are ignored.
+
+#ifndef YW_H
+#define YW_H
+
+#include <cctype>
+#include <cstdlib>
+#include <istream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "sim.h"
+
+class YwWitness {
+	// Just enough of a JSON parser to read witness files.
+	struct Json {
+		enum Kind { Null, Bool, Number, String, Array, Object } kind = Null;
+		bool boolean = false;
+		double number = 0;
+		std::string string;
+		std::vector<Json> items;
+		std::vector<std::pair<std::string, Json>> members;
+
+		const Json &operator[](const std::string &key) const {
+			static const Json null;
+			for (auto &member : members)
+				if (member.first == key)
+					return member.second;
+			return null;
+		}
+	};
+
+	struct JsonParser {
+		const std::string &text;
+		size_t pos = 0;
+		std::string error;
+
+		JsonParser(const std::string &text) : text(text) {}
+
+		void skip_space() {
+			while (pos < text.size() && isspace((unsigned char)text[pos]))
+				pos++;
+		}
+		bool fail(const char *message) {
+			if (error.empty())
+				error = std::string(message) + " at offset " + std::to_string(pos);
+			return false;
+		}
+		bool expect(const char *literal) {
+			for (const char *p = literal; *p; p++, pos++)
+				if (pos >= text.size() || text[pos] != *p)
+					return fail("unexpected character");
+			return true;
+		}
+		bool parse_string(std::string &out) {
+			if (!expect("\""))
+				return false;
+			while (pos < text.size() && text[pos] != '"') {
+				char c = text[pos++];
+				if (c == '\\') {
+					if (pos >= text.size())
+						break;
+					c = text[pos++];
+					switch (c) {
+						case 'n': c = '\n'; break;
+						case 't': c = '\t'; break;
+						case 'r': c = '\r'; break;
+						case 'b': c = '\b'; break;
+						case 'f': c = '\f'; break;
+						case 'u': {
+							// Witness paths are ASCII; anything else is replaced with `?`.
+							if (pos + 4 > text.size())
+								return fail("truncated escape");
+							unsigned long code = strtoul(text.substr(pos, 4).c_str(), nullptr, 16);
+							pos += 4;
+							c = code < 0x80 ? (char)code : '?';
+							break;
+						}
+						default: break;
+					}
+				}
+				out += c;
+			}
+			return expect("\"");
+		}
+		bool parse(Json &value) {
+			skip_space();
+			if (pos >= text.size())
+				return fail("unexpected end of input");
+			char c = text[pos];
+			if (c == '{') {
+				value.kind = Json::Object;
+				pos++;
+				skip_space();
+				if (pos < text.size() && text[pos] == '}')
+					return ++pos, true;
+				while (true) {
+					std::string key;
+					skip_space();
+					if (!parse_string(key))
+						return false;
+					skip_space();
+					if (!expect(":"))
+						return false;
+					value.members.emplace_back(key, Json());
+					if (!parse(value.members.back().second))
+						return false;
+					skip_space();
+					if (pos < text.size() && text[pos] == ',') {
+						pos++;
+						continue;
+					}
+					return expect("}");
+				}
+			} else if (c == '[') {
+				value.kind = Json::Array;
+				pos++;
+				skip_space();
+				if (pos < text.size() && text[pos] == ']')
+					return ++pos, true;
+				while (true) {
+					value.items.emplace_back();
+					if (!parse(value.items.back()))
+						return false;
+					skip_space();
+					if (pos < text.size() && text[pos] == ',') {
+						pos++;
+						continue;
+					}
+					return expect("]");
+				}
+			} else if (c == '"') {
+				value.kind = Json::String;
+				return parse_string(value.string);
+			} else if (c == 't') {
+				value.kind = Json::Bool;
+				value.boolean = true;
+				return expect("true");
+			} else if (c == 'f') {
+				value.kind = Json::Bool;
+				return expect("false");
+			} else if (c == 'n') {
+				return expect("null");
+			} else if (c == '-' || isdigit((unsigned char)c)) {
+				value.kind = Json::Number;
+				const char *begin = text.c_str() + pos;
+				char *end;
+				value.number = strtod(begin, &end);
+				pos += end - begin;
+				return true;
+			}
+			return fail("unexpected character");
+		}
+	};
+
+	std::multimap<std::string, size_t> by_name;
+
+	static std::string unescape(const std::string &name) {
+		if (name.size() > 1 && name[0] == '\\')
+			return name.substr(1);
+		return name;
+	}
+
+	struct Apply {
+		const YwWitness &witness;
+		size_t step;
+		bool init;
+
+		template <size_t n> void operator()(const char *name, Signal<n> &value) {
+			auto range = witness.by_name.equal_range(name);
+			for (auto it = range.first; it != range.second; ++it) {
+				const SignalInfo &signal = witness.signals[it->second];
+				if (signal.init_only != init)
+					continue;
+				const std::string &bits = witness.steps[step];
+				for (int i = 0; i < signal.width && signal.offset + i < (int)n; i++) {
+					int index = (int)bits.size() - 1 - signal.bits_offset - i;
+					if (index < 0)
+						break;
+					// `x` and `?` bits are left as they are.
+					if (bits[index] == '0' || bits[index] == '1')
+						value.set_bit(signal.offset + i, bits[index] == '1');
+				}
+			}
+		}
+		template <size_t a, size_t d> void operator()(const char *, Memory<a, d> &) {}
+	};
+
+public:
+	struct SignalInfo {
+		std::vector<std::string> path;
+		int offset = 0;
+		int width = 0;
+		int bits_offset = 0;
+		bool init_only = false;
+	};
+
+	std::vector<SignalInfo> signals;
+	std::vector<std::string> steps;
+
+	// Returns false and sets `error` if the input is not a witness trace.
+	bool read(std::istream &is, std::string &error) {
+		std::string text((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+		JsonParser parser(text);
+		Json json;
+		if (!parser.parse(json)) {
+			error = parser.error;
+			return false;
+		}
+		if (json["format"].string != "Yosys Witness Trace") {
+			error = "unsupported format";
+			return false;
+		}
+		signals.clear();
+		steps.clear();
+		by_name.clear();
+		int bits_offset = 0;
+		for (auto &signal_json : json["signals"].items) {
+			SignalInfo signal;
+			for (auto &path_item : signal_json["path"].items)
+				signal.path.push_back(path_item.string);
+			if (signal.path.empty() || signal_json["width"].kind != Json::Number ||
+					signal_json["offset"].kind != Json::Number) {
+				error = "invalid signal";
+				return false;
+			}
+			signal.width = (int)signal_json["width"].number;
+			signal.offset = (int)signal_json["offset"].number;
+			signal.init_only = signal_json["init_only"].boolean;
+			signal.bits_offset = bits_offset;
+			bits_offset += signal.width;
+			if (signal.path.size() == 1)
+				by_name.emplace(unescape(signal.path[0]), signals.size());
+			signals.push_back(signal);
+		}
+		for (auto &step_json : json["steps"].items) {
+			if (step_json["bits"].kind != Json::String) {
+				error = "invalid step " + std::to_string(steps.size());
+				return false;
+			}
+			steps.push_back(step_json["bits"].string);
+		}
+		return true;
+	}
+
+	size_t size() const { return steps.size(); }
+
+	// Sets the fields of `inputs` that have a value in the given step.
+	template <typename Inputs> void apply_inputs(size_t step, Inputs &inputs) const {
+		assert(step < steps.size());
+		inputs.visit(Apply { *this, step, false });
+	}
+
+	// Sets the fields of `state` that have an initial value (in the first step).
+	template <typename State> void apply_initial(State &state) const {
+		if (!steps.empty())
+			state.visit(Apply { *this, 0, true });
+	}
+};
+
+#endif
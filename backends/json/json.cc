@@ -24,6 +24,7 @@
 #include "kernel/cellaigs.h"
 #include "kernel/log.h"
 #include <string>
+#include <charconv>
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
@@ -35,18 +36,118 @@ struct JsonWriter
 	bool aig_mode;
 	bool compat_int_mode;
 	bool scopeinfo_mode;
+	bool compact_mode;
+	bool hexinit_mode;
 
 	Design *design;
 	Module *module;
 
 	SigMap sigmap;
 	int sigidcounter;
-	dict<SigBit, string> sigids;
+	dict<SigBit, int> sigids;
+	dict<IdString, string> name_cache;
 	pool<Aig> aig_models;
 
-	JsonWriter(std::ostream &f, bool use_selection, bool aig_mode, bool compat_int_mode, bool scopeinfo_mode) :
+	// The output is collected in a large buffer and handed to the stream in
+	// big blocks, which is much faster than many small formatted writes.
+	static constexpr size_t buffer_size = 1 << 20;
+	string buffer;
+
+	JsonWriter(std::ostream &f, bool use_selection, bool aig_mode, bool compat_int_mode, bool scopeinfo_mode,
+			bool compact_mode, bool hexinit_mode) :
 			f(f), use_selection(use_selection), aig_mode(aig_mode),
-			compat_int_mode(compat_int_mode), scopeinfo_mode(scopeinfo_mode) { }
+			compat_int_mode(compat_int_mode), scopeinfo_mode(scopeinfo_mode),
+			compact_mode(compact_mode), hexinit_mode(hexinit_mode)
+	{
+		buffer.reserve(buffer_size + 4096);
+	}
+
+	void flush()
+	{
+		f.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+
+	void emit(char c)
+	{
+		buffer += c;
+	}
+
+	void emit(const char *str)
+	{
+		buffer += str;
+	}
+
+	void emit(const string &str)
+	{
+		buffer += str;
+		if (buffer.size() >= buffer_size)
+			flush();
+	}
+
+	void emit_int(long long value)
+	{
+		char buf[24];
+		auto res = std::to_chars(buf, buf + sizeof(buf), value);
+		buffer.append(buf, res.ptr);
+	}
+
+	// Line break followed by indentation, omitted in compact mode.
+	void newline(int indent)
+	{
+		if (compact_mode)
+			return;
+		buffer += '\n';
+		buffer.append(indent, ' ');
+		if (buffer.size() >= buffer_size)
+			flush();
+	}
+
+	void emit_colon()
+	{
+		emit(compact_mode ? ":" : ": ");
+	}
+
+	// Separator between the elements of a single line list.
+	void emit_comma()
+	{
+		emit(compact_mode ? "," : ", ");
+	}
+
+	void emit_key(int indent, const char *key)
+	{
+		newline(indent);
+		emit(key);
+		emit_colon();
+	}
+
+	// Matches what read_json accepts as a hex INIT value, see json_parse_hex_const().
+	static bool is_hex_const(const string &str)
+	{
+		size_t cursor = str.find_first_not_of("0123456789");
+		if (cursor == 0 || cursor == string::npos || cursor > 9 || str.compare(cursor, 2, "'h") != 0)
+			return false;
+		if (cursor + 2 == str.size() || str.find_first_not_of("0123456789abcdefABCDEF", cursor + 2) != string::npos)
+			return false;
+		int width = atoi(str.c_str());
+		return width != 0 && (width + 3) / 4 == GetSize(str) - int(cursor) - 2;
+	}
+
+	void emit_string(const string &str)
+	{
+		size_t cursor = 0;
+		for (; cursor < str.size(); cursor++) {
+			unsigned char c = str[cursor];
+			if (c == '\\' || c == '"' || c < 0x20)
+				break;
+		}
+		if (cursor == str.size()) {
+			emit('"');
+			emit(str);
+			emit('"');
+		} else
+			emit(get_string(str));
+	}
 
 	string get_string(string str)
 	{
@@ -79,29 +180,50 @@ struct JsonWriter
 		return get_string(RTLIL::unescape_id(name));
 	}
 
-	string get_bits(SigSpec sig)
+	// Used for names that occur over and over again (types, ports, parameters
+	// and attributes), cell and wire names are usually unique and not cached.
+	void emit_cached_name(IdString name)
+	{
+		auto it = name_cache.find(name);
+		if (it == name_cache.end())
+			it = name_cache.emplace(name, get_name(name)).first;
+		emit(it->second);
+	}
+
+	void emit_name(IdString name)
+	{
+		emit_string(RTLIL::unescape_id(name));
+	}
+
+	void emit_bits(const SigSpec &sig)
 	{
 		bool first = true;
-		string str = "[";
-		for (auto bit : sigmap(sig)) {
-			str += first ? " " : ", ";
+		emit('[');
+		for (auto bit : sig) {
+			if (!first)
+				emit_comma();
+			else if (!compact_mode)
+				emit(' ');
 			first = false;
-			if (sigids.count(bit) == 0) {
-				string &s = sigids[bit];
-				if (bit.wire == nullptr) {
-					if (bit == State::S0) s = "\"0\"";
-					else if (bit == State::S1) s = "\"1\"";
-					else if (bit == State::Sz) s = "\"z\"";
-					else s = "\"x\"";
-				} else
-					s = stringf("%d", sigidcounter++);
+			sigmap.apply(bit);
+			if (bit.wire == nullptr) {
+				if (bit == State::S0) emit("\"0\"");
+				else if (bit == State::S1) emit("\"1\"");
+				else if (bit == State::Sz) emit("\"z\"");
+				else emit("\"x\"");
+			} else {
+				auto it = sigids.find(bit);
+				if (it == sigids.end())
+					it = sigids.emplace(bit, sigidcounter++).first;
+				emit_int(it->second);
 			}
-			str += sigids[bit];
 		}
-		return str + " ]";
+		emit(compact_mode ? "]" : " ]");
+		if (buffer.size() >= buffer_size)
+			flush();
 	}
 
-	void write_parameter_value(const Const &value)
+	void write_parameter_value(IdString name, const Const &value)
 	{
 		if ((value.flags & RTLIL::ConstFlags::CONST_FLAG_STRING) != 0) {
 			string str = value.decode_string();
@@ -117,16 +239,31 @@ struct JsonWriter
 				} else if (state == 1 && c != ' ')
 					state = 2;
 			}
-			if (state < 2)
+			if (state < 2 || (name == ID::INIT && is_hex_const(str)))
 				str += " ";
-			f << get_string(str);
+			emit_string(str);
 		} else if (compat_int_mode && GetSize(value) <= 32 && value.is_fully_def()) {
 			if ((value.flags & RTLIL::ConstFlags::CONST_FLAG_SIGNED) != 0)
-				f << stringf("%d", value.as_int());
+				emit_int(value.as_int());
 			else
-				f << stringf("%u", value.as_int());
+				emit_int((unsigned int)value.as_int());
+		} else if (hexinit_mode && name == ID::INIT && !value.empty() && value.is_fully_def()) {
+			string hex;
+			for (int i = 0; i < GetSize(value); i += 4) {
+				int digit = 0;
+				for (int j = 0; j < 4 && i + j < GetSize(value); j++)
+					if (value[i + j] == State::S1)
+						digit |= 1 << j;
+				hex += "0123456789abcdef"[digit];
+			}
+			std::reverse(hex.begin(), hex.end());
+			emit('"');
+			emit_int(GetSize(value));
+			emit("'h");
+			emit(hex);
+			emit('"');
 		} else {
-			f << get_string(value.as_string());
+			emit_string(value.as_string());
 		}
 	}
 
@@ -134,9 +271,12 @@ struct JsonWriter
 	{
 		bool first = true;
 		for (auto &param : parameters) {
-			f << stringf("%s\n", first ? "" : ",");
-			f << stringf("        %s%s: ", for_module ? "" : "    ", get_name(param.first).c_str());
-			write_parameter_value(param.second);
+			if (!first)
+				emit(',');
+			newline(for_module ? 8 : 12);
+			emit_cached_name(param.first);
+			emit_colon();
+			write_parameter_value(param.first, param.second);
 			first = false;
 		}
 	}
@@ -155,134 +295,219 @@ struct JsonWriter
 			log_error("Module %s contains processes, which are not supported by JSON backend (run `proc` first).\n", log_id(module));
 		}
 
-		f << stringf("    %s: {\n", get_name(module->name).c_str());
+		newline(4);
+		emit_name(module->name);
+		emit_colon();
+		emit('{');
 
-		f << stringf("      \"attributes\": {");
+		emit_key(6, "\"attributes\"");
+		emit('{');
 		write_parameters(module->attributes, /*for_module=*/true);
-		f << stringf("\n      },\n");
+		newline(6);
+		emit("},");
 
 		if (module->parameter_default_values.size()) {
-			f << stringf("      \"parameter_default_values\": {");
+			emit_key(6, "\"parameter_default_values\"");
+			emit('{');
 			write_parameters(module->parameter_default_values, /*for_module=*/true);
-			f << stringf("\n      },\n");
+			newline(6);
+			emit("},");
 		}
 
-		f << stringf("      \"ports\": {");
+		emit_key(6, "\"ports\"");
+		emit('{');
 		bool first = true;
 		for (auto n : module->ports) {
 			Wire *w = module->wire(n);
 			if (use_selection && !module->selected(w))
 				continue;
-			f << stringf("%s\n", first ? "" : ",");
-			f << stringf("        %s: {\n", get_name(n).c_str());
-			f << stringf("          \"direction\": \"%s\",\n", w->port_input ? w->port_output ? "inout" : "input" : "output");
-			if (w->start_offset)
-				f << stringf("          \"offset\": %d,\n", w->start_offset);
-			if (w->upto)
-				f << stringf("          \"upto\": 1,\n");
-			if (w->is_signed)
-				f << stringf("          \"signed\": %d,\n", w->is_signed);
-			f << stringf("          \"bits\": %s\n", get_bits(w).c_str());
-			f << stringf("        }");
+			if (!first)
+				emit(',');
+			newline(8);
+			emit_cached_name(n);
+			emit_colon();
+			emit('{');
+			emit_key(10, "\"direction\"");
+			emit(w->port_input ? w->port_output ? "\"inout\"," : "\"input\"," : "\"output\",");
+			if (w->start_offset) {
+				emit_key(10, "\"offset\"");
+				emit_int(w->start_offset);
+				emit(',');
+			}
+			if (w->upto) {
+				emit_key(10, "\"upto\"");
+				emit("1,");
+			}
+			if (w->is_signed) {
+				emit_key(10, "\"signed\"");
+				emit("1,");
+			}
+			emit_key(10, "\"bits\"");
+			emit_bits(w);
+			newline(8);
+			emit('}');
 			first = false;
 		}
-		f << stringf("\n      },\n");
+		newline(6);
+		emit("},");
 
-		f << stringf("      \"cells\": {");
+		emit_key(6, "\"cells\"");
+		emit('{');
 		first = true;
 		for (auto c : module->cells()) {
 			if (use_selection && !module->selected(c))
 				continue;
 			if (!scopeinfo_mode && c->type == ID($scopeinfo))
 				continue;
-			f << stringf("%s\n", first ? "" : ",");
-			f << stringf("        %s: {\n", get_name(c->name).c_str());
-			f << stringf("          \"hide_name\": %s,\n", c->name[0] == '$' ? "1" : "0");
-			f << stringf("          \"type\": %s,\n", get_name(c->type).c_str());
+			if (!first)
+				emit(',');
+			newline(8);
+			emit_name(c->name);
+			emit_colon();
+			emit('{');
+			emit_key(10, "\"hide_name\"");
+			emit(c->name[0] == '$' ? "1," : "0,");
+			emit_key(10, "\"type\"");
+			emit_cached_name(c->type);
+			emit(',');
 			if (aig_mode) {
 				Aig aig(c);
 				if (!aig.name.empty()) {
-					f << stringf("          \"model\": \"%s\",\n", aig.name.c_str());
+					emit_key(10, "\"model\"");
+					emit(stringf("\"%s\",", aig.name.c_str()));
 					aig_models.insert(aig);
 				}
 			}
-			f << stringf("          \"parameters\": {");
+			emit_key(10, "\"parameters\"");
+			emit('{');
 			write_parameters(c->parameters);
-			f << stringf("\n          },\n");
-			f << stringf("          \"attributes\": {");
+			newline(10);
+			emit("},");
+			emit_key(10, "\"attributes\"");
+			emit('{');
 			write_parameters(c->attributes);
-			f << stringf("\n          },\n");
+			newline(10);
+			emit("},");
 			if (c->known()) {
-				f << stringf("          \"port_directions\": {");
+				emit_key(10, "\"port_directions\"");
+				emit('{');
 				bool first2 = true;
 				for (auto &conn : c->connections()) {
-					string direction = "output";
+					const char *direction = "\"output\"";
 					if (c->input(conn.first))
-						direction = c->output(conn.first) ? "inout" : "input";
-					f << stringf("%s\n", first2 ? "" : ",");
-					f << stringf("            %s: \"%s\"", get_name(conn.first).c_str(), direction.c_str());
+						direction = c->output(conn.first) ? "\"inout\"" : "\"input\"";
+					if (!first2)
+						emit(',');
+					newline(12);
+					emit_cached_name(conn.first);
+					emit_colon();
+					emit(direction);
 					first2 = false;
 				}
-				f << stringf("\n          },\n");
+				newline(10);
+				emit("},");
 			}
-			f << stringf("          \"connections\": {");
+			emit_key(10, "\"connections\"");
+			emit('{');
 			bool first2 = true;
 			for (auto &conn : c->connections()) {
-				f << stringf("%s\n", first2 ? "" : ",");
-				f << stringf("            %s: %s", get_name(conn.first).c_str(), get_bits(conn.second).c_str());
+				if (!first2)
+					emit(',');
+				newline(12);
+				emit_cached_name(conn.first);
+				emit_colon();
+				emit_bits(conn.second);
 				first2 = false;
 			}
-			f << stringf("\n          }\n");
-			f << stringf("        }");
+			newline(10);
+			emit('}');
+			newline(8);
+			emit('}');
 			first = false;
 		}
-		f << stringf("\n      },\n");
+		newline(6);
+		emit("},");
 
 		if (!module->memories.empty()) {
-			f << stringf("      \"memories\": {");
+			emit_key(6, "\"memories\"");
+			emit('{');
 			first = true;
 			for (auto &it : module->memories) {
 				if (use_selection && !module->selected(it.second))
 					continue;
-				f << stringf("%s\n", first ? "" : ",");
-				f << stringf("        %s: {\n", get_name(it.second->name).c_str());
-				f << stringf("          \"hide_name\": %s,\n", it.second->name[0] == '$' ? "1" : "0");
-				f << stringf("          \"attributes\": {");
+				if (!first)
+					emit(',');
+				newline(8);
+				emit_name(it.second->name);
+				emit_colon();
+				emit('{');
+				emit_key(10, "\"hide_name\"");
+				emit(it.second->name[0] == '$' ? "1," : "0,");
+				emit_key(10, "\"attributes\"");
+				emit('{');
 				write_parameters(it.second->attributes);
-				f << stringf("\n          },\n");
-				f << stringf("          \"width\": %d,\n", it.second->width);
-				f << stringf("          \"start_offset\": %d,\n", it.second->start_offset);
-				f << stringf("          \"size\": %d\n", it.second->size);
-				f << stringf("        }");
+				newline(10);
+				emit("},");
+				emit_key(10, "\"width\"");
+				emit_int(it.second->width);
+				emit(',');
+				emit_key(10, "\"start_offset\"");
+				emit_int(it.second->start_offset);
+				emit(',');
+				emit_key(10, "\"size\"");
+				emit_int(it.second->size);
+				newline(8);
+				emit('}');
 				first = false;
 			}
-			f << stringf("\n      },\n");
+			newline(6);
+			emit("},");
 		}
 
-		f << stringf("      \"netnames\": {");
+		emit_key(6, "\"netnames\"");
+		emit('{');
 		first = true;
 		for (auto w : module->wires()) {
 			if (use_selection && !module->selected(w))
 				continue;
-			f << stringf("%s\n", first ? "" : ",");
-			f << stringf("        %s: {\n", get_name(w->name).c_str());
-			f << stringf("          \"hide_name\": %s,\n", w->name[0] == '$' ? "1" : "0");
-			f << stringf("          \"bits\": %s,\n", get_bits(w).c_str());
-			if (w->start_offset)
-				f << stringf("          \"offset\": %d,\n", w->start_offset);
-			if (w->upto)
-				f << stringf("          \"upto\": 1,\n");
-			if (w->is_signed)
-				f << stringf("          \"signed\": %d,\n", w->is_signed);
-			f << stringf("          \"attributes\": {");
+			if (!first)
+				emit(',');
+			newline(8);
+			emit_name(w->name);
+			emit_colon();
+			emit('{');
+			emit_key(10, "\"hide_name\"");
+			emit(w->name[0] == '$' ? "1," : "0,");
+			emit_key(10, "\"bits\"");
+			emit_bits(w);
+			emit(',');
+			if (w->start_offset) {
+				emit_key(10, "\"offset\"");
+				emit_int(w->start_offset);
+				emit(',');
+			}
+			if (w->upto) {
+				emit_key(10, "\"upto\"");
+				emit("1,");
+			}
+			if (w->is_signed) {
+				emit_key(10, "\"signed\"");
+				emit("1,");
+			}
+			emit_key(10, "\"attributes\"");
+			emit('{');
 			write_parameters(w->attributes);
-			f << stringf("\n          }\n");
-			f << stringf("        }");
+			newline(10);
+			emit('}');
+			newline(8);
+			emit('}');
 			first = false;
 		}
-		f << stringf("\n      }\n");
+		newline(6);
+		emit('}');
 
-		f << stringf("    }");
+		newline(4);
+		emit('}');
 	}
 
 	void write_design(Design *design_)
@@ -290,48 +515,76 @@ struct JsonWriter
 		design = design_;
 		design->sort();
 
-		f << stringf("{\n");
-		f << stringf("  \"creator\": %s,\n", get_string(yosys_version_str).c_str());
-		f << stringf("  \"modules\": {\n");
+		emit('{');
+		emit_key(2, "\"creator\"");
+		emit_string(yosys_version_str);
+		emit(',');
+		emit_key(2, "\"modules\"");
+		emit('{');
 		vector<Module*> modules = use_selection ? design->selected_modules() : design->modules();
 		bool first_module = true;
 		for (auto mod : modules) {
 			if (!first_module)
-				f << stringf(",\n");
+				emit(',');
 			write_module(mod);
 			first_module = false;
 		}
-		f << stringf("\n  }");
+		newline(2);
+		emit('}');
 		if (!aig_models.empty()) {
-			f << stringf(",\n  \"models\": {\n");
+			emit(',');
+			emit_key(2, "\"models\"");
+			emit('{');
 			bool first_model = true;
 			for (auto &aig : aig_models) {
 				if (!first_model)
-					f << stringf(",\n");
-				f << stringf("    \"%s\": [\n", aig.name.c_str());
+					emit(',');
+				newline(4);
+				emit(stringf("\"%s\"", aig.name.c_str()));
+				emit_colon();
+				emit('[');
 				int node_idx = 0;
 				for (auto &node : aig.nodes) {
 					if (node_idx != 0)
-						f << stringf(",\n");
-					f << stringf("      /* %3d */ [ ", node_idx);
-					if (node.portbit >= 0)
-						f << stringf("\"%sport\", \"%s\", %d", node.inverter ? "n" : "",
-								log_id(node.portname), node.portbit);
-					else if (node.left_parent < 0 && node.right_parent < 0)
-						f << stringf("\"%s\"", node.inverter ? "true" : "false");
-					else
-						f << stringf("\"%s\", %d, %d", node.inverter ? "nand" : "and", node.left_parent, node.right_parent);
-					for (auto &op : node.outports)
-						f << stringf(", \"%s\", %d", log_id(op.first), op.second);
-					f << stringf(" ]");
+						emit(',');
+					newline(6);
+					if (!compact_mode)
+						emit(stringf("/* %3d */ ", node_idx));
+					emit(compact_mode ? "[" : "[ ");
+					if (node.portbit >= 0) {
+						emit(stringf("\"%sport\"", node.inverter ? "n" : ""));
+						emit_comma();
+						emit_string(log_id(node.portname));
+						emit_comma();
+						emit_int(node.portbit);
+					} else if (node.left_parent < 0 && node.right_parent < 0) {
+						emit(stringf("\"%s\"", node.inverter ? "true" : "false"));
+					} else {
+						emit(stringf("\"%s\"", node.inverter ? "nand" : "and"));
+						emit_comma();
+						emit_int(node.left_parent);
+						emit_comma();
+						emit_int(node.right_parent);
+					}
+					for (auto &op : node.outports) {
+						emit_comma();
+						emit_string(log_id(op.first));
+						emit_comma();
+						emit_int(op.second);
+					}
+					emit(compact_mode ? "]" : " ]");
 					node_idx++;
 				}
-				f << stringf("\n    ]");
+				newline(4);
+				emit(']');
 				first_model = false;
 			}
-			f << stringf("\n  }");
+			newline(2);
+			emit('}');
 		}
-		f << stringf("\n}\n");
+		newline(0);
+		emit("}\n");
+		flush();
 	}
 };
 
@@ -358,6 +611,14 @@ struct JsonBackend : public Backend {
 		log("    -noscopeinfo\n");
 		log("        don't include $scopeinfo cells in the output\n");
 		log("\n");
+		log("    -compact\n");
+		log("        don't emit any whitespace or line breaks. this makes the output\n");
+		log("        considerably smaller for large netlists\n");
+		log("\n");
+		log("    -hexinit\n");
+		log("        emit fully-defined INIT parameter values as strings of the form\n");
+		log("        <width>'h<hex digits>, which is understood by read_json\n");
+		log("\n");
 		log("\n");
 		log("The general syntax of the JSON output created by this command is as follows:\n");
 		log("\n");
@@ -469,8 +730,9 @@ struct JsonBackend : public Backend {
 		log("\"z\" instead of a number.\n");
 		log("\n");
 		log("Bit vectors (including integers) are written as string holding the binary\n");
-		log("representation of the value. Strings are written as strings, with an appended\n");
-		log("blank in cases of strings of the form /[01xz]* */.\n");
+		log("representation of the value, or with -hexinit the hexadecimal representation\n");
+		log("for INIT values. Strings are written as strings, with an appended blank in\n");
+		log("cases of strings of the form /[01xz]* */ or /[0-9]+'h[0-9a-fA-F]+/.\n");
 		log("\n");
 		log("For example the following Verilog code:\n");
 		log("\n");
@@ -604,6 +866,8 @@ struct JsonBackend : public Backend {
 		bool compat_int_mode = false;
 		bool use_selection = false;
 		bool scopeinfo_mode = true;
+		bool compact_mode = false;
+		bool hexinit_mode = false;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++)
@@ -624,13 +888,21 @@ struct JsonBackend : public Backend {
 				scopeinfo_mode = false;
 				continue;
 			}
+			if (args[argidx] == "-compact") {
+				compact_mode = true;
+				continue;
+			}
+			if (args[argidx] == "-hexinit") {
+				hexinit_mode = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
 
 		log_header(design, "Executing JSON backend.\n");
 
-		JsonWriter json_writer(*f, use_selection, aig_mode, compat_int_mode, scopeinfo_mode);
+		JsonWriter json_writer(*f, use_selection, aig_mode, compat_int_mode, scopeinfo_mode, compact_mode, hexinit_mode);
 		json_writer.write_design(design);
 	}
 } JsonBackend;
@@ -658,6 +930,14 @@ struct JsonPass : public Pass {
 		log("    -noscopeinfo\n");
 		log("        don't include $scopeinfo cells in the output\n");
 		log("\n");
+		log("    -compact\n");
+		log("        don't emit any whitespace or line breaks. this makes the output\n");
+		log("        considerably smaller for large netlists\n");
+		log("\n");
+		log("    -hexinit\n");
+		log("        emit fully-defined INIT parameter values as strings of the form\n");
+		log("        <width>'h<hex digits>, which is understood by read_json\n");
+		log("\n");
 		log("See 'help write_json' for a description of the JSON format used.\n");
 		log("\n");
 	}
@@ -667,6 +947,8 @@ struct JsonPass : public Pass {
 		bool aig_mode = false;
 		bool compat_int_mode = false;
 		bool scopeinfo_mode = true;
+		bool compact_mode = false;
+		bool hexinit_mode = false;
 
 		size_t argidx;
 		for (argidx = 1; argidx < args.size(); argidx++)
@@ -687,6 +969,14 @@ struct JsonPass : public Pass {
 				scopeinfo_mode = false;
 				continue;
 			}
+			if (args[argidx] == "-compact") {
+				compact_mode = true;
+				continue;
+			}
+			if (args[argidx] == "-hexinit") {
+				hexinit_mode = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
@@ -708,7 +998,7 @@ struct JsonPass : public Pass {
 			f = &buf;
 		}
 
-		JsonWriter json_writer(*f, true, aig_mode, compat_int_mode, scopeinfo_mode);
+		JsonWriter json_writer(*f, true, aig_mode, compat_int_mode, scopeinfo_mode, compact_mode, hexinit_mode);
 		json_writer.write_design(design);
 
 		if (!empty) {
@@ -34,7 +34,7 @@ struct Smt2Worker
 	CellTypes ct;
 	SigMap sigmap;
 	RTLIL::Module *module;
-	bool bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode;
+	bool bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode, compactmode;
 	dict<IdString, int> &mod_stbv_width;
 	int idcounter = 0, statebv_width = 0;
 
@@ -54,6 +54,9 @@ struct Smt2Worker
 	std::map<int, int> bvsizes;
 	dict<IdString, char*> ids;
 
+	dict<std::string, int> expr_ids;
+	pool<SigBit> live_bits;
+
 	bool is_smtlib2_module;
 
 	const char *get_id(IdString n)
@@ -115,9 +118,9 @@ struct Smt2Worker
 	}
 
 	Smt2Worker(RTLIL::Module *module, bool bvmode, bool memmode, bool wiresmode, bool verbose, bool statebv, bool statedt, bool forallmode,
-		   dict<IdString, int> &mod_stbv_width, dict<IdString, dict<IdString, pair<bool, bool>>> &mod_clk_cache)
+		   bool compactmode, dict<IdString, int> &mod_stbv_width, dict<IdString, dict<IdString, pair<bool, bool>>> &mod_clk_cache)
 	    : ct(module->design), sigmap(module), module(module), bvmode(bvmode), memmode(memmode), wiresmode(wiresmode), verbose(verbose),
-	      statebv(statebv), statedt(statedt), forallmode(forallmode), mod_stbv_width(mod_stbv_width),
+	      statebv(statebv), statedt(statedt), forallmode(forallmode), compactmode(compactmode), mod_stbv_width(mod_stbv_width),
 	      is_smtlib2_module(module->has_attribute(ID::smtlib2_module))
 	{
 		pool<SigBit> noclock;
@@ -303,7 +306,7 @@ struct Smt2Worker
 		log_assert(bvmode);
 		sigmap.apply(sig);
 
-		log_assert(bvsizes.count(id) == 0);
+		log_assert(bvsizes.count(id) == 0 || bvsizes.at(id) == GetSize(sig));
 		bvsizes[id] = GetSize(sig);
 
 		for (int i = 0; i < GetSize(sig); i++) {
@@ -432,6 +435,26 @@ struct Smt2Worker
 		}
 	}
 
+	// Creates a '<mod>#<id>' function with the given sort and body and returns its id. In compact mode a
+	// body that was already exported with the same sort reuses the existing function instead.
+	int export_expr(const std::string &sort, const std::string &expr, const std::string &comment)
+	{
+		if (compactmode) {
+			std::string key = sort + " " + expr;
+			auto it = expr_ids.find(key);
+			if (it != expr_ids.end()) {
+				if (verbose) log("%*s-> shared expression: %s#%d\n", 2+2*GetSize(recursive_cells), "",
+						get_id(module), it->second);
+				return it->second;
+			}
+			expr_ids[key] = idcounter;
+		}
+
+		decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) %s %s) ; %s\n",
+				get_id(module), idcounter, get_id(module), sort.c_str(), expr.c_str(), comment.c_str()));
+		return idcounter++;
+	}
+
 	void export_gate(RTLIL::Cell *cell, std::string expr)
 	{
 		RTLIL::SigBit bit = sigmap(cell->getPort(ID::Y).as_bit());
@@ -449,9 +472,7 @@ struct Smt2Worker
 		if (verbose)
 			log("%*s-> import cell: %s\n", 2+2*GetSize(recursive_cells), "", log_id(cell));
 
-		decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) Bool %s) ; %s\n",
-				get_id(module), idcounter, get_id(module), processed_expr.c_str(), log_signal(bit)));
-		register_bool(bit, idcounter++);
+		register_bool(bit, export_expr("Bool", processed_expr, log_signal(bit)));
 		recursive_cells.erase(cell);
 	}
 
@@ -499,15 +520,10 @@ struct Smt2Worker
 		if (verbose)
 			log("%*s-> import cell: %s\n", 2+2*GetSize(recursive_cells), "", log_id(cell));
 
-		if (type == 'b') {
-			decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) Bool %s) ; %s\n",
-					get_id(module), idcounter, get_id(module), processed_expr.c_str(), log_signal(sig_y)));
-			register_boolvec(sig_y, idcounter++);
-		} else {
-			decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) (_ BitVec %d) %s) ; %s\n",
-					get_id(module), idcounter, get_id(module), GetSize(sig_y), processed_expr.c_str(), log_signal(sig_y)));
-			register_bv(sig_y, idcounter++);
-		}
+		if (type == 'b')
+			register_boolvec(sig_y, export_expr("Bool", processed_expr, log_signal(sig_y)));
+		else
+			register_bv(sig_y, export_expr(stringf("(_ BitVec %d)", GetSize(sig_y)), processed_expr, log_signal(sig_y)));
 
 		recursive_cells.erase(cell);
 	}
@@ -530,9 +546,7 @@ struct Smt2Worker
 		if (verbose)
 			log("%*s-> import cell: %s\n", 2+2*GetSize(recursive_cells), "", log_id(cell));
 
-		decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) Bool %s) ; %s\n",
-				get_id(module), idcounter, get_id(module), processed_expr.c_str(), log_signal(sig_y)));
-		register_boolvec(sig_y, idcounter++);
+		register_boolvec(sig_y, export_expr("Bool", processed_expr, log_signal(sig_y)));
 		recursive_cells.erase(cell);
 	}
 
@@ -752,9 +766,7 @@ struct Smt2Worker
 					log("%*s-> import cell: %s\n", 2+2*GetSize(recursive_cells), "", log_id(cell));
 
 				RTLIL::SigSpec sig = sigmap(cell->getPort(ID::Y));
-				decls.push_back(stringf("(define-fun |%s#%d| ((state |%s_s|)) (_ BitVec %d) %s) ; %s\n",
-						get_id(module), idcounter, get_id(module), width, processed_expr.c_str(), log_signal(sig)));
-				register_bv(sig, idcounter++);
+				register_bv(sig, export_expr(stringf("(_ BitVec %d)", width), processed_expr, log_signal(sig)));
 				recursive_cells.erase(cell);
 				return;
 			}
@@ -953,6 +965,56 @@ struct Smt2Worker
 					  log_id(wire));
 	}
 
+	// Collects the signals that can affect a port, a kept wire, a property, a memory, or a submodule. Only the
+	// registers among them are part of the state in compact mode.
+	void find_live_bits()
+	{
+		std::vector<SigBit> queue;
+		pool<Cell*> visited;
+
+		auto add_sig = [&](const SigSpec &sig) {
+			for (auto bit : sigmap(sig))
+				if (bit.wire != nullptr && live_bits.insert(bit).second)
+					queue.push_back(bit);
+		};
+
+		for (auto wire : module->wires())
+			if (wire->port_id || wire->get_bool_attribute(ID::keep) || (wiresmode && wire->name.isPublic()))
+				add_sig(wire);
+
+		for (auto &mem : memories) {
+			for (auto &port : mem.wr_ports) {
+				add_sig(port.addr);
+				add_sig(port.data);
+				add_sig(port.en);
+			}
+			for (auto &port : mem.rd_ports) {
+				add_sig(port.addr);
+				add_sig(port.en);
+			}
+		}
+
+		for (auto cell : module->cells()) {
+			if (cell->is_mem_cell() || cell->has_keep_attr() || module->design->module(cell->type) != nullptr ||
+					!ct.cell_known(cell->type) || cell->type.in(ID($assert), ID($assume), ID($cover), ID($live), ID($fair))) {
+				visited.insert(cell);
+				for (auto &conn : cell->connections())
+					add_sig(conn.second);
+			}
+		}
+
+		while (!queue.empty()) {
+			SigBit bit = queue.back();
+			queue.pop_back();
+			auto it = bit_driver.find(bit);
+			if (it == bit_driver.end() || !visited.insert(it->second).second)
+				continue;
+			for (auto &conn : it->second->connections())
+				if (ct.cell_input(it->second->type, conn.first))
+					add_sig(conn.second);
+		}
+	}
+
 	void run()
 	{
 		if (verbose) log("=> export logic driving outputs\n");
@@ -960,12 +1022,16 @@ struct Smt2Worker
 		if (is_smtlib2_module)
 			verify_smtlib2_module();
 
+		if (compactmode)
+			find_live_bits();
+
 		pool<SigBit> reg_bits;
 		for (auto cell : module->cells())
 			if (cell->type.in(ID($ff), ID($dff), ID($_FF_), ID($_DFF_P_), ID($_DFF_N_), ID($anyinit))) {
 				// not using sigmap -- we want the net directly at the dff output
 				for (auto bit : cell->getPort(ID::Q))
-					reg_bits.insert(bit);
+					if (!compactmode || live_bits.count(sigmap(bit)))
+						reg_bits.insert(bit);
 			}
 
 		std::string smtlib2_inputs;
@@ -1077,6 +1143,13 @@ struct Smt2Worker
 						  log_id(module), log_id(wire));
 
 				RTLIL::SigSpec sig = sigmap(wire);
+				if (compactmode) {
+					bool live = false;
+					for (auto bit : sig)
+						live = live || live_bits.count(bit);
+					if (!live)
+						continue;
+				}
 				Const val = wire->attributes.at(ID::init);
 				val.bits().resize(GetSize(sig), State::Sx);
 				if (bvmode && GetSize(sig) > 1) {
@@ -1698,6 +1771,13 @@ struct Smt2Backend : public Backend {
 		log("        create '<mod>_n' functions for all public wires. by default only ports,\n");
 		log("        registers, and wires with the 'keep' attribute are exported.\n");
 		log("\n");
+		log("    -compact\n");
+		log("        reduce the size of the model that has to be unrolled for each step.\n");
+		log("        cells that compute the same expression from the same arguments share\n");
+		log("        a single '<mod>#<id>' function, and registers that can not affect any\n");
+		log("        port, assertion, assumption, cover, memory, or kept wire are left out\n");
+		log("        of the state (and thus do not appear in traces either).\n");
+		log("\n");
 		log("    -tpl <template_file>\n");
 		log("        use the given template file. the line containing only the token '%%%%'\n");
 		log("        is replaced with the regular output of this command.\n");
@@ -1759,7 +1839,7 @@ struct Smt2Backend : public Backend {
 	{
 		std::ifstream template_f;
 		bool bvmode = true, memmode = true, wiresmode = false, verbose = false, statebv = false, statedt = false;
-		bool forallmode = false;
+		bool forallmode = false, compactmode = false;
 		dict<std::string, std::string> solver_options;
 
 		log_header(design, "Executing SMT2 backend.\n");
@@ -1805,6 +1885,10 @@ struct Smt2Backend : public Backend {
 				wiresmode = true;
 				continue;
 			}
+			if (args[argidx] == "-compact") {
+				compactmode = true;
+				continue;
+			}
 			if (args[argidx] == "-verbose") {
 				verbose = true;
 				continue;
@@ -1903,7 +1987,7 @@ struct Smt2Backend : public Backend {
 
 			log("Creating SMT-LIBv2 representation of module %s.\n", log_id(module));
 
-			Smt2Worker worker(module, bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode, mod_stbv_width, mod_clk_cache);
+			Smt2Worker worker(module, bvmode, memmode, wiresmode, verbose, statebv, statedt, forallmode, compactmode, mod_stbv_width, mod_clk_cache);
 			worker.run();
 			worker.write(*f);
 
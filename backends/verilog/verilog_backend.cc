@@ -33,12 +33,20 @@
 #include <set>
 #include <map>
 
+#if !defined(YOSYS_DISABLE_SPAWN) && !defined(_WIN32)
+#  include <errno.h>
+#  include <poll.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
 bool verbose, norename, noattr, attr2comment, noexpr, nodec, nohex, nostr, extmem, defparam, decimal, siminit, systemverilog, simple_lhs, noparallelcase;
 int auto_name_counter, auto_name_offset, auto_name_digits, extmem_counter;
 dict<RTLIL::IdString, int> auto_name_map;
+dict<RTLIL::IdString, std::string> auto_name_ids, escaped_ids;
 std::set<RTLIL::IdString> reg_wires;
 std::string auto_prefix, extmem_prefix;
 
@@ -46,6 +54,7 @@ RTLIL::Module *active_module;
 dict<RTLIL::SigBit, RTLIL::State> active_initdata;
 SigMap active_sigmap;
 IdString initial_id;
+dict<RTLIL::Module*, IdString> initial_ids;
 
 void reset_auto_counter_id(RTLIL::IdString id, bool may_rename)
 {
@@ -72,6 +81,7 @@ void reset_auto_counter_id(RTLIL::IdString id, bool may_rename)
 void reset_auto_counter(RTLIL::Module *module)
 {
 	auto_name_map.clear();
+	auto_name_ids.clear();
 	auto_name_counter = 0;
 	auto_name_offset = 0;
 
@@ -92,9 +102,12 @@ void reset_auto_counter(RTLIL::Module *module)
 	for (size_t i = 10; i < auto_name_offset + auto_name_map.size(); i = i*10)
 		auto_name_digits++;
 
+	for (auto &it : auto_name_map)
+		auto_name_ids[it.first] = stringf("%s_%0*d_", auto_prefix.c_str(), auto_name_digits, auto_name_offset + it.second);
+
 	if (verbose)
 		for (auto it = auto_name_map.begin(); it != auto_name_map.end(); ++it)
-			log("  renaming `%s' to `%s_%0*d_'.\n", it->first.c_str(), auto_prefix.c_str(), auto_name_digits, auto_name_offset + it->second);
+			log("  renaming `%s' to `%s'.\n", it->first.c_str(), auto_name_ids.at(it->first).c_str());
 }
 
 std::string next_auto_id()
@@ -104,12 +117,21 @@ std::string next_auto_id()
 
 std::string id(RTLIL::IdString internal_id, bool may_rename = true)
 {
+	if (may_rename) {
+		auto it = auto_name_ids.find(internal_id);
+		if (it != auto_name_ids.end())
+			return it->second;
+	}
+
+	// Escaping only depends on the name, so it is done once per name and
+	// write_verilog call.
+	auto it = escaped_ids.find(internal_id);
+	if (it != escaped_ids.end())
+		return it->second;
+
 	const char *str = internal_id.c_str();
 	bool do_escape = false;
 
-	if (may_rename && auto_name_map.count(internal_id) != 0)
-		return stringf("%s_%0*d_", auto_prefix.c_str(), auto_name_digits, auto_name_offset + auto_name_map[internal_id]);
-
 	if (*str == '\\')
 		str++;
 
@@ -158,8 +180,8 @@ std::string id(RTLIL::IdString internal_id, bool may_rename = true)
 		do_escape = true;
 
 	if (do_escape)
-		return "\\" + std::string(str) + " ";
-	return std::string(str);
+		return escaped_ids[internal_id] = "\\" + std::string(str) + " ";
+	return escaped_ids[internal_id] = std::string(str);
 }
 
 bool is_reg_wire(RTLIL::SigSpec sig, std::string &reg_name)
@@ -336,22 +358,23 @@ void dump_sigchunk(std::ostream &f, const RTLIL::SigChunk &chunk, bool no_decima
 	if (chunk.wire == NULL) {
 		dump_const(f, chunk.data, chunk.width, chunk.offset, no_decimal);
 	} else {
+		// This is the innermost loop of writing a netlist, so stream the
+		// pieces directly instead of going through stringf().
+		f << id(chunk.wire->name);
 		if (chunk.width == chunk.wire->width && chunk.offset == 0) {
-			f << stringf("%s", id(chunk.wire->name).c_str());
+			// whole wire
 		} else if (chunk.width == 1) {
 			if (chunk.wire->upto)
-				f << stringf("%s[%d]", id(chunk.wire->name).c_str(), (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset);
+				f << '[' << (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset << ']';
 			else
-				f << stringf("%s[%d]", id(chunk.wire->name).c_str(), chunk.offset + chunk.wire->start_offset);
+				f << '[' << chunk.offset + chunk.wire->start_offset << ']';
 		} else {
 			if (chunk.wire->upto)
-				f << stringf("%s[%d:%d]", id(chunk.wire->name).c_str(),
-						(chunk.wire->width - (chunk.offset + chunk.width - 1) - 1) + chunk.wire->start_offset,
-						(chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset);
+				f << '[' << (chunk.wire->width - (chunk.offset + chunk.width - 1) - 1) + chunk.wire->start_offset
+						<< ':' << (chunk.wire->width - chunk.offset - 1) + chunk.wire->start_offset << ']';
 			else
-				f << stringf("%s[%d:%d]", id(chunk.wire->name).c_str(),
-						(chunk.offset + chunk.width - 1) + chunk.wire->start_offset,
-						chunk.offset + chunk.wire->start_offset);
+				f << '[' << (chunk.offset + chunk.width - 1) + chunk.wire->start_offset
+						<< ':' << chunk.offset + chunk.wire->start_offset << ']';
 		}
 	}
 }
@@ -366,13 +389,13 @@ void dump_sigspec(std::ostream &f, const RTLIL::SigSpec &sig)
 	if (sig.is_chunk()) {
 		dump_sigchunk(f, sig.as_chunk());
 	} else {
-		f << stringf("{ ");
+		f << "{ ";
 		for (auto it = sig.chunks().rbegin(); it != sig.chunks().rend(); ++it) {
 			if (it != sig.chunks().rbegin())
-				f << stringf(", ");
+				f << ", ";
 			dump_sigchunk(f, *it, true);
 		}
-		f << stringf(" }");
+		f << " }";
 	}
 }
 
@@ -1917,8 +1940,12 @@ void dump_cell(std::ostream &f, std::string indent, RTLIL::Cell *cell)
 		f << stringf(" %s (", cell_name.c_str());
 
 	bool first_arg = true;
+	bool has_numbered_ports = false;
+	for (auto &it : cell->connections())
+		if (it.first[0] == '$')
+			has_numbered_ports = true;
 	std::set<RTLIL::IdString> numbered_ports;
-	for (int i = 1; true; i++) {
+	for (int i = 1; has_numbered_ports; i++) {
 		char str[16];
 		snprintf(str, 16, "$%d", i);
 		for (auto it = cell->connections().begin(); it != cell->connections().end(); ++it) {
@@ -1939,14 +1966,14 @@ void dump_cell(std::ostream &f, std::string indent, RTLIL::Cell *cell)
 		if (numbered_ports.count(it->first))
 			continue;
 		if (!first_arg)
-			f << stringf(",");
+			f << ',';
 		first_arg = false;
-		f << stringf("\n%s  .%s(", indent.c_str(), id(it->first).c_str());
+		f << '\n' << indent << "  ." << id(it->first) << '(';
 		if (it->second.size() > 0)
 			dump_sigspec(f, it->second);
-		f << stringf(")");
+		f << ')';
 	}
-	f << stringf("\n%s" ");\n", indent.c_str());
+	f << '\n' << indent << ");\n";
 
 	if (defparam && cell->parameters.size() > 0) {
 		for (auto it = cell->parameters.begin(); it != cell->parameters.end(); ++it) {
@@ -2290,23 +2317,13 @@ void dump_module(std::ostream &f, std::string indent, RTLIL::Module *module)
 					active_initdata[sig[i]] = val[i];
 		}
 
-	bool has_sync_rules = false;
-	for (auto process : module->processes)
-		if (!process.second->syncs.empty())
-			has_sync_rules = true;
-	if (has_sync_rules)
-		log_warning("Module %s contains RTLIL processes with sync rules. Such RTLIL "
-				"processes can't always be mapped directly to Verilog always blocks. "
-				"unintended changes in simulation behavior are possible! Use \"proc\" "
-				"to convert processes to logic networks and registers.\n", log_id(module));
-
 	f << stringf("\n");
 	for (auto it = module->processes.begin(); it != module->processes.end(); ++it)
 		dump_process(f, indent + "  ", it->second, true);
 
 	if (!noexpr)
 	{
-		std::set<std::pair<RTLIL::Wire*,int>> reg_bits;
+		pool<std::pair<RTLIL::Wire*,int>> reg_bits;
 		for (auto cell : module->cells())
 		{
 			if (cell->type.in(ID($print), ID($check)) && cell->getParam(ID::TRG_ENABLE).as_bool()) {
@@ -2352,7 +2369,7 @@ void dump_module(std::ostream &f, std::string indent, RTLIL::Module *module)
 	}
 	f << stringf(");\n");
 	if (!systemverilog && !module->processes.empty()) {
-		initial_id = NEW_ID;
+		initial_id = initial_ids.at(module);
 		f << indent + "  " << "reg " << id(initial_id) << " = 0;\n";
 	}
 
@@ -2380,6 +2397,178 @@ void dump_module(std::ostream &f, std::string indent, RTLIL::Module *module)
 	active_initdata.clear();
 }
 
+// Everything in dump_module() that logs or creates new objects in the design
+// is done here, in module order, so that the modules can then be rendered in
+// any order.
+void prepare_module(RTLIL::Module *module)
+{
+	bool has_sync_rules = false;
+	for (auto process : module->processes)
+		if (!process.second->syncs.empty())
+			has_sync_rules = true;
+	if (has_sync_rules)
+		log_warning("Module %s contains RTLIL processes with sync rules. Such RTLIL "
+				"processes can't always be mapped directly to Verilog always blocks. "
+				"unintended changes in simulation behavior are possible! Use \"proc\" "
+				"to convert processes to logic networks and registers.\n", log_id(module));
+
+	if (!systemverilog && !module->processes.empty())
+		initial_ids[module] = NEW_ID;
+}
+
+#if !defined(YOSYS_DISABLE_SPAWN) && !defined(_WIN32)
+static bool write_all(int fd, const char *data, size_t size)
+{
+	while (size > 0) {
+		ssize_t n = write(fd, data, size);
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+		data += n;
+		size -= n;
+	}
+	return true;
+}
+
+// Renders the modules in `jobs' worker processes, worker k taking every
+// jobs-th module starting at k, and returns the text of each module in
+// `texts'. Forked workers get a private copy of the design, so the IdString
+// reference counts (which are not thread-safe) are never shared. Each module
+// is sent back as a length-prefixed record. Returns false if a worker could
+// not be started or did not send all of its modules; the caller then renders
+// the modules itself, which also reports any error a worker ran into.
+bool dump_modules_forked(const std::vector<RTLIL::Module*> &modules, int jobs, std::vector<std::string> &texts)
+{
+	log_flush();
+
+	std::vector<pid_t> pids;
+	std::vector<int> fds;
+	bool ok = true;
+
+	for (int k = 0; k < jobs; k++)
+	{
+		int pipefd[2];
+		if (pipe(pipefd) < 0) {
+			ok = false;
+			break;
+		}
+
+		pid_t pid = fork();
+		if (pid < 0) {
+			close(pipefd[0]);
+			close(pipefd[1]);
+			ok = false;
+			break;
+		}
+
+		if (pid == 0) {
+			close(pipefd[0]);
+			log_files.clear();
+			log_streams.clear();
+			log_errfile = nullptr;
+			log_error_atexit = nullptr;
+			try {
+				for (int i = k; i < GetSize(modules); i += jobs) {
+					std::ostringstream buf;
+					dump_module(buf, "", modules[i]);
+					std::string text = buf.str();
+					uint64_t size = text.size();
+					if (!write_all(pipefd[1], (const char*)&size, sizeof(size)) ||
+							!write_all(pipefd[1], text.data(), text.size()))
+						_exit(1);
+				}
+			} catch (...) {
+				_exit(1);
+			}
+			_exit(0);
+		}
+
+		close(pipefd[1]);
+		pids.push_back(pid);
+		fds.push_back(pipefd[0]);
+	}
+
+	// All pipes are drained together, a worker blocks once its pipe is full.
+	std::vector<std::string> streams(fds.size());
+	std::vector<struct pollfd> pfds;
+	for (int fd : fds) {
+		struct pollfd pfd;
+		pfd.fd = fd;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		pfds.push_back(pfd);
+	}
+
+	int open_fds = GetSize(pfds);
+	char buffer[65536];
+	while (open_fds > 0)
+	{
+		int ret = poll(pfds.data(), pfds.size(), -1);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret < 0) {
+			ok = false;
+			break;
+		}
+		for (int k = 0; k < GetSize(pfds); k++) {
+			if (pfds[k].fd < 0 || pfds[k].revents == 0)
+				continue;
+			ssize_t n = read(pfds[k].fd, buffer, sizeof(buffer));
+			if (n < 0 && errno == EINTR)
+				continue;
+			if (n > 0) {
+				streams[k].append(buffer, n);
+				continue;
+			}
+			if (n < 0)
+				ok = false;
+			close(pfds[k].fd);
+			pfds[k].fd = -1;
+			open_fds--;
+		}
+	}
+	for (auto &pfd : pfds)
+		if (pfd.fd >= 0)
+			close(pfd.fd);
+
+	for (pid_t pid : pids) {
+		int status;
+		while (waitpid(pid, &status, 0) < 0)
+			if (errno != EINTR) {
+				status = -1;
+				break;
+			}
+		if (status != 0)
+			ok = false;
+	}
+
+	if (!ok || GetSize(pids) != jobs)
+		return false;
+
+	texts.clear();
+	texts.resize(modules.size());
+	for (int k = 0; k < jobs; k++) {
+		const std::string &stream = streams[k];
+		size_t pos = 0;
+		for (int i = k; i < GetSize(modules); i += jobs) {
+			uint64_t size;
+			if (stream.size() - pos < sizeof(size))
+				return false;
+			memcpy(&size, stream.data() + pos, sizeof(size));
+			pos += sizeof(size);
+			if (stream.size() - pos < size)
+				return false;
+			texts[i] = stream.substr(pos, size);
+			pos += size;
+		}
+		if (pos != stream.size())
+			return false;
+	}
+	return true;
+}
+#endif
+
 struct VerilogBackend : public Backend {
 	VerilogBackend() : Backend("verilog", "write design to Verilog file") { }
 	void help() override
@@ -2467,6 +2656,12 @@ struct VerilogBackend : public Backend {
 		log("    -v\n");
 		log("        verbose output (print new names of all renamed wires and cells)\n");
 		log("\n");
+		log("    -j <num>\n");
+		log("        render up to <num> modules at the same time, each in a separate\n");
+		log("        worker process. The modules are still written in the usual order\n");
+		log("        and the output is the same as without this option. Ignored\n");
+		log("        together with -v or -extmem, and on platforms without fork().\n");
+		log("\n");
 		log("Note that RTLIL processes can't always be mapped directly to Verilog\n");
 		log("always blocks. This frontend should only be used to export an RTLIL\n");
 		log("netlist, i.e. after the \"proc\" pass has been used to convert all\n");
@@ -2496,8 +2691,11 @@ struct VerilogBackend : public Backend {
 
 		bool blackboxes = false;
 		bool selected = false;
+		int jobs = 1;
 
 		auto_name_map.clear();
+		auto_name_ids.clear();
+		escaped_ids.clear();
 		reg_wires.clear();
 
 		size_t argidx;
@@ -2576,6 +2774,10 @@ struct VerilogBackend : public Backend {
 				verbose = true;
 				continue;
 			}
+			if (arg == "-j" && argidx+1 < args.size()) {
+				jobs = std::max(atoi(args[++argidx].c_str()), 1);
+				continue;
+			}
 			break;
 		}
 		extra_args(f, filename, args, argidx);
@@ -2596,7 +2798,7 @@ struct VerilogBackend : public Backend {
 
 		design->sort();
 
-		*f << stringf("/* Generated by %s */\n", yosys_version_str);
+		std::vector<RTLIL::Module*> modules;
 		for (auto module : design->modules()) {
 			if (module->get_blackbox_attribute() != blackboxes)
 				continue;
@@ -2606,11 +2808,34 @@ struct VerilogBackend : public Backend {
 				continue;
 			}
 			log("Dumping module `%s'.\n", module->name.c_str());
-			dump_module(*f, "", module);
+			prepare_module(module);
+			modules.push_back(module);
 		}
 
+		*f << stringf("/* Generated by %s */\n", yosys_version_str);
+
+		bool dumped = false;
+#if !defined(YOSYS_DISABLE_SPAWN) && !defined(_WIN32)
+		jobs = std::min(jobs, GetSize(modules));
+		if (jobs > 1 && !verbose && !extmem) {
+			std::vector<std::string> texts;
+			if (dump_modules_forked(modules, jobs, texts)) {
+				for (auto &text : texts)
+					*f << text;
+				dumped = true;
+			} else
+				log("Rendering modules in worker processes failed, writing them one by one.\n");
+		}
+#endif
+		if (!dumped)
+			for (auto module : modules)
+				dump_module(*f, "", module);
+
 		auto_name_map.clear();
+		auto_name_ids.clear();
+		escaped_ids.clear();
 		reg_wires.clear();
+		initial_ids.clear();
 	}
 } VerilogBackend;
 
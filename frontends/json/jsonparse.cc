@@ -19,8 +19,146 @@
 
 #include "kernel/yosys.h"
 
+#if !defined(_WIN32) && !defined(__wasm)
+#  define JSON_USE_MMAP
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
 YOSYS_NAMESPACE_BEGIN
 
+struct JsonNode;
+
+// Input for the JSON frontend. Plain files are memory-mapped, everything else
+// (stdin, here documents, decompressed gzip data) is read into a buffer. The
+// importer only keeps pointers into this buffer and parses one port, net, cell
+// or memory at a time, so no JsonNode tree for the whole file is ever built.
+struct JsonReader
+{
+	const char *pos = nullptr, *end = nullptr;
+	std::string data;
+#ifdef JSON_USE_MMAP
+	void *mapped = nullptr;
+	size_t mapped_size = 0;
+#endif
+
+	JsonReader(std::istream *f, const std::string &filename)
+	{
+#ifdef JSON_USE_MMAP
+		if (dynamic_cast<std::ifstream*>(f) != nullptr) {
+			int fd = open(filename.c_str(), O_RDONLY);
+			struct stat st;
+			if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+				void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+				if (p != MAP_FAILED) {
+					mapped = p;
+					mapped_size = st.st_size;
+					pos = static_cast<const char*>(p);
+					end = pos + mapped_size;
+				}
+			}
+			if (fd >= 0)
+				close(fd);
+			if (mapped != nullptr)
+				return;
+		}
+#endif
+		data.assign(std::istreambuf_iterator<char>(*f), std::istreambuf_iterator<char>());
+		pos = data.data();
+		end = pos + data.size();
+	}
+
+	~JsonReader()
+	{
+#ifdef JSON_USE_MMAP
+		if (mapped != nullptr)
+			munmap(mapped, mapped_size);
+#endif
+	}
+
+	int get()
+	{
+		return pos == end ? EOF : (unsigned char)*pos++;
+	}
+
+	void unget()
+	{
+		pos--;
+	}
+
+	// Skips whitespace and the given separator characters.
+	void skip(const char *separators)
+	{
+		while (pos != end && (*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n' || strchr(separators, *pos) != nullptr))
+			pos++;
+	}
+
+	void skip_string()
+	{
+		while (1) {
+			int ch = get();
+			if (ch == EOF)
+				log_error("Unexpected EOF in JSON string.\n");
+			if (ch == '"')
+				break;
+			if (ch == '\\' && get() == EOF)
+				log_error("Unexpected EOF in JSON string.\n");
+		}
+	}
+
+	// Moves past the next value without building a JsonNode for it.
+	void skip_value()
+	{
+		int depth = 0;
+		skip("");
+		do {
+			int ch = get();
+			if (ch == EOF)
+				log_error("Unexpected EOF in JSON file.\n");
+			if (ch == '"')
+				skip_string();
+			else if (ch == '[' || ch == '{')
+				depth++;
+			else if (ch == ']' || ch == '}')
+				depth--;
+			else if (('0' <= ch && ch <= '9') || ch == '-') {
+				while (pos != end && (('0' <= *pos && *pos <= '9') || *pos == '.'))
+					pos++;
+			} else if (depth == 0 || !(ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == ',' || ch == ':'))
+				log_error("Unexpected character in JSON file: '%c'\n", ch);
+		} while (depth > 0);
+	}
+
+	// Returns the position of every key in the dictionary starting at 'value'.
+	std::vector<const char*> dict_entries(const char *value, const char *what)
+	{
+		std::vector<const char*> entries;
+		pos = value;
+		skip("");
+		if (get() != '{')
+			log_error("JSON %s node is not a dictionary.\n", what);
+		while (1) {
+			skip(",");
+			if (pos == end)
+				log_error("Unexpected EOF in JSON file.\n");
+			if (*pos == '}')
+				break;
+			if (*pos != '"')
+				log_error("Unexpected non-string key in JSON dict.\n");
+			entries.push_back(pos++);
+			skip_string();
+			skip(":");
+			skip_value();
+		}
+		return entries;
+	}
+
+	// Reads the key of the entry at 'entry' and returns the position of its value.
+	const char *entry_value(const char *entry, string &key);
+};
+
 struct JsonNode
 {
 	char type; // S=String, N=Number, A=Array, D=Dict
@@ -30,7 +168,7 @@ struct JsonNode
 	dict<string, JsonNode*> data_dict;
 	vector<string> data_dict_keys;
 
-	JsonNode(std::istream &f)
+	JsonNode(JsonReader &f)
 	{
 		type = 0;
 		data_number = 0;
@@ -242,16 +380,56 @@ struct JsonNode
 	}
 };
 
-Const json_parse_attr_param_value(JsonNode *node)
+const char *JsonReader::entry_value(const char *entry, string &key)
+{
+	pos = entry;
+	JsonNode key_node(*this);
+	key = std::move(key_node.data_string);
+	skip(":");
+	return pos;
+}
+
+// INIT values of the form <width>'h<hex digits>, as written by "write_json -hexinit". The writer emits exactly as
+// many digits as the width needs, which is required here too, so that the width is bounded by the string length.
+bool json_parse_hex_const(const string &s, Const &value)
+{
+	size_t cursor = s.find_first_not_of("0123456789");
+	if (cursor == 0 || cursor == string::npos || cursor > 9 || s.compare(cursor, 2, "'h") != 0)
+		return false;
+	if (cursor + 2 == s.size() || s.find_first_not_of("0123456789abcdefABCDEF", cursor + 2) != string::npos)
+		return false;
+
+	int width = atoi(s.c_str());
+	int digits = GetSize(s) - cursor - 2;
+	if (width == 0 || (width + 3) / 4 != digits)
+		return false;
+
+	std::vector<RTLIL::State> bits;
+	bits.reserve(width);
+	for (size_t i = s.size(); i > cursor + 2 && GetSize(bits) < width; i--) {
+		char c = s[i - 1];
+		int digit = c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10;
+		for (int j = 0; j < 4 && GetSize(bits) < width; j++)
+			bits.push_back((digit >> j) & 1 ? State::S1 : State::S0);
+	}
+	value = Const(bits);
+	return true;
+}
+
+Const json_parse_attr_param_value(JsonNode *node, bool hex_init = false)
 {
 	Const value;
 
 	if (node->type == 'S') {
 		string &s = node->data_string;
 		size_t cursor = s.find_first_not_of("01xz");
+		Const hex_value;
 		if (cursor == string::npos) {
 			value = Const::from_string(s);
-		} else if (s.find_first_not_of(' ', cursor) == string::npos) {
+		} else if (hex_init && json_parse_hex_const(s, hex_value)) {
+			value = hex_value;
+		} else if (s.find_first_not_of(' ', cursor) == string::npos ||
+				(hex_init && s.back() == ' ' && json_parse_hex_const(s.substr(0, GetSize(s)-1), hex_value))) {
 			value = Const(s.substr(0, GetSize(s)-1));
 		} else {
 			value = Const(s);
@@ -282,12 +460,12 @@ void json_parse_attr_param(dict<IdString, Const> &results, JsonNode *node)
 	for (auto it : node->data_dict)
 	{
 		IdString key = RTLIL::escape_id(it.first.c_str());
-		Const value = json_parse_attr_param_value(it.second);
+		Const value = json_parse_attr_param_value(it.second, key == ID::INIT);
 		results[key] = value;
 	}
 }
 
-void json_import(Design *design, string &modname, JsonNode *node)
+void json_import(Design *design, string &modname, JsonReader &f, const char *module_value)
 {
 	log("Importing module %s from JSON tree.\n", modname.c_str());
 
@@ -299,22 +477,44 @@ void json_import(Design *design, string &modname, JsonNode *node)
 
 	design->add(module);
 
-	if (node->data_dict.count("attributes"))
-		json_parse_attr_param(module->attributes, node->data_dict.at("attributes"));
+	// Sections are processed in a fixed order (ports, netnames, cells,
+	// memories), whatever their order in the file, so only remember where
+	// each one starts.
+	const char *attributes_value = nullptr, *ports_value = nullptr, *netnames_value = nullptr;
+	const char *cells_value = nullptr, *memories_value = nullptr;
+	string key;
+
+	for (auto entry : f.dict_entries(module_value, "module")) {
+		const char *value = f.entry_value(entry, key);
+		if (key == "attributes")
+			attributes_value = value;
+		else if (key == "ports")
+			ports_value = value;
+		else if (key == "netnames")
+			netnames_value = value;
+		else if (key == "cells")
+			cells_value = value;
+		else if (key == "memories")
+			memories_value = value;
+	}
+
+	if (attributes_value) {
+		f.pos = attributes_value;
+		JsonNode attributes_node(f);
+		json_parse_attr_param(module->attributes, &attributes_node);
+	}
 
 	dict<int, SigBit> signal_bits;
 
-	if (node->data_dict.count("ports"))
+	if (ports_value)
 	{
-		JsonNode *ports_node = node->data_dict.at("ports");
+		std::vector<const char*> entries = f.dict_entries(ports_value, "ports");
 
-		if (ports_node->type != 'D')
-			log_error("JSON ports node is not a dictionary.\n");
-
-		for (int port_id = 1; port_id <= GetSize(ports_node->data_dict_keys); port_id++)
+		for (int port_id = 1; port_id <= GetSize(entries); port_id++)
 		{
-			IdString port_name = RTLIL::escape_id(ports_node->data_dict_keys[port_id-1].c_str());
-			JsonNode *port_node = ports_node->data_dict.at(ports_node->data_dict_keys[port_id-1]);
+			f.pos = f.entry_value(entries[port_id-1], key);
+			IdString port_name = RTLIL::escape_id(key.c_str());
+			std::unique_ptr<JsonNode> port_node(new JsonNode(f));
 
 			if (port_node->type != 'D')
 				log_error("JSON port node '%s' is not a dictionary.\n", log_id(port_name));
@@ -409,17 +609,19 @@ void json_import(Design *design, string &modname, JsonNode *node)
 		module->fixup_ports();
 	}
 
-	if (node->data_dict.count("netnames"))
-	{
-		JsonNode *netnames_node = node->data_dict.at("netnames");
+	// Entries of the netnames, cells and memories sections are visited last
+	// to first, the iteration order of the dict<> they used to be read into,
+	// which decides the representative wire of each bit and the cell order.
 
-		if (netnames_node->type != 'D')
-			log_error("JSON netnames node is not a dictionary.\n");
+	if (netnames_value)
+	{
+		std::vector<const char*> entries = f.dict_entries(netnames_value, "netnames");
 
-		for (auto &net : netnames_node->data_dict)
+		for (auto it = entries.rbegin(); it != entries.rend(); ++it)
 		{
-			IdString net_name = RTLIL::escape_id(net.first.c_str());
-			JsonNode *net_node = net.second;
+			f.pos = f.entry_value(*it, key);
+			IdString net_name = RTLIL::escape_id(key.c_str());
+			std::unique_ptr<JsonNode> net_node(new JsonNode(f));
 
 			if (net_node->type != 'D')
 				log_error("JSON netname node '%s' is not a dictionary.\n", log_id(net_name));
@@ -484,17 +686,20 @@ void json_import(Design *design, string &modname, JsonNode *node)
 		}
 	}
 
-	if (node->data_dict.count("cells"))
+	if (cells_value)
 	{
-		JsonNode *cells_node = node->data_dict.at("cells");
-
-		if (cells_node->type != 'D')
-			log_error("JSON cells node is not a dictionary.\n");
+		std::vector<const char*> entries = f.dict_entries(cells_value, "cells");
 
-		for (auto &cell_node_it : cells_node->data_dict)
+		for (auto it = entries.rbegin(); it != entries.rend(); ++it)
 		{
-			IdString cell_name = RTLIL::escape_id(cell_node_it.first.c_str());
-			JsonNode *cell_node = cell_node_it.second;
+			f.pos = f.entry_value(*it, key);
+			IdString cell_name = RTLIL::escape_id(key.c_str());
+
+			// a repeated key: the last definition wins
+			if (module->cell(cell_name) != nullptr)
+				continue;
+
+			std::unique_ptr<JsonNode> cell_node(new JsonNode(f));
 
 			if (cell_node->type != 'D')
 				log_error("JSON cells node '%s' is not a dictionary.\n", log_id(cell_name));
@@ -568,17 +773,19 @@ void json_import(Design *design, string &modname, JsonNode *node)
 		}
 	}
 
-	if (node->data_dict.count("memories"))
+	if (memories_value)
 	{
-		JsonNode *memories_node = node->data_dict.at("memories");
-
-		if (memories_node->type != 'D')
-			log_error("JSON memories node is not a dictionary.\n");
+		std::vector<const char*> entries = f.dict_entries(memories_value, "memories");
 
-		for (auto &memory_node_it : memories_node->data_dict)
+		for (auto it = entries.rbegin(); it != entries.rend(); ++it)
 		{
-			IdString memory_name = RTLIL::escape_id(memory_node_it.first.c_str());
-			JsonNode *memory_node = memory_node_it.second;
+			f.pos = f.entry_value(*it, key);
+			IdString memory_name = RTLIL::escape_id(key.c_str());
+
+			if (module->memories.count(memory_name) != 0)
+				continue;
+
+			std::unique_ptr<JsonNode> memory_node(new JsonNode(f));
 
 			RTLIL::Memory *mem = new RTLIL::Memory;
 			mem->name = memory_name;
@@ -646,20 +853,26 @@ struct JsonFrontend : public Frontend {
 		}
 		extra_args(f, filename, args, argidx);
 
-		JsonNode root(*f);
+		JsonReader reader(f, filename);
+		const char *modules_value = nullptr;
+		string key;
 
-		if (root.type != 'D')
-			log_error("JSON root node is not a dictionary.\n");
+		for (auto entry : reader.dict_entries(reader.pos, "root")) {
+			const char *value = reader.entry_value(entry, key);
+			if (key == "modules")
+				modules_value = value;
+		}
 
-		if (root.data_dict.count("modules") != 0)
+		if (modules_value != nullptr)
 		{
-			JsonNode *modules = root.data_dict.at("modules");
+			std::vector<const char*> entries = reader.dict_entries(modules_value, "modules");
+			pool<string> imported;
 
-			if (modules->type != 'D')
-				log_error("JSON modules node is not a dictionary.\n");
-
-			for (auto &it : modules->data_dict)
-				json_import(design, it.first, it.second);
+			for (auto it = entries.rbegin(); it != entries.rend(); ++it) {
+				const char *value = reader.entry_value(*it, key);
+				if (imported.insert(key).second)
+					json_import(design, key, reader, value);
+			}
 		}
 	}
 } JsonFrontend;
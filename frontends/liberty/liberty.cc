@@ -539,13 +539,15 @@ struct LibertyFrontend : public Frontend {
 
 		log_header(design, "Executing Liberty frontend: %s\n", filename.c_str());
 
-		LibertyParser parser(*f);
+		std::shared_ptr<const LibertyAst> ast = LibertyCache::load(*f, filename);
+		if (ast == nullptr)
+			log_error("No library found in liberty file `%s'.\n", filename.c_str());
 		int cell_count = 0;
 
 		std::map<std::string, std::tuple<int, int, bool>> global_type_map;
-		parse_type_map(global_type_map, parser.ast);
+		parse_type_map(global_type_map, ast.get());
 
-		for (auto cell : parser.ast->children)
+		for (auto cell : ast->children)
 		{
 			if (cell->id != "cell" || cell->args.size() != 1)
 				continue;
@@ -253,8 +253,20 @@ void FstData::reconstructAllAtTimes(std::vector<fstHandle> &signal, uint64_t sta
 	past_time = start_time;
 	all_samples = clk_signals.empty();
 
-	fstReaderSetUnlimitedTimeRange(ctx);
-	fstReaderSetFacProcessMaskAll(ctx);
+	// Every value change block of an FST file starts with a frame holding the values of all signals at its start
+	// time. With a limited time range, the reader skips the blocks that end before `start` (looking only at their
+	// headers) and reports the frame of the first block it decodes, so a window late in a long trace can be
+	// reconstructed without decoding anything before it. Only the signals in the process mask are decoded.
+	fstReaderSetLimitTimeRange(ctx, start_time, end_time);
+	if (required_signals.empty()) {
+		fstReaderSetFacProcessMaskAll(ctx);
+	} else {
+		fstReaderClrFacProcessMaskAll(ctx);
+		for (auto handle : required_signals)
+			fstReaderSetFacProcessMask(ctx, handle);
+		for (auto handle : clk_signals)
+			fstReaderSetFacProcessMask(ctx, handle);
+	}
 	fstReaderIterBlocks2(ctx, reconstruct_clb_attimes, reconstruct_clb_varlen_attimes, this, nullptr);
 	if (last_time!=end_time) {
 		past_data = last_data;
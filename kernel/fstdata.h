@@ -51,6 +51,9 @@ class FstData
 
 	void reconstruct_callback_attimes(uint64_t pnt_time, fstHandle pnt_facidx, const unsigned char *pnt_value, uint32_t plen);
 	void reconstructAllAtTimes(std::vector<fstHandle> &signal, uint64_t start_time, uint64_t end_time, CallbackFunction cb);
+	// Limits the reconstruction to the given signals (the clock signals are always included); `valueOf()` returns
+	// undefined values for all the others. An empty list selects all signals, which is the default.
+	void setRequiredSignals(const std::vector<fstHandle> &signals) { required_signals = signals; }
 
 	std::string valueOf(fstHandle signal);
 	fstHandle getHandle(std::string name);
@@ -75,6 +78,7 @@ private:
 	uint64_t end_time;
 	CallbackFunction callback;
 	std::vector<fstHandle> clk_signals;
+	std::vector<fstHandle> required_signals;
 	bool all_samples;
 	std::string tmp_file;
 };
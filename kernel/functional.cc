@@ -727,6 +727,9 @@ IR IR::from_module(Module *module) {
     ctor.process_queue();
     ir.topological_sort();
     ir.forward_buf();
+    int unoptimized_size = ir.size();
+    ir.optimize();
+    log("Functional IR of module `%s' has %d nodes (%d before optimization).\n", log_id(module), ir.size(), unoptimized_size);
     return ir;
 }
 
@@ -797,6 +800,155 @@ void IR::forward_buf() {
     _graph.permute(perm, alias);
 }
 
+// IROptimizer rebuilds the nodes of a topologically sorted graph with hash-consing and folding of slices and
+// concatenations. Every node is mapped to a representative: either itself, another (equivalent) node that was seen
+// earlier, or a node that is appended to the graph. The nodes that end up unused are removed by the final sort.
+struct IR::Optimizer {
+	IR &ir;
+	std::vector<int> repl;
+	dict<std::tuple<NodeData, Sort, std::vector<int>>, int> interned;
+
+	Optimizer(IR &ir) : ir(ir) {}
+
+	Graph::Ref node(int index) { return ir._graph[index]; }
+	Fn fn(int index) { return node(index).function().fn(); }
+	int width(int index) { return node(index).attr().sort.width(); }
+	int arg(int index, int n) { return node(index).arg(n).index(); }
+
+	// returns an existing node that computes the same value, or `self` if there is none (and it is not -1),
+	// or else a new node
+	int intern(NodeData data, Sort sort, std::vector<int> args, int self = -1) {
+		auto key = std::make_tuple(data, sort, args);
+		auto it = interned.find(key);
+		if (it != interned.end())
+			return it->second;
+		if (self == -1) {
+			Graph::Ref ref = ir._graph.add(std::move(data), {std::move(sort)});
+			for (int arg : args)
+				ref.append_arg(arg);
+			self = ref.index();
+			log_assert(GetSize(repl) == self);
+			repl.push_back(self);
+		}
+		interned.emplace(key, self);
+		return self;
+	}
+
+	int constant(RTLIL::Const value) {
+		int width = value.size();
+		return intern(NodeData(Fn::constant, std::move(value)), Sort(width), {});
+	}
+
+	int slice(int a, int offset, int out_width, int self = -1) {
+		if (offset == 0 && out_width == width(a))
+			return a;
+		switch (fn(a)) {
+		case Fn::slice:
+			return slice(arg(a, 0), offset + node(a).function().as_int(), out_width);
+		case Fn::concat: {
+			int low = arg(a, 0), high = arg(a, 1);
+			if (offset + out_width <= width(low))
+				return slice(low, offset, out_width);
+			if (offset >= width(low))
+				return slice(high, offset - width(low), out_width);
+			break;
+		}
+		case Fn::zero_extend:
+		case Fn::sign_extend: {
+			int inner = arg(a, 0);
+			if (offset + out_width <= width(inner))
+				return slice(inner, offset, out_width);
+			if (fn(a) == Fn::zero_extend && offset >= width(inner))
+				return constant(RTLIL::Const(State::S0, out_width));
+			break;
+		}
+		case Fn::constant:
+			return constant(node(a).function().as_const().extract(offset, out_width));
+		default:
+			break;
+		}
+		return intern(NodeData(Fn::slice, offset), Sort(out_width), {a}, self);
+	}
+
+	int concat(int a, int b, int self = -1) {
+		if (fn(a) == Fn::constant && fn(b) == Fn::constant) {
+			RTLIL::Const value = node(a).function().as_const();
+			for (auto bit : node(b).function().as_const())
+				value.bits().push_back(bit);
+			return constant(value);
+		}
+		if (fn(a) == Fn::slice && fn(b) == Fn::slice && arg(a, 0) == arg(b, 0) &&
+				node(a).function().as_int() + width(a) == node(b).function().as_int())
+			return slice(arg(a, 0), node(a).function().as_int(), width(a) + width(b));
+		return intern(NodeData(Fn::concat), Sort(width(a) + width(b)), {a, b}, self);
+	}
+
+	int rebuild(int index) {
+		Graph::Ref ref = node(index);
+		std::vector<int> args;
+		for (int i = 0; i < ref.size(); i++) {
+			int arg = ref.arg(i).index();
+			log_assert(arg < index);
+			args.push_back(repl[arg]);
+		}
+		switch (ref.function().fn()) {
+		case Fn::slice:
+			return slice(args[0], ref.function().as_int(), ref.attr().sort.width(), index);
+		case Fn::concat:
+			return concat(args[0], args[1], index);
+		case Fn::zero_extend:
+		case Fn::sign_extend:
+			if (fn(args[0]) == Fn::constant) {
+				RTLIL::Const value = node(args[0]).function().as_const();
+				if (ref.function().fn() == Fn::sign_extend)
+					value.exts(ref.attr().sort.width());
+				else
+					value.extu(ref.attr().sort.width());
+				return constant(value);
+			}
+			break;
+		case Fn::buf:
+			if (!args.empty())
+				return args[0];
+			return index;
+		default:
+			break;
+		}
+		return intern(ref.function(), ref.attr().sort, args, index);
+	}
+
+	void run() {
+		int original_size = ir._graph.size();
+		repl.resize(original_size, -1);
+		for (int index = 0; index < original_size; index++) {
+			int target = rebuild(index);
+			repl[index] = target;
+			if (target != index && node(index).has_sparse_attr()) {
+				IdString name = node(index).sparse_attr();
+				if (node(target).has_sparse_attr())
+					name = merge_name(name, node(target).sparse_attr());
+				node(target).sparse_attr() = name;
+			}
+		}
+		// Keep the representatives (the original ones, in their order, followed by the appended ones).
+		std::vector<int> perm, inv_perm(ir._graph.size(), -1);
+		for (int index = 0; index < ir._graph.size(); index++)
+			if (repl[index] == index) {
+				inv_perm[index] = GetSize(perm);
+				perm.push_back(index);
+			}
+		for (int index = 0; index < ir._graph.size(); index++)
+			inv_perm[index] = inv_perm[repl[index]];
+		ir._graph.permute(perm, inv_perm);
+	}
+};
+
+void IR::optimize() {
+	Optimizer(*this).run();
+	// The appended nodes are out of order and the replaced ones may be unused, which sorting fixes.
+	topological_sort();
+}
+
 // Quoting routine to make error messages nicer
 static std::string quote_fmt(const char *fmt)
 {
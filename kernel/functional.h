@@ -248,6 +248,7 @@ namespace Functional {
 		dict<std::pair<IdString, IdString>, IROutput> _outputs;
 		dict<std::pair<IdString, IdString>, IRState> _states;
 		IR::Graph::Ref mutate(Node n);
+		struct Optimizer;
 	public:
 		static IR from_module(Module *module);
 		Factory factory();
@@ -255,6 +256,8 @@ namespace Functional {
 		Node operator[](int i);
 		void topological_sort();
 		void forward_buf();
+		// merges equivalent nodes, folds slices and concatenations, and removes the nodes that are no longer used
+		void optimize();
 		IRInput const& input(IdString name, IdString kind) const { return _inputs.at({name, kind}); }
 		IRInput const& input(IdString name) const { return input(name, ID($input)); }
 		IROutput const& output(IdString name, IdString kind) const { return _outputs.at({name, kind}); }
@@ -52,6 +52,13 @@ void QuickConeSat::prepare()
 					if (i != j)
 						ez->assume(ez->NOT(i), j);
 				imported_onehot.insert(bit.wire);
+				if (record_imports) {
+					ImportRecord record;
+					record.wire = bit.wire;
+					record.name = bit.wire->name;
+					record_sig(record, bit.wire);
+					import_records.push_back(std::move(record));
+				}
 			}
 
 		bits_queue.clear();
@@ -68,6 +75,19 @@ void QuickConeSat::prepare()
 			bits_queue.insert(inputs.begin(), inputs.end());
 			satgen.importCell(pbit.cell);
 			imported_cells.insert(pbit.cell);
+			import_count++;
+			if (record_imports) {
+				ImportRecord record;
+				record.cell = pbit.cell;
+				record.name = pbit.cell->name;
+				record.type = pbit.cell->type;
+				record.parameters = pbit.cell->parameters;
+				for (auto &conn : pbit.cell->connections()) {
+					record.ports.emplace_back(conn.first, GetSize(conn.second));
+					record_sig(record, conn.second);
+				}
+				import_records.push_back(std::move(record));
+			}
 		}
 
 		if (max_cell_count && GetSize(imported_cells) > max_cell_count)
@@ -75,6 +95,100 @@ void QuickConeSat::prepare()
 	}
 }
 
+// The name SatGen gives to the solver variable of a (sigmapped) bit.
+static std::string literal_name(RTLIL::SigBit bit)
+{
+	if (bit.wire == nullptr)
+		return std::string();
+	if (bit.wire->width == 1)
+		return log_id(bit.wire);
+	return stringf("%s [%d]", log_id(bit.wire->name), bit.offset);
+}
+
+void QuickConeSat::record_sig(ImportRecord &record, const RTLIL::SigSpec &sig)
+{
+	for (auto bit : modwalker.sigmap(sig))
+		record.bits.push_back({bit, bit.wire ? bit.wire->name : RTLIL::IdString(), literal_name(bit)});
+}
+
+bool QuickConeSat::check_imports()
+{
+	// The recorded cells and wires may have been deleted, so they are only
+	// dereferenced once the module is known to still contain them.
+	RTLIL::Module *module = modwalker.module;
+	dict<std::string, RTLIL::SigBit> literal_bits;
+	pool<RTLIL::Cell*> changed_cells;
+	pool<RTLIL::Wire*> changed_onehot;
+	for (auto &record : import_records) {
+		RTLIL::SigSpec sig;
+		if (record.cell) {
+			if (module->cell(record.name) != record.cell)
+				return false;
+			RTLIL::Cell *cell = record.cell;
+			if (cell->type != record.type || cell->parameters != record.parameters)
+				return false;
+			if (GetSize(cell->connections()) != GetSize(record.ports))
+				return false;
+			auto port = record.ports.begin();
+			for (auto &conn : cell->connections()) {
+				if (conn.first != port->first || GetSize(conn.second) != port->second)
+					return false;
+				sig.append(conn.second);
+				++port;
+			}
+		} else {
+			if (module->wire(record.name) != record.wire || !record.wire->get_bool_attribute(ID::onehot))
+				return false;
+			sig = record.wire;
+		}
+		sig = modwalker.sigmap(sig);
+		if (GetSize(sig) != GetSize(record.bits))
+			return false;
+
+		bool changed = false;
+		for (int i = 0; i < GetSize(sig); i++) {
+			const ImportedBit &imported = record.bits[i];
+			RTLIL::SigBit bit = sig[i];
+			if (imported.literal.empty()) {
+				// A constant was built into the clauses.
+				if (bit != imported.bit)
+					return false;
+				continue;
+			}
+			auto it = literal_bits.find(imported.literal);
+			if (it != literal_bits.end()) {
+				if (it->second != bit)
+					return false;
+			} else {
+				// The variable must not be imported for any other bit now.
+				RTLIL::Wire *wire = module->wire(imported.wire_name);
+				if (wire && imported.bit.offset < wire->width) {
+					RTLIL::SigBit owner = modwalker.sigmap(RTLIL::SigBit(wire, imported.bit.offset));
+					if (owner != bit && literal_name(owner) == imported.literal)
+						return false;
+				}
+				literal_bits[imported.literal] = bit;
+			}
+			if (literal_name(bit) != imported.literal)
+				changed = true;
+		}
+		if (changed) {
+			if (record.cell)
+				changed_cells.insert(record.cell);
+			else
+				changed_onehot.insert(record.wire);
+		}
+	}
+
+	// The clauses of the changed cells stay in the solver, and so do their
+	// records, since the variables they use must stay consistent.
+	for (auto cell : changed_cells)
+		imported_cells.erase(cell);
+	for (auto wire : changed_onehot)
+		imported_onehot.erase(wire);
+	return true;
+}
+
 int QuickConeSat::cell_complexity(RTLIL::Cell *cell)
 {
 	if (cell->type.in(ID($concat), ID($slice), ID($pos), ID($buf), ID($_BUF_)))
@@ -100,3 +214,125 @@ int QuickConeSat::cell_complexity(RTLIL::Cell *cell)
 	// Unknown cell.
 	return 5;
 }
+
+static QuickConeSatCache *active_qcsat_cache = nullptr;
+
+QuickConeSatCache::QuickConeSatCache(RTLIL::Design *design) : design(design), outer(active_qcsat_cache)
+{
+	design->monitors.insert(this);
+	active_qcsat_cache = this;
+}
+
+QuickConeSatCache::~QuickConeSatCache()
+{
+	log_assert(active_qcsat_cache == this);
+	active_qcsat_cache = outer;
+	design->monitors.erase(this);
+
+	bool header = false;
+	for (auto &it : stats) {
+		if (it.second.import_count == 0 && it.second.solve_count == 0)
+			continue;
+		if (!header)
+			log("SAT solver cache statistics:\n");
+		header = true;
+		log("  %-20s %5d sessions (%d reused), %6d cells imported, %6d queries, %.2f sec solving\n",
+				it.first.c_str(), it.second.uses, it.second.reuses, it.second.import_count,
+				it.second.solve_count, it.second.solve_time / 1e9);
+	}
+}
+
+QuickConeSatCache *QuickConeSatCache::active(RTLIL::Design *design)
+{
+	for (auto cache = active_qcsat_cache; cache != nullptr; cache = cache->outer)
+		if (cache->design == design)
+			return cache;
+	return nullptr;
+}
+
+std::shared_ptr<QuickConeSatCache::Entry> QuickConeSatCache::acquire(RTLIL::Module *module, const std::string &user)
+{
+	Stats &user_stats = stats[user];
+	user_stats.uses++;
+
+	auto it = entries.find(module);
+	if (it != entries.end()) {
+		std::shared_ptr<Entry> entry = it->second;
+		// The module may have changed without any notification, and wires
+		// known to the solver may have been deleted since.  QuickConeSat does
+		// not use the map of imported signals of SatGen, which is cleared so
+		// that new signals are never compared against deleted wires.
+		entry->modwalker.setup(module);
+		entry->qcsat.bits_queue.clear();
+		entry->qcsat.satgen.imported_signals.clear();
+		if (entry->qcsat.check_imports()) {
+			user_stats.reuses++;
+			return entry;
+		}
+		entries.erase(it);
+	}
+
+	std::shared_ptr<Entry> entry = std::make_shared<Entry>(module);
+	entries[module] = entry;
+	return entry;
+}
+
+void QuickConeSatCache::release(const std::string &user, int import_count, int solve_count, int64_t solve_time)
+{
+	Stats &user_stats = stats[user];
+	user_stats.import_count += import_count;
+	user_stats.solve_count += solve_count;
+	user_stats.solve_time += solve_time;
+}
+
+void QuickConeSatCache::invalidate(RTLIL::Module *module)
+{
+	entries.erase(module);
+}
+
+void QuickConeSatCache::notify_module_del(RTLIL::Module *module)
+{
+	invalidate(module);
+}
+
+void QuickConeSatCache::notify_blackout(RTLIL::Module *module)
+{
+	invalidate(module);
+}
+
+QuickConeSatRef::QuickConeSatRef(RTLIL::Module *module, const std::string &user) :
+		module(module), given_modwalker(nullptr), cache(QuickConeSatCache::active(module->design)), user(user)
+{
+}
+
+QuickConeSatRef::QuickConeSatRef(ModWalker &modwalker, const std::string &user) :
+		module(modwalker.module), given_modwalker(&modwalker), cache(QuickConeSatCache::active(modwalker.design)), user(user)
+{
+}
+
+void QuickConeSatRef::acquire()
+{
+	if (cache) {
+		entry = cache->acquire(module, user);
+		modwalker_ = &entry->modwalker;
+		qcsat_ = &entry->qcsat;
+	} else if (given_modwalker) {
+		private_qcsat = std::make_unique<QuickConeSat>(*given_modwalker);
+		modwalker_ = given_modwalker;
+		qcsat_ = private_qcsat.get();
+	} else {
+		entry = std::make_shared<QuickConeSatCache::Entry>(module);
+		modwalker_ = &entry->modwalker;
+		qcsat_ = &entry->qcsat;
+	}
+	import_start = qcsat_->import_count;
+	solve_start = qcsat_->solve_count;
+	solve_time_start = qcsat_->solve_time;
+}
+
+QuickConeSatRef::~QuickConeSatRef()
+{
+	if (cache && qcsat_)
+		cache->release(user, qcsat_->import_count - import_start,
+				qcsat_->solve_count - solve_start, qcsat_->solve_time - solve_time_start);
+}
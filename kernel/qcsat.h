@@ -51,13 +51,52 @@ struct QuickConeSat {
 	// If non-0, skip importing cells with more than this number of output bits.
 	int max_cell_outs = 0;
 
+	// If set, the signals of every imported cell and onehot wire are
+	// recorded the way the solver saw them, so that check_imports() can
+	// tell later whether the solver is still usable for the module.
+	bool record_imports = false;
+
 	// Internal state.
 	pool<RTLIL::Cell*> imported_cells;
 	pool<RTLIL::Wire*> imported_onehot;
 	pool<RTLIL::SigBit> bits_queue;
 
+	// The solver variable of a signal bit is named after the wire of its
+	// sigmapped bit.  The wire may be deleted later, so its name is recorded
+	// along with the bit, and the wire itself is never dereferenced.
+	struct ImportedBit {
+		RTLIL::SigBit bit;
+		RTLIL::IdString wire_name;
+		std::string literal; // empty for constants
+	};
+	struct ImportRecord {
+		RTLIL::Cell *cell = nullptr;
+		RTLIL::Wire *wire = nullptr;
+		RTLIL::IdString name, type;
+		dict<RTLIL::IdString, RTLIL::Const> parameters;
+		std::vector<std::pair<RTLIL::IdString, int>> ports;
+		std::vector<ImportedBit> bits;
+	};
+	std::vector<ImportRecord> import_records;
+
+	// Statistics.
+	int import_count = 0;
+	int solve_count = 0;
+	int64_t solve_time = 0;
+
 	QuickConeSat(ModWalker &modwalker) : modwalker(modwalker), ez(), satgen(ez.get(), &modwalker.sigmap) {}
 
+	// Same as ez->solve(...), but counted in the statistics.
+	template<typename... Args>
+	bool solve(Args&&... args)
+	{
+		int64_t start = PerformanceTimer::query();
+		bool result = ez->solve(std::forward<Args>(args)...);
+		solve_time += PerformanceTimer::query() - start;
+		solve_count++;
+		return result;
+	}
+
 	// Imports a signal into the SAT solver, queues its input cone to be
 	// imported in the next prepare() call.
 	std::vector<int> importSig(SigSpec sig);
@@ -67,8 +106,106 @@ struct QuickConeSat {
 	// the SAT solver.
 	void prepare();
 
+	// Returns true if the clauses in the solver still hold for the module.
+	// This is the case if every recorded cell and onehot wire still exists
+	// with the same type and parameters, and every solver variable still
+	// stands for a single signal bit, which is also the bit that the same
+	// variable would be imported for now.  Cells and onehot wires whose
+	// signals are now imported as different variables are forgotten, so that
+	// they are imported again when needed.  This needs an up to date
+	// ModWalker.
+	bool check_imports();
+
 	// Returns the "complexity level" of a given cell.
 	static int cell_complexity(RTLIL::Cell *cell);
+
+private:
+	void record_sig(ImportRecord &record, const RTLIL::SigSpec &sig);
+};
+
+// Keeps the QuickConeSat instance of each module alive from one pass to the
+// next, so that cones imported by one SAT-based optimization are not imported
+// again by the next one.  A cache is in effect while it exists (the "opt" and
+// "memory" passes create one for their duration); passes get their solver
+// through QuickConeSatRef, which falls back to a private solver otherwise.
+//
+// Not every change to a module notifies the monitors of the design (e.g.
+// opt_clean rewrites the connections of cells directly), so the ModWalker of
+// a module is rebuilt whenever its solver is handed out again, and the solver
+// is only kept if the clauses already in it still hold for the module (see
+// QuickConeSat::check_imports()).
+//
+// A solver obtained from the cache may contain more of the cone than was
+// asked for, which only makes it stronger.  Passes that add permanent
+// assumptions or disable incremental mode must not use the cache.
+struct QuickConeSatCache : RTLIL::Monitor
+{
+	struct Entry {
+		RTLIL::Module *module;
+		ModWalker modwalker;
+		QuickConeSat qcsat;
+		Entry(RTLIL::Module *module) : module(module), modwalker(module->design, module), qcsat(modwalker)
+		{
+			qcsat.record_imports = true;
+		}
+	};
+
+	struct Stats {
+		int uses = 0, reuses = 0;
+		int import_count = 0, solve_count = 0;
+		int64_t solve_time = 0;
+	};
+
+	RTLIL::Design *design;
+	QuickConeSatCache *outer;
+	dict<RTLIL::Module*, std::shared_ptr<Entry>> entries;
+	dict<std::string, Stats> stats;
+
+	QuickConeSatCache(RTLIL::Design *design);
+	~QuickConeSatCache();
+
+	// Returns the innermost cache in effect for the design, or nullptr.
+	static QuickConeSatCache *active(RTLIL::Design *design);
+
+	std::shared_ptr<Entry> acquire(RTLIL::Module *module, const std::string &user);
+	void release(const std::string &user, int import_count, int solve_count, int64_t solve_time);
+
+	void invalidate(RTLIL::Module *module);
+	void notify_module_del(RTLIL::Module *module) override;
+	void notify_blackout(RTLIL::Module *module) override;
+};
+
+// The QuickConeSat (and the ModWalker it uses) of a module for the duration
+// of one query session of a pass, taken from the active QuickConeSatCache if
+// there is one.  Without a cache, a new QuickConeSat is created, using the
+// given ModWalker if there is one.  Nothing is set up before the first call
+// of modwalker() or qcsat(), so a session that turns out not to need the
+// solver costs nothing.  The user name is only used for the statistics of
+// the cache.
+struct QuickConeSatRef {
+	RTLIL::Module *module;
+	ModWalker *given_modwalker;
+	QuickConeSatCache *cache;
+	std::shared_ptr<QuickConeSatCache::Entry> entry;
+	std::unique_ptr<QuickConeSat> private_qcsat;
+	ModWalker *modwalker_ = nullptr;
+	QuickConeSat *qcsat_ = nullptr;
+	std::string user;
+	int import_start = 0, solve_start = 0;
+	int64_t solve_time_start = 0;
+
+	QuickConeSatRef(RTLIL::Module *module, const std::string &user);
+	QuickConeSatRef(ModWalker &modwalker, const std::string &user);
+	~QuickConeSatRef();
+
+	QuickConeSatRef(const QuickConeSatRef &) = delete;
+	QuickConeSatRef &operator=(const QuickConeSatRef &) = delete;
+
+	ModWalker &modwalker() { if (!qcsat_) acquire(); return *modwalker_; }
+	QuickConeSat &qcsat() { if (!qcsat_) acquire(); return *qcsat_; }
+
+private:
+	void acquire();
 };
 
 YOSYS_NAMESPACE_END
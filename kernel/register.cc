@@ -19,6 +19,7 @@
 
 #include "kernel/yosys.h"
 #include "kernel/satgen.h"
+#include "libs/ezsat/ezcdcl.h"
 #include "kernel/json.h"
 
 #include <string.h>
@@ -1200,6 +1201,13 @@ struct MinisatSatSolver : public SatSolver {
 	}
 } MinisatSatSolver;
 
+struct CdclSatSolver : public SatSolver {
+	CdclSatSolver() : SatSolver("cdcl") { }
+	ezSAT *create() override {
+		return new ezCDCL();
+	}
+} CdclSatSolver;
+
 struct LicensePass : public Pass {
 	LicensePass() : Pass("license", "print license terms") { }
 	void help() override
@@ -0,0 +1,991 @@
+/*
+ *  ezSAT -- A simple and easy to use CNF generator for SAT solvers
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "ezcdcl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <string.h>
+
+// literals are encoded as 2*var+sign with 0-based variables, ezSAT variable idx is solver variable idx-1
+static inline int lit_var(int lit) { return lit >> 1; }
+static inline int lit_from_ez(int idx) { return idx > 0 ? 2*(idx-1) : 2*(-idx-1) + 1; }
+
+static int64_t now_ms()
+{
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+ezCDCL::ezCDCL()
+{
+	clear();
+
+	freeze(CONST_TRUE);
+	freeze(CONST_FALSE);
+}
+
+ezCDCL::~ezCDCL()
+{
+}
+
+void ezCDCL::clear()
+{
+	arena.clear();
+	clauses.clear();
+	learnts.clear();
+	wastedWords = 0;
+	watches.clear();
+	litValue.clear();
+	varLevel.clear();
+	varReason.clear();
+	varActivity.clear();
+	varPhase.clear();
+	varSeen.clear();
+	heap.clear();
+	heapIndex.clear();
+	trail.clear();
+	trailLim.clear();
+	levelStamp.clear();
+	qhead = 0;
+	varInc = 1.0;
+	clauseInc = 1.0;
+	lbdFast = 0;
+	lbdSlow = 0;
+	numConflicts = 0;
+	conflictsAtRestart = 0;
+	nextReduce = 2000;
+	reduceInc = 300;
+	stampCounter = 0;
+	simplifyAssigns = -1;
+	foundContradiction = false;
+	cnfFrozenVars.clear();
+	varFrozen.clear();
+	varEliminated.clear();
+	varTouched.clear();
+	touchedVars.clear();
+	occurs.clear();
+	litStamp.clear();
+	elimClauses.clear();
+	clausesAtEliminate = 0;
+	clausesSinceEliminate = 0;
+	eliminatedCount = 0;
+	ezSAT::clear();
+}
+
+void ezCDCL::freeze(int id)
+{
+	if (!mode_non_incremental())
+		cnfFrozenVars.push_back(bind(id));
+}
+
+bool ezCDCL::eliminated(int idx)
+{
+	idx = idx < 0 ? -idx : idx;
+	return idx > 0 && idx <= numVars() && varEliminated[idx-1];
+}
+
+int ezCDCL::numEliminatedVariables() const
+{
+	return eliminatedCount;
+}
+
+float ezCDCL::clauseActivity(uint32_t cref) const
+{
+	float activity;
+	memcpy(&activity, &arena[cref + 2], sizeof(float));
+	return activity;
+}
+
+void ezCDCL::setClauseActivity(uint32_t cref, float activity)
+{
+	memcpy(&arena[cref + 2], &activity, sizeof(float));
+}
+
+int ezCDCL::newVar()
+{
+	int var = numVars();
+	watches.resize(2*var + 2);
+	litValue.resize(2*var + 2, 0);
+	varLevel.push_back(0);
+	varReason.push_back(CREF_NONE);
+	varActivity.push_back(0.0);
+	varPhase.push_back(false);
+	varSeen.push_back(0);
+	varFrozen.push_back(0);
+	varEliminated.push_back(0);
+	varTouched.push_back(0);
+	litStamp.resize(2*var + 2, 0);
+	heapIndex.push_back(-1);
+	heapInsert(var);
+	return var;
+}
+
+uint32_t ezCDCL::allocClause(const std::vector<int> &lits, bool learnt, uint32_t lbd)
+{
+	uint32_t cref = arena.size();
+	arena.push_back(lits.size());
+	arena.push_back((learnt ? 1 : 0) | (lbd << 2));
+	arena.push_back(0);
+	for (int lit : lits)
+		arena.push_back(lit);
+	setClauseActivity(cref, 0.0f);
+	return cref;
+}
+
+void ezCDCL::attachClause(uint32_t cref)
+{
+	int *lits = clauseLits(cref);
+	bool binary = clauseSize(cref) == 2;
+	watches[lits[0] ^ 1].push_back(Watcher{cref, lits[1], binary});
+	watches[lits[1] ^ 1].push_back(Watcher{cref, lits[0], binary});
+}
+
+// watchers of deleted clauses are removed by purgeWatches(), which has to be called before the next propagation
+void ezCDCL::deleteClause(uint32_t cref)
+{
+	arena[cref + 1] |= 2;
+	wastedWords += clauseSize(cref) + 3;
+}
+
+bool ezCDCL::clauseLocked(uint32_t cref)
+{
+	// the propagated literal is at position 0, except for binary clauses that are never moved in the arena
+	int *lits = clauseLits(cref);
+	for (int i = 0; i < 2; i++) {
+		int var = lit_var(lits[i]);
+		if (varReason[var] == cref && value(lits[i]) > 0)
+			return true;
+	}
+	return false;
+}
+
+bool ezCDCL::clauseSatisfied(uint32_t cref)
+{
+	int *lits = clauseLits(cref);
+	for (uint32_t i = 0; i < clauseSize(cref); i++)
+		if (value(lits[i]) > 0)
+			return true;
+	return false;
+}
+
+void ezCDCL::purgeWatches()
+{
+	for (auto &ws : watches)
+		ws.erase(std::remove_if(ws.begin(), ws.end(), [&](const Watcher &w) { return clauseDeleted(w.cref); }), ws.end());
+}
+
+void ezCDCL::collectGarbage()
+{
+	std::vector<uint32_t> newArena;
+	newArena.reserve(arena.size() - wastedWords);
+
+	// the new position of a moved clause is stored in its old activity word
+	auto relocate = [&](std::vector<uint32_t> &crefs) {
+		size_t j = 0;
+		for (size_t i = 0; i < crefs.size(); i++) {
+			uint32_t cref = crefs[i];
+			if (clauseDeleted(cref))
+				continue;
+			uint32_t newCref = newArena.size();
+			newArena.insert(newArena.end(), arena.begin() + cref, arena.begin() + cref + 3 + clauseSize(cref));
+			arena[cref + 2] = newCref;
+			crefs[j++] = newCref;
+		}
+		crefs.resize(j);
+	};
+
+	relocate(clauses);
+	relocate(learnts);
+
+	for (auto &ws : watches)
+		for (auto &w : ws)
+			w.cref = arena[w.cref + 2];
+	for (int lit : trail) {
+		uint32_t &reason = varReason[lit_var(lit)];
+		if (reason != CREF_NONE)
+			reason = arena[reason + 2];
+	}
+
+	arena.swap(newArena);
+	wastedWords = 0;
+}
+
+void ezCDCL::heapUp(int pos)
+{
+	int var = heap[pos];
+	while (pos > 0) {
+		int parent = (pos - 1) / 2;
+		if (varActivity[heap[parent]] >= varActivity[var])
+			break;
+		heap[pos] = heap[parent];
+		heapIndex[heap[pos]] = pos;
+		pos = parent;
+	}
+	heap[pos] = var;
+	heapIndex[var] = pos;
+}
+
+void ezCDCL::heapDown(int pos)
+{
+	int var = heap[pos];
+	int size = heap.size();
+	while (2*pos + 1 < size) {
+		int child = 2*pos + 1;
+		if (child + 1 < size && varActivity[heap[child + 1]] > varActivity[heap[child]])
+			child++;
+		if (varActivity[heap[child]] <= varActivity[var])
+			break;
+		heap[pos] = heap[child];
+		heapIndex[heap[pos]] = pos;
+		pos = child;
+	}
+	heap[pos] = var;
+	heapIndex[var] = pos;
+}
+
+void ezCDCL::heapInsert(int var)
+{
+	if (heapIndex[var] >= 0)
+		return;
+	heap.push_back(var);
+	heapUp(heap.size() - 1);
+}
+
+int ezCDCL::heapPop()
+{
+	int var = heap.front();
+	heapIndex[var] = -1;
+	int last = heap.back();
+	heap.pop_back();
+	if (!heap.empty()) {
+		heap[0] = last;
+		heapIndex[last] = 0;
+		heapDown(0);
+	}
+	return var;
+}
+
+void ezCDCL::bumpVar(int var)
+{
+	if ((varActivity[var] += varInc) > 1e100) {
+		for (auto &activity : varActivity)
+			activity *= 1e-100;
+		varInc *= 1e-100;
+	}
+	if (heapIndex[var] >= 0)
+		heapUp(heapIndex[var]);
+}
+
+void ezCDCL::bumpClause(uint32_t cref)
+{
+	float activity = clauseActivity(cref) + clauseInc;
+	setClauseActivity(cref, activity);
+	if (activity > 1e20) {
+		for (auto c : learnts)
+			setClauseActivity(c, clauseActivity(c) * 1e-20f);
+		clauseInc *= 1e-20;
+	}
+}
+
+uint32_t ezCDCL::computeLbd(const int *lits, int size)
+{
+	stampCounter++;
+	uint32_t lbd = 0;
+	for (int i = 0; i < size; i++) {
+		int level = varLevel[lit_var(lits[i])];
+		if (levelStamp[level] != stampCounter)
+			levelStamp[level] = stampCounter, lbd++;
+	}
+	return lbd;
+}
+
+void ezCDCL::assign(int lit, uint32_t reason)
+{
+	int var = lit_var(lit);
+	litValue[lit] = 1;
+	litValue[lit ^ 1] = -1;
+	varLevel[var] = decisionLevel();
+	varReason[var] = reason;
+	trail.push_back(lit);
+}
+
+void ezCDCL::newDecisionLevel()
+{
+	trailLim.push_back(trail.size());
+	if (int(levelStamp.size()) <= decisionLevel())
+		levelStamp.resize(2*decisionLevel() + 1, 0);
+}
+
+void ezCDCL::cancelUntil(int level)
+{
+	if (decisionLevel() <= level)
+		return;
+	for (int i = int(trail.size()) - 1; i >= trailLim[level]; i--) {
+		int lit = trail[i];
+		int var = lit_var(lit);
+		litValue[lit] = 0;
+		litValue[lit ^ 1] = 0;
+		varReason[var] = CREF_NONE;
+		varPhase[var] = (lit & 1) == 0;
+		heapInsert(var);
+	}
+	trail.resize(trailLim[level]);
+	trailLim.resize(level);
+	qhead = trail.size();
+}
+
+uint32_t ezCDCL::propagate()
+{
+	uint32_t confl = CREF_NONE;
+
+	while (qhead < int(trail.size()))
+	{
+		int p = trail[qhead++];
+		int falseLit = p ^ 1;
+		std::vector<Watcher> &ws = watches[p];
+		size_t i = 0, j = 0, n = ws.size();
+
+		while (i < n)
+		{
+			Watcher w = ws[i++];
+			int8_t blockerValue = value(w.blocker);
+
+			if (blockerValue > 0) {
+				ws[j++] = w;
+				continue;
+			}
+
+			if (w.binary) {
+				ws[j++] = w;
+				if (blockerValue < 0) {
+					confl = w.cref;
+					break;
+				}
+				assign(w.blocker, w.cref);
+				continue;
+			}
+
+			int *lits = clauseLits(w.cref);
+			if (lits[0] == falseLit)
+				std::swap(lits[0], lits[1]);
+
+			int first = lits[0];
+			if (first != w.blocker && value(first) > 0) {
+				ws[j++] = Watcher{w.cref, first, false};
+				continue;
+			}
+
+			uint32_t size = clauseSize(w.cref);
+			for (uint32_t k = 2; k < size; k++)
+				if (value(lits[k]) >= 0) {
+					lits[1] = lits[k];
+					lits[k] = falseLit;
+					watches[lits[1] ^ 1].push_back(Watcher{w.cref, first, false});
+					goto next_watcher;
+				}
+
+			ws[j++] = Watcher{w.cref, first, false};
+			if (value(first) < 0) {
+				confl = w.cref;
+				break;
+			}
+			assign(first, w.cref);
+		next_watcher:;
+		}
+
+		while (i < n)
+			ws[j++] = ws[i++];
+		ws.resize(j);
+
+		if (confl != CREF_NONE) {
+			qhead = trail.size();
+			break;
+		}
+	}
+
+	return confl;
+}
+
+bool ezCDCL::litRedundant(int lit, uint32_t abstractLevels)
+{
+	size_t top = analyzeToClear.size();
+	analyzeStack.clear();
+	analyzeStack.push_back(lit);
+
+	while (!analyzeStack.empty())
+	{
+		int var = lit_var(analyzeStack.back());
+		analyzeStack.pop_back();
+
+		uint32_t cref = varReason[var];
+		int *lits = clauseLits(cref);
+		uint32_t size = clauseSize(cref);
+
+		for (uint32_t i = 0; i < size; i++) {
+			int v = lit_var(lits[i]);
+			if (v == var || varSeen[v] || varLevel[v] == 0)
+				continue;
+			if (varReason[v] != CREF_NONE && (abstractLevel(v) & abstractLevels) != 0) {
+				varSeen[v] = 1;
+				analyzeStack.push_back(lits[i]);
+				analyzeToClear.push_back(lits[i]);
+			} else {
+				for (size_t j = top; j < analyzeToClear.size(); j++)
+					varSeen[lit_var(analyzeToClear[j])] = 0;
+				analyzeToClear.resize(top);
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void ezCDCL::analyze(uint32_t confl, int &backtrackLevel, uint32_t &lbd)
+{
+	learntClause.clear();
+	learntClause.push_back(-1);
+
+	int pathCount = 0, p = -1;
+	int index = int(trail.size()) - 1;
+
+	do {
+		if (clauseLearnt(confl)) {
+			bumpClause(confl);
+			uint32_t oldLbd = clauseLbd(confl);
+			if (oldLbd > 2) {
+				uint32_t newLbd = computeLbd(clauseLits(confl), clauseSize(confl));
+				if (newLbd < oldLbd)
+					setClauseLbd(confl, newLbd);
+			}
+		}
+
+		int *lits = clauseLits(confl);
+		uint32_t size = clauseSize(confl);
+		for (uint32_t i = 0; i < size; i++) {
+			int q = lits[i];
+			int var = lit_var(q);
+			if ((p >= 0 && var == lit_var(p)) || varSeen[var] || varLevel[var] == 0)
+				continue;
+			bumpVar(var);
+			varSeen[var] = 1;
+			if (varLevel[var] >= decisionLevel())
+				pathCount++;
+			else
+				learntClause.push_back(q);
+		}
+
+		while (!varSeen[lit_var(trail[index])])
+			index--;
+		p = trail[index--];
+		confl = varReason[lit_var(p)];
+		varSeen[lit_var(p)] = 0;
+		pathCount--;
+	} while (pathCount > 0);
+
+	learntClause[0] = p ^ 1;
+
+	// recursive minimization: drop literals that are implied by the other literals of the learned clause
+	analyzeToClear.assign(learntClause.begin(), learntClause.end());
+	uint32_t abstractLevels = 0;
+	for (size_t i = 1; i < learntClause.size(); i++)
+		abstractLevels |= abstractLevel(lit_var(learntClause[i]));
+
+	size_t j = 1;
+	for (size_t i = 1; i < learntClause.size(); i++) {
+		int var = lit_var(learntClause[i]);
+		if (varReason[var] == CREF_NONE || !litRedundant(learntClause[i], abstractLevels))
+			learntClause[j++] = learntClause[i];
+	}
+	learntClause.resize(j);
+
+	for (int lit : analyzeToClear)
+		varSeen[lit_var(lit)] = 0;
+
+	backtrackLevel = 0;
+	if (learntClause.size() > 1) {
+		size_t maxIndex = 1;
+		for (size_t i = 2; i < learntClause.size(); i++)
+			if (varLevel[lit_var(learntClause[i])] > varLevel[lit_var(learntClause[maxIndex])])
+				maxIndex = i;
+		std::swap(learntClause[1], learntClause[maxIndex]);
+		backtrackLevel = varLevel[lit_var(learntClause[1])];
+	}
+
+	lbd = computeLbd(learntClause.data(), learntClause.size());
+}
+
+int ezCDCL::pickBranchLit()
+{
+	while (!heap.empty()) {
+		int var = heapPop();
+		if (value(2*var) == 0 && !varEliminated[var])
+			return 2*var + (varPhase[var] ? 0 : 1);
+	}
+	return -1;
+}
+
+bool ezCDCL::addClause(const std::vector<int> &clause)
+{
+	std::vector<int> lits;
+	for (int idx : clause)
+		lits.push_back(lit_from_ez(idx));
+	std::sort(lits.begin(), lits.end());
+
+	size_t j = 0;
+	for (size_t i = 0; i < lits.size(); i++) {
+		if (value(lits[i]) > 0 || (i > 0 && lits[i] == (lits[i-1] ^ 1)))
+			return true;
+		if (value(lits[i]) < 0 || (j > 0 && lits[i] == lits[j-1]))
+			continue;
+		lits[j++] = lits[i];
+	}
+	lits.resize(j);
+
+	if (lits.empty())
+		return false;
+
+	if (lits.size() == 1) {
+		assign(lits[0], CREF_NONE);
+		return propagate() == CREF_NONE;
+	}
+
+	uint32_t cref = allocClause(lits, false, 0);
+	clauses.push_back(cref);
+	attachClause(cref);
+	clausesSinceEliminate++;
+	for (int lit : lits)
+		if (!varTouched[lit_var(lit)]) {
+			varTouched[lit_var(lit)] = 1;
+			touchedVars.push_back(lit_var(lit));
+		}
+	return true;
+}
+
+// adds the resolvent at decision level 0 during variable elimination, units are assigned but not yet propagated
+bool ezCDCL::addResolvent()
+{
+	size_t j = 0;
+	for (size_t i = 0; i < resolvent.size(); i++) {
+		if (value(resolvent[i]) > 0)
+			return true;
+		if (value(resolvent[i]) == 0)
+			resolvent[j++] = resolvent[i];
+	}
+	resolvent.resize(j);
+
+	if (resolvent.empty())
+		return false;
+
+	if (resolvent.size() == 1) {
+		assign(resolvent[0], CREF_NONE);
+		return true;
+	}
+
+	uint32_t cref = allocClause(resolvent, false, 0);
+	clauses.push_back(cref);
+	attachClause(cref);
+	for (int lit : resolvent) {
+		occurs[lit].push_back(cref);
+		if (!varTouched[lit_var(lit)]) {
+			varTouched[lit_var(lit)] = 1;
+			touchedVars.push_back(lit_var(lit));
+		}
+	}
+	return true;
+}
+
+// stores the resolvent of the two clauses on var in resolvent, returns false if it is a tautology
+bool ezCDCL::resolve(uint32_t pos, uint32_t neg, int var)
+{
+	stampCounter++;
+	resolvent.clear();
+
+	int *lits = clauseLits(pos);
+	uint32_t size = clauseSize(pos);
+	for (uint32_t i = 0; i < size; i++)
+		if (lit_var(lits[i]) != var) {
+			litStamp[lits[i]] = stampCounter;
+			resolvent.push_back(lits[i]);
+		}
+
+	lits = clauseLits(neg);
+	size = clauseSize(neg);
+	for (uint32_t i = 0; i < size; i++) {
+		int lit = lits[i];
+		if (lit_var(lit) == var || litStamp[lit] == stampCounter)
+			continue;
+		if (litStamp[lit ^ 1] == stampCounter)
+			return false;
+		resolvent.push_back(lit);
+	}
+
+	return true;
+}
+
+// replaces the clauses of var by their resolvents, unless that would increase the number of clauses or create long
+// clauses. returns false if the formula turned out to be unsatisfiable.
+bool ezCDCL::eliminateVar(int var)
+{
+	std::vector<uint32_t> pos, neg;
+	for (auto cref : occurs[2*var])
+		if (!clauseDeleted(cref) && !clauseSatisfied(cref))
+			pos.push_back(cref);
+	for (auto cref : occurs[2*var + 1])
+		if (!clauseDeleted(cref) && !clauseSatisfied(cref))
+			neg.push_back(cref);
+
+	size_t numResolvents = 0;
+	for (auto p : pos)
+		for (auto n : neg)
+			if (resolve(p, n, var) && (++numResolvents > pos.size() + neg.size() || resolvent.size() > 20))
+				return true;
+
+	varEliminated[var] = 1;
+	eliminatedCount++;
+
+	// the clauses of one polarity are enough to extend the model, with the other polarity as default value. each
+	// clause is stored with the literal of var first, followed by its size.
+	bool storePos = pos.size() <= neg.size();
+	int pivot = 2*var + (storePos ? 0 : 1);
+	for (auto cref : storePos ? pos : neg) {
+		int *lits = clauseLits(cref);
+		uint32_t size = clauseSize(cref);
+		elimClauses.push_back(pivot);
+		for (uint32_t i = 0; i < size; i++)
+			if (lits[i] != pivot)
+				elimClauses.push_back(lits[i]);
+		elimClauses.push_back(size);
+	}
+	elimClauses.push_back(pivot ^ 1);
+	elimClauses.push_back(1);
+
+	for (auto p : pos)
+		for (auto n : neg)
+			if (resolve(p, n, var) && !addResolvent())
+				return false;
+
+	for (auto cref : pos)
+		deleteClause(cref);
+	for (auto cref : neg)
+		deleteClause(cref);
+	return true;
+}
+
+// bounded variable elimination on the variables of the clauses added since the last run, repeated for the variables
+// of the resolvents. has to be called at decision level 0. returns false if the formula turned out to be unsatisfiable.
+bool ezCDCL::eliminate(const std::vector<int> &assumptions)
+{
+	std::vector<char> varKeep = varFrozen;
+	for (int lit : assumptions)
+		varKeep[lit_var(lit)] = 1;
+
+	// learned clauses with eliminated variables are removed below, so they must not be reasons
+	for (int lit : trail)
+		varReason[lit_var(lit)] = CREF_NONE;
+
+	occurs.resize(2*numVars());
+	for (auto cref : clauses) {
+		int *lits = clauseLits(cref);
+		for (uint32_t i = 0; i < clauseSize(cref); i++)
+			occurs[lits[i]].push_back(cref);
+	}
+
+	bool ok = true;
+	std::vector<std::pair<size_t, int>> candidates;
+	while (ok && !touchedVars.empty())
+	{
+		candidates.clear();
+		for (int var : touchedVars) {
+			varTouched[var] = 0;
+			if (!varKeep[var] && !varEliminated[var] && value(2*var) == 0)
+				candidates.push_back(std::make_pair(occurs[2*var].size() * occurs[2*var + 1].size(), var));
+		}
+		touchedVars.clear();
+		std::sort(candidates.begin(), candidates.end());
+
+		for (auto &it : candidates)
+			if (value(2*it.second) == 0 && !eliminateVar(it.second)) {
+				ok = false;
+				break;
+			}
+	}
+
+	for (int var : touchedVars)
+		varTouched[var] = 0;
+	touchedVars.clear();
+
+	std::vector<std::vector<uint32_t>>().swap(occurs);
+
+	size_t j = 0;
+	for (size_t i = 0; i < clauses.size(); i++)
+		if (!clauseDeleted(clauses[i]))
+			clauses[j++] = clauses[i];
+	clauses.resize(j);
+
+	j = 0;
+	for (size_t i = 0; i < learnts.size(); i++) {
+		uint32_t cref = learnts[i];
+		int *lits = clauseLits(cref);
+		bool keep = true;
+		for (uint32_t k = 0; k < clauseSize(cref) && keep; k++)
+			keep = !varEliminated[lit_var(lits[k])];
+		if (keep)
+			learnts[j++] = cref;
+		else
+			deleteClause(cref);
+	}
+	learnts.resize(j);
+
+	purgeWatches();
+	if (wastedWords > arena.size() / 5)
+		collectGarbage();
+
+	clausesAtEliminate = clauses.size();
+	clausesSinceEliminate = 0;
+
+	return ok && propagate() == CREF_NONE;
+}
+
+void ezCDCL::extendModel(std::vector<int8_t> &model)
+{
+	for (int i = int(elimClauses.size()) - 1; i >= 0; ) {
+		int size = elimClauses[i];
+		int first = i - size;
+		bool satisfied = false;
+		for (int k = first + 1; k < i && !satisfied; k++) {
+			int lit = elimClauses[k];
+			satisfied = model[lit_var(lit)] != ((lit & 1) ? 1 : -1);
+		}
+		if (!satisfied)
+			model[lit_var(elimClauses[first])] = (elimClauses[first] & 1) ? -1 : 1;
+		i = first - 1;
+	}
+}
+
+void ezCDCL::simplify()
+{
+	// at decision level 0 nothing is ever analyzed, so the reasons can be dropped and any satisfied clause removed
+	for (int lit : trail)
+		varReason[lit_var(lit)] = CREF_NONE;
+
+	auto removeSatisfied = [&](std::vector<uint32_t> &crefs) {
+		size_t j = 0;
+		for (size_t i = 0; i < crefs.size(); i++)
+			if (clauseSatisfied(crefs[i]))
+				deleteClause(crefs[i]);
+			else
+				crefs[j++] = crefs[i];
+		crefs.resize(j);
+	};
+
+	size_t oldWasted = wastedWords;
+	removeSatisfied(clauses);
+	removeSatisfied(learnts);
+	if (wastedWords != oldWasted)
+		purgeWatches();
+	if (wastedWords > arena.size() / 5)
+		collectGarbage();
+
+	simplifyAssigns = trail.size();
+}
+
+void ezCDCL::reduceDB()
+{
+	// keep clauses with an LBD of at most 2 and remove the less useful half of the others
+	std::vector<uint32_t> candidates;
+	size_t j = 0;
+	for (size_t i = 0; i < learnts.size(); i++) {
+		uint32_t cref = learnts[i];
+		if (clauseLbd(cref) <= 2 || clauseLocked(cref))
+			learnts[j++] = cref;
+		else
+			candidates.push_back(cref);
+	}
+	learnts.resize(j);
+
+	std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) {
+		if (clauseLbd(a) != clauseLbd(b))
+			return clauseLbd(a) > clauseLbd(b);
+		return clauseActivity(a) < clauseActivity(b);
+	});
+
+	size_t numRemove = candidates.size() / 2;
+	for (size_t i = 0; i < candidates.size(); i++)
+		if (i < numRemove)
+			deleteClause(candidates[i]);
+		else
+			learnts.push_back(candidates[i]);
+
+	purgeWatches();
+	if (wastedWords > arena.size() / 5)
+		collectGarbage();
+}
+
+ezCDCL::status_t ezCDCL::search(const std::vector<int> &assumptions, int64_t deadline)
+{
+	while (1)
+	{
+		uint32_t confl = propagate();
+
+		if (confl != CREF_NONE)
+		{
+			numConflicts++;
+			if (decisionLevel() == 0) {
+				foundContradiction = true;
+				return STATUS_UNSAT;
+			}
+
+			int backtrackLevel;
+			uint32_t lbd;
+			analyze(confl, backtrackLevel, lbd);
+			cancelUntil(backtrackLevel);
+
+			if (learntClause.size() == 1) {
+				assign(learntClause[0], CREF_NONE);
+			} else {
+				uint32_t cref = allocClause(learntClause, true, lbd);
+				learnts.push_back(cref);
+				attachClause(cref);
+				bumpClause(cref);
+				assign(learntClause[0], cref);
+			}
+
+			varInc /= 0.95;
+			clauseInc /= 0.999;
+
+			// moving averages of the LBD, the slow one is a plain average during the first conflicts
+			lbdFast += (lbd - lbdFast) / std::min<int64_t>(numConflicts, 32);
+			lbdSlow += (lbd - lbdSlow) / std::min<int64_t>(numConflicts, 5000);
+
+			if (deadline >= 0 && (numConflicts & 255) == 0 && now_ms() > deadline)
+				return STATUS_TIMEOUT;
+			continue;
+		}
+
+		if (numConflicts - conflictsAtRestart >= 50 && lbdFast > 1.25 * lbdSlow) {
+			conflictsAtRestart = numConflicts;
+			cancelUntil(0);
+			return STATUS_RESTART;
+		}
+
+		if (decisionLevel() == 0 && int(trail.size()) != simplifyAssigns)
+			simplify();
+
+		if (numConflicts >= nextReduce) {
+			nextReduce = numConflicts + reduceInc;
+			reduceInc += 300;
+			reduceDB();
+		}
+
+		int next = -1;
+		while (decisionLevel() < int(assumptions.size())) {
+			int lit = assumptions[decisionLevel()];
+			if (value(lit) > 0) {
+				newDecisionLevel();
+			} else if (value(lit) < 0) {
+				return STATUS_UNSAT;
+			} else {
+				next = lit;
+				break;
+			}
+		}
+
+		if (next < 0) {
+			next = pickBranchLit();
+			if (next < 0)
+				return STATUS_SAT;
+		}
+
+		newDecisionLevel();
+		assign(next, CREF_NONE);
+	}
+}
+
+bool ezCDCL::solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions)
+{
+	preSolverCallback();
+
+	solverTimoutStatus = false;
+
+	std::vector<int> assumptionIdx, modelIdx;
+
+	for (auto id : assumptions)
+		assumptionIdx.push_back(bind(id));
+	for (auto id : modelExpressions)
+		modelIdx.push_back(bind(id));
+
+	std::vector<std::vector<int>> cnf;
+	consumeCnf(cnf);
+
+	if (foundContradiction)
+		return false;
+
+	while (numVars() < numCnfVariables())
+		newVar();
+
+	for (auto idx : cnfFrozenVars)
+		varFrozen[(idx > 0 ? idx : -idx) - 1] = 1;
+	cnfFrozenVars.clear();
+
+	for (auto &clause : cnf)
+		if (!addClause(clause)) {
+			foundContradiction = true;
+			return false;
+		}
+
+	std::vector<int> assumptionLits;
+	for (auto idx : assumptionIdx)
+		assumptionLits.push_back(lit_from_ez(idx));
+
+	if (!touchedVars.empty() && clausesSinceEliminate >= clausesAtEliminate / 8 && !eliminate(assumptionLits)) {
+		foundContradiction = true;
+		return false;
+	}
+
+	int64_t deadline = solverTimeout > 0 ? now_ms() + 1000 * int64_t(solverTimeout) : -1;
+
+	status_t status;
+	do {
+		status = search(assumptionLits, deadline);
+		if (status == STATUS_RESTART && deadline >= 0 && now_ms() > deadline)
+			status = STATUS_TIMEOUT;
+	} while (status == STATUS_RESTART);
+
+	if (status != STATUS_SAT) {
+		if (status == STATUS_TIMEOUT)
+			solverTimoutStatus = true;
+		cancelUntil(0);
+		return false;
+	}
+
+	std::vector<int8_t> model(numVars());
+	for (int var = 0; var < numVars(); var++)
+		model[var] = value(2*var);
+	extendModel(model);
+
+	modelValues.clear();
+	modelValues.resize(modelIdx.size());
+
+	for (size_t i = 0; i < modelIdx.size(); i++) {
+		int lit = lit_from_ez(modelIdx[i]);
+		modelValues[i] = model[lit_var(lit)] == ((lit & 1) ? -1 : 1);
+	}
+
+	cancelUntil(0);
+	return true;
+}
@@ -0,0 +1,135 @@
+/*
+ *  ezSAT -- A simple and easy to use CNF generator for SAT solvers
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef EZCDCL_H
+#define EZCDCL_H
+
+#include "ezsat.h"
+#include <stdint.h>
+
+// A self-contained incremental CDCL solver: two watched literals with blocking literals and inlined binary clauses,
+// VSIDS, phase saving, glucose style restarts on the LBD moving averages and a clause database reduced by LBD and
+// activity. The solver state including all learned clauses is kept across calls. Before a call that added a
+// significant number of clauses, bounded variable elimination is run on the variables of the new clauses, so just
+// like with ezMiniSAT, variables that are used again after a call to solve() must be frozen.
+
+class ezCDCL : public ezSAT
+{
+private:
+	enum : uint32_t { CREF_NONE = 0xffffffff };
+	enum status_t { STATUS_SAT, STATUS_UNSAT, STATUS_RESTART, STATUS_TIMEOUT };
+
+	struct Watcher {
+		uint32_t cref;
+		int blocker;
+		bool binary;
+	};
+
+	// clause layout in the arena: size, flags (bit 0: learnt, bit 1: deleted, bits 2..: LBD), activity, literals
+	std::vector<uint32_t> arena;
+	std::vector<uint32_t> clauses, learnts;
+	size_t wastedWords;
+
+	std::vector<std::vector<Watcher>> watches;
+	std::vector<int8_t> litValue;
+	std::vector<int> varLevel;
+	std::vector<uint32_t> varReason;
+	std::vector<double> varActivity;
+	std::vector<bool> varPhase;
+	std::vector<char> varSeen;
+	std::vector<int> heap, heapIndex;
+	std::vector<int> trail, trailLim;
+	std::vector<uint64_t> levelStamp;
+	std::vector<int> analyzeStack, analyzeToClear, learntClause;
+	int qhead;
+
+	double varInc, clauseInc;
+	double lbdFast, lbdSlow;
+	int64_t numConflicts, conflictsAtRestart, nextReduce, reduceInc;
+	uint64_t stampCounter;
+	int simplifyAssigns;
+	bool foundContradiction;
+
+	std::vector<int> cnfFrozenVars;
+	std::vector<char> varFrozen, varEliminated, varTouched;
+	std::vector<int> touchedVars;
+	std::vector<std::vector<uint32_t>> occurs;
+	std::vector<uint64_t> litStamp;
+	std::vector<int> elimClauses, resolvent;
+	size_t clausesAtEliminate, clausesSinceEliminate;
+	int eliminatedCount;
+
+	int numVars() const { return int(varLevel.size()); }
+	int decisionLevel() const { return int(trailLim.size()); }
+	int8_t value(int lit) const { return litValue[lit]; }
+
+	uint32_t &clauseSize(uint32_t cref) { return arena[cref]; }
+	int *clauseLits(uint32_t cref) { return reinterpret_cast<int*>(&arena[cref + 3]); }
+	bool clauseLearnt(uint32_t cref) const { return (arena[cref + 1] & 1) != 0; }
+	bool clauseDeleted(uint32_t cref) const { return (arena[cref + 1] & 2) != 0; }
+	uint32_t clauseLbd(uint32_t cref) const { return arena[cref + 1] >> 2; }
+	void setClauseLbd(uint32_t cref, uint32_t lbd) { arena[cref + 1] = (arena[cref + 1] & 3) | (lbd << 2); }
+	float clauseActivity(uint32_t cref) const;
+	void setClauseActivity(uint32_t cref, float activity);
+
+	int newVar();
+	uint32_t allocClause(const std::vector<int> &lits, bool learnt, uint32_t lbd);
+	void attachClause(uint32_t cref);
+	void deleteClause(uint32_t cref);
+	bool clauseLocked(uint32_t cref);
+	bool clauseSatisfied(uint32_t cref);
+	void purgeWatches();
+	void collectGarbage();
+
+	void heapUp(int pos);
+	void heapDown(int pos);
+	void heapInsert(int var);
+	int heapPop();
+
+	void bumpVar(int var);
+	void bumpClause(uint32_t cref);
+	uint32_t computeLbd(const int *lits, int size);
+
+	void assign(int lit, uint32_t reason);
+	void newDecisionLevel();
+	void cancelUntil(int level);
+	uint32_t propagate();
+	void analyze(uint32_t confl, int &backtrackLevel, uint32_t &lbd);
+	bool litRedundant(int lit, uint32_t abstractLevels);
+	uint32_t abstractLevel(int var) const { return 1u << (varLevel[var] & 31); }
+	int pickBranchLit();
+	bool addClause(const std::vector<int> &clause);
+	bool addResolvent();
+	bool resolve(uint32_t pos, uint32_t neg, int var);
+	bool eliminateVar(int var);
+	bool eliminate(const std::vector<int> &assumptions);
+	void extendModel(std::vector<int8_t> &model);
+	void simplify();
+	void reduceDB();
+	status_t search(const std::vector<int> &assumptions, int64_t deadline);
+
+public:
+	ezCDCL();
+	virtual ~ezCDCL();
+	virtual void clear();
+	virtual void freeze(int id);
+	virtual bool eliminated(int idx);
+	virtual bool solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions);
+	virtual int numEliminatedVariables() const;
+};
+
+#endif
@@ -85,6 +85,13 @@ bool ezMiniSAT::eliminated(int idx)
 }
 #endif
 
+#if EZMINISAT_SIMPSOLVER
+int ezMiniSAT::numEliminatedVariables() const
+{
+	return minisatSolver != NULL ? minisatSolver->eliminated_vars : 0;
+}
+#endif
+
 #if defined(HAS_ALARM)
 ezMiniSAT *ezMiniSAT::alarmHandlerThis = NULL;
 clock_t ezMiniSAT::alarmHandlerTimeout = 0;
@@ -66,6 +66,9 @@ public:
 	virtual bool eliminated(int idx);
 #endif
 	virtual bool solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions);
+#if EZMINISAT_SIMPSOLVER
+	virtual int numEliminatedVariables() const;
+#endif
 };
 
 #endif
@@ -46,6 +46,7 @@ ezSAT::ezSAT()
 
 	flag_keep_cnf = false;
 	flag_non_incremental = false;
+	flag_compact_cnf = false;
 
 	non_incremental_solve_used_up = false;
 
@@ -152,6 +153,15 @@ int ezSAT::expression(OpId op, const std::vector<int> &args)
 		myArgs.resize(j+1);
 	}
 
+	if (flag_compact_cnf && (op == OpAnd || op == OpOr)) {
+		int dominant = op == OpAnd ? CONST_FALSE : CONST_TRUE;
+		for (auto arg : myArgs) {
+			int comp = complement(arg);
+			if (arg == dominant || (comp != 0 && std::binary_search(myArgs.begin(), myArgs.end(), comp)))
+				return dominant;
+		}
+	}
+
 	switch (op)
 	{
 	case OpNot:
@@ -160,6 +170,8 @@ int ezSAT::expression(OpId op, const std::vector<int> &args)
 			return CONST_FALSE;
 		if (myArgs[0] == CONST_FALSE)
 			return CONST_TRUE;
+		if (flag_compact_cnf && myArgs[0] < 0 && expressions[-myArgs[0]-1].first == OpNot)
+			return expressions[-myArgs[0]-1].second.at(0);
 		break;
 
 	case OpAnd:
@@ -196,6 +208,14 @@ int ezSAT::expression(OpId op, const std::vector<int> &args)
 			return myArgs[1];
 		if (myArgs[0] == CONST_FALSE)
 			return myArgs[2];
+		if (flag_compact_cnf) {
+			if (myArgs[1] == myArgs[2])
+				return myArgs[1];
+			if (myArgs[1] == CONST_TRUE && myArgs[2] == CONST_FALSE)
+				return myArgs[0];
+			if (myArgs[1] == CONST_FALSE && myArgs[2] == CONST_TRUE)
+				return NOT(myArgs[0]);
+		}
 		break;
 
 	default:
@@ -222,6 +242,18 @@ int ezSAT::expression(OpId op, const std::vector<int> &args)
 	return id;
 }
 
+int ezSAT::complement(int id) const
+{
+	if (id == CONST_TRUE)
+		return CONST_FALSE;
+	if (id == CONST_FALSE)
+		return CONST_TRUE;
+	if (id < 0 && expressions[-id-1].first == OpNot)
+		return expressions[-id-1].second.at(0);
+	auto it = expressionsCache.find(std::pair<OpId, std::vector<int>>(OpNot, std::vector<int>(1, id)));
+	return it != expressionsCache.end() ? it->second : 0;
+}
+
 void ezSAT::lookup_literal(int id, std::string &name) const
 {
 	assert(0 < id && id <= int(literals.size()));
@@ -392,6 +424,7 @@ void ezSAT::clear()
 	cnfClausesCount = 0;
 	cnfLiteralVariables.clear();
 	cnfExpressionVariables.clear();
+	cnfExpressionPolarities.clear();
 	cnfClauses.clear();
 }
 
@@ -421,7 +454,7 @@ void ezSAT::assume(int id)
 			lookup_expression(id, op, args);
 
 			if (op == OpNot) {
-				int idx = bind(args[0]);
+				int idx = bind(args[0], true, flag_compact_cnf ? POLARITY_NEG : POLARITY_BOTH);
 				cnfClauses.push_back(std::vector<int>(1, -idx));
 				cnfClausesCount++;
 				return;
@@ -429,14 +462,14 @@ void ezSAT::assume(int id)
 			if (op == OpOr) {
 				std::vector<int> clause;
 				for (int arg : args)
-					clause.push_back(bind(arg));
+					clause.push_back(bind(arg, true, flag_compact_cnf ? POLARITY_POS : POLARITY_BOTH));
 				cnfClauses.push_back(clause);
 				cnfClausesCount++;
 				return;
 			}
 			if (op == OpAnd) {
 				for (int arg : args) {
-					cnfClauses.push_back(std::vector<int>(1, bind(arg)));
+					cnfClauses.push_back(std::vector<int>(1, bind(arg, true, flag_compact_cnf ? POLARITY_POS : POLARITY_BOTH)));
 					cnfClausesCount++;
 				}
 				return;
@@ -444,7 +477,7 @@ void ezSAT::assume(int id)
 		}
 	}
 
-	int idx = bind(id);
+	int idx = bind(id, true, flag_compact_cnf ? POLARITY_POS : POLARITY_BOTH);
 	cnfClauses.push_back(std::vector<int>(1, idx));
 	cnfClausesCount++;
 }
@@ -491,28 +524,36 @@ int ezSAT::bind_cnf_not(const std::vector<int> &args)
 	return -args[0];
 }
 
-int ezSAT::bind_cnf_and(const std::vector<int> &args)
+int ezSAT::bind_cnf_and(const std::vector<int> &args, int idx, int polarity)
 {
 	assert(args.size() >= 2);
 
-	int idx = ++cnfVariableCount;
-	add_clause(args, false, idx);
+	if (idx == 0)
+		idx = ++cnfVariableCount;
 
-	for (auto arg : args)
-		add_clause(-idx, arg);
+	if (polarity & POLARITY_NEG)
+		add_clause(args, false, idx);
+
+	if (polarity & POLARITY_POS)
+		for (auto arg : args)
+			add_clause(-idx, arg);
 
 	return idx;
 }
 
-int ezSAT::bind_cnf_or(const std::vector<int> &args)
+int ezSAT::bind_cnf_or(const std::vector<int> &args, int idx, int polarity)
 {
 	assert(args.size() >= 2);
 
-	int idx = ++cnfVariableCount;
-	add_clause(args, true, -idx);
+	if (idx == 0)
+		idx = ++cnfVariableCount;
 
-	for (auto arg : args)
-		add_clause(idx, -arg);
+	if (polarity & POLARITY_POS)
+		add_clause(args, true, -idx);
+
+	if (polarity & POLARITY_NEG)
+		for (auto arg : args)
+			add_clause(idx, -arg);
 
 	return idx;
 }
@@ -544,6 +585,11 @@ std::string ezSAT::cnfLiteralInfo(int idx) const
 }
 
 int ezSAT::bind(int id, bool auto_freeze)
+{
+	return bind(id, auto_freeze, POLARITY_BOTH);
+}
+
+int ezSAT::bind(int id, bool auto_freeze, int polarity)
 {
 	addhash(__LINE__);
 	addhash(id);
@@ -568,10 +614,12 @@ int ezSAT::bind(int id, bool auto_freeze)
 
 	assert(0 < -id && -id <= int(expressions.size()));
 	cnfExpressionVariables.resize(expressions.size());
+	cnfExpressionPolarities.resize(expressions.size());
 
 	if (eliminated(cnfExpressionVariables[-id-1]))
 	{
 		cnfExpressionVariables[-id-1] = 0;
+		cnfExpressionPolarities[-id-1] = 0;
 
 		// this will recursively call bind(id). within the recursion
 		// the cnf is pre-set to 0. an idx is allocated there, then it
@@ -580,12 +628,14 @@ int ezSAT::bind(int id, bool auto_freeze)
 			freeze(id);
 	}
 
-	if (cnfExpressionVariables[-id-1] == 0)
+	int missing = polarity & ~cnfExpressionPolarities[-id-1];
+
+	if (missing != 0)
 	{
 		OpId op;
 		std::vector<int> args;
 		lookup_expression(id, op, args);
-		int idx = 0;
+		int idx = 0, argsPolarity = missing;
 
 		if (op == OpXor) {
 			while (args.size() > 1) {
@@ -600,7 +650,7 @@ int ezSAT::bind(int id, bool auto_freeze)
 					}
 				args.swap(newArgs);
 			}
-			idx = bind(args.at(0), false);
+			idx = bind(args.at(0), false, missing);
 			goto assign_idx;
 		}
 
@@ -610,31 +660,35 @@ int ezSAT::bind(int id, bool auto_freeze)
 				invArgs.push_back(NOT(arg));
 			int sub1 = expression(OpAnd, args);
 			int sub2 = expression(OpAnd, invArgs);
-			idx = bind(OR(sub1, sub2), false);
+			idx = bind(OR(sub1, sub2), false, missing);
 			goto assign_idx;
 		}
 
 		if (op == OpITE) {
 			int sub1 = AND(args[0], args[1]);
 			int sub2 = AND(NOT(args[0]), args[2]);
-			idx = bind(OR(sub1, sub2), false);
+			idx = bind(OR(sub1, sub2), false, missing);
 			goto assign_idx;
 		}
 
+		if (op == OpNot)
+			argsPolarity = ((missing & POLARITY_POS) ? POLARITY_NEG : 0) | ((missing & POLARITY_NEG) ? POLARITY_POS : 0);
+
 		for (int i = 0; i < int(args.size()); i++)
-			args[i] = bind(args[i], false);
+			args[i] = bind(args[i], false, argsPolarity);
 
 		switch (op)
 		{
 			case OpNot: idx = bind_cnf_not(args); break;
-			case OpAnd: idx = bind_cnf_and(args); break;
-			case OpOr:  idx = bind_cnf_or(args);  break;
+			case OpAnd: idx = bind_cnf_and(args, cnfExpressionVariables[-id-1], missing); break;
+			case OpOr:  idx = bind_cnf_or(args, cnfExpressionVariables[-id-1], missing);  break;
 			default: abort();
 		}
 
 	assign_idx:
 		assert(idx != 0);
 		cnfExpressionVariables[-id-1] = idx;
+		cnfExpressionPolarities[-id-1] |= missing;
 	}
 
 	return cnfExpressionVariables[-id-1];
@@ -51,6 +51,7 @@ public:
 private:
 	bool flag_keep_cnf;
 	bool flag_non_incremental;
+	bool flag_compact_cnf;
 
 	bool non_incremental_solve_used_up;
 
@@ -63,15 +64,23 @@ private:
 	bool cnfConsumed;
 	int cnfVariableCount, cnfClausesCount;
 	std::vector<int> cnfLiteralVariables, cnfExpressionVariables;
+	std::vector<int> cnfExpressionPolarities;
 	std::vector<std::vector<int>> cnfClauses, cnfClausesBackup;
 
 	void add_clause(const std::vector<int> &args);
 	void add_clause(const std::vector<int> &args, bool argsPolarity, int a = 0, int b = 0, int c = 0);
 	void add_clause(int a, int b = 0, int c = 0);
 
+	// in compact_cnf mode only the halves of the Tseitin definition of an
+	// expression are generated that are required by the polarities in which
+	// it is used (Plaisted-Greenbaum encoding), tracked by these bits.
+	enum { POLARITY_POS = 1, POLARITY_NEG = 2, POLARITY_BOTH = 3 };
+
 	int bind_cnf_not(const std::vector<int> &args);
-	int bind_cnf_and(const std::vector<int> &args);
-	int bind_cnf_or(const std::vector<int> &args);
+	int bind_cnf_and(const std::vector<int> &args, int idx, int polarity);
+	int bind_cnf_or(const std::vector<int> &args, int idx, int polarity);
+	int bind(int id, bool auto_freeze, int polarity);
+	int complement(int id) const;
 
 protected:
 	void preSolverCallback();
@@ -88,9 +97,11 @@ public:
 
 	void keep_cnf() { flag_keep_cnf = true; }
 	void non_incremental() { flag_non_incremental = true; }
+	void compact_cnf() { flag_compact_cnf = true; }
 
 	bool mode_keep_cnf() const { return flag_keep_cnf; }
 	bool mode_non_incremental() const { return flag_non_incremental; }
+	bool mode_compact_cnf() const { return flag_compact_cnf; }
 
 	// manage expressions
 
@@ -169,6 +180,7 @@ public:
 
 	int numCnfVariables() const { return cnfVariableCount; }
 	int numCnfClauses() const { return cnfClausesCount; }
+	virtual int numEliminatedVariables() const { return 0; }
 	const std::vector<std::vector<int>> &cnf() const { return cnfClauses; }
 
 	void consumeCnf();
@@ -810,11 +810,12 @@ unsigned char already_in_close; /* in case control-c handlers interrupt */
 
 #ifdef FST_WRITER_PARALLEL
 pthread_mutex_t mutex;
+pthread_cond_t cond; /* signalled when the flush thread is done */
 pthread_t thread;
 pthread_attr_t thread_attr;
 struct fstWriterContext *xc_parent;
 #endif
-unsigned in_pthread : 1;
+unsigned char in_pthread; /* not a bitfield, it is written by the flush thread */
 
 size_t fst_orig_break_size;
 size_t fst_orig_break_add_size;
@@ -1190,6 +1191,7 @@ if((!nam)||
                 xc->nan = strtod("NaN", NULL);
 #ifdef FST_WRITER_PARALLEL
                 pthread_mutex_init(&xc->mutex, NULL);
+                pthread_cond_init(&xc->cond, NULL);
                 pthread_attr_init(&xc->thread_attr);
                 pthread_attr_setdetachstate(&xc->thread_attr, PTHREAD_CREATE_DETACHED);
 #endif
@@ -1808,6 +1810,21 @@ xc->already_in_flush = 0;
 
 
 #ifdef FST_WRITER_PARALLEL
+/*
+ * waits until the flush thread of the previous block (if any) is done, after which
+ * the fields of the parent context it updates can be read again
+ */
+static void fstWriterWaitForFlushThread(struct fstWriterContext *xc)
+{
+pthread_mutex_lock(&xc->mutex);
+while(xc->in_pthread)
+        {
+        pthread_cond_wait(&xc->cond, &xc->mutex);
+        }
+pthread_mutex_unlock(&xc->mutex);
+}
+
+
 static void *fstWriterFlushContextPrivate1(void *ctx)
 {
 struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
@@ -1826,6 +1843,7 @@ xc_parent = xc->xc_parent;
 free(xc);
 
 xc_parent->in_pthread = 0;
+pthread_cond_signal(&(xc_parent->cond));
 pthread_mutex_unlock(&(xc_parent->mutex));
 
 return(NULL);
@@ -1841,8 +1859,9 @@ if(xc->parallel_enabled)
         struct fstWriterContext *xc2 = (struct fstWriterContext *)malloc(sizeof(struct fstWriterContext));
         unsigned int i;
 
-        pthread_mutex_lock(&xc->mutex);
-        pthread_mutex_unlock(&xc->mutex);
+        /* only one block is in flight: the thread of the previous block updates the checkpoint
+           in curval mem and fields of the parent context (e.g. section_start) that are copied here */
+        fstWriterWaitForFlushThread(xc);
 
         xc->xc_parent = xc;
         memcpy(xc2, xc, sizeof(struct fstWriterContext));
@@ -1883,12 +1902,6 @@ if(xc->parallel_enabled)
         xc->section_header_only = 0;
         xc->secnum++;
 
-	while (xc->in_pthread) 
-		{ 
-		pthread_mutex_lock(&xc->mutex); 
-		pthread_mutex_unlock(&xc->mutex); 
-		};
-
         pthread_mutex_lock(&xc->mutex);
 	xc->in_pthread = 1;
         pthread_mutex_unlock(&xc->mutex);
@@ -1899,8 +1912,7 @@ if(xc->parallel_enabled)
         {
         if(xc->parallel_was_enabled) /* conservatively block */
                 {
-                pthread_mutex_lock(&xc->mutex);
-                pthread_mutex_unlock(&xc->mutex);
+                fstWriterWaitForFlushThread(xc);
                 }
 
         xc->xc_parent = xc;
@@ -1936,8 +1948,7 @@ struct fstWriterContext *xc = (struct fstWriterContext *)ctx;
 #ifdef FST_WRITER_PARALLEL
 if(xc)
         {
-        pthread_mutex_lock(&xc->mutex);
-        pthread_mutex_unlock(&xc->mutex);
+        fstWriterWaitForFlushThread(xc);
         }
 #endif
 
@@ -1971,14 +1982,7 @@ if(xc && !xc->already_in_close && !xc->already_in_flush)
                                 }
                         fstWriterFlushContextPrivate(xc);
 #ifdef FST_WRITER_PARALLEL
-                        pthread_mutex_lock(&xc->mutex);
-                        pthread_mutex_unlock(&xc->mutex);
-
-			while (xc->in_pthread) 
-				{ 
-				pthread_mutex_lock(&xc->mutex); 
-				pthread_mutex_unlock(&xc->mutex); 
-				};
+                        fstWriterWaitForFlushThread(xc);
 #endif
                         }
                 }
@@ -2269,6 +2273,7 @@ if(xc && !xc->already_in_close && !xc->already_in_flush)
 
 #ifdef FST_WRITER_PARALLEL
         pthread_mutex_destroy(&xc->mutex);
+        pthread_cond_destroy(&xc->cond);
         pthread_attr_destroy(&xc->thread_attr);
 #endif
 
@@ -20,6 +20,7 @@
 #include "kernel/yosys.h"
 #include "frontends/verilog/preproc.h"
 #include "frontends/ast/ast.h"
+#include "passes/techmap/libparse.h"
 
 YOSYS_NAMESPACE_BEGIN
 
@@ -42,7 +43,8 @@ struct DesignPass : public Pass {
 		log("\n");
 		log("    design -reset\n");
 		log("\n");
-		log("Clear the current design.\n");
+		log("Clear the current design. This also drops the liberty files that were parsed\n");
+		log("and kept for reuse by commands like dfflibmap, clockgate and stat.\n");
 		log("\n");
 		log("\n");
 		log("    design -save <name>\n");
@@ -369,6 +371,8 @@ struct DesignPass : public Pass {
 			design->selected_active_module.clear();
 
 			design->selection_stack.push_back(RTLIL::Selection());
+
+			LibertyCache::clear();
 		}
 
 		if (reset_mode || reset_vlog_mode || !load_name.empty() || push_mode || pop_mode)
@@ -54,6 +54,74 @@ static bool match_ids(RTLIL::IdString id, const std::string &pattern)
 	return false;
 }
 
+// A pattern for match_ids(), prepared once per selection statement. Patterns
+// without wildcards are compared by IdString index instead of as strings, and
+// unless the '$' suffix rule applies, the matching objects can be looked up by
+// name instead of scanning the module.
+struct IdPattern
+{
+	std::string pattern;
+	bool literal, dollar_suffix, use_cache;
+	std::vector<RTLIL::IdString> names;
+	dict<RTLIL::IdString, bool> cache;
+
+	IdPattern(const std::string &pattern, bool use_cache = false) : pattern(pattern), use_cache(use_cache)
+	{
+		literal = pattern.find_first_of("*?[\\") == std::string::npos;
+		dollar_suffix = !pattern.empty() && pattern[0] == '$';
+
+		if (!literal || pattern.empty())
+			return;
+		for (char c : pattern)
+			if ((unsigned char)c <= ' ')
+				return;
+		if (pattern[0] == '$' && pattern.size() > 1)
+			names.push_back(pattern);
+		names.push_back("\\" + pattern);
+	}
+
+	bool direct() const
+	{
+		return literal && !dollar_suffix;
+	}
+
+	bool match(RTLIL::IdString id)
+	{
+		if (literal) {
+			for (auto &name : names)
+				if (id == name)
+					return true;
+			if (dollar_suffix && id.begins_with("$"))
+				return pattern == strrchr(id.c_str(), '$');
+			return false;
+		}
+
+		if (!use_cache)
+			return match_ids(id, pattern);
+
+		auto it = cache.find(id);
+		if (it != cache.end())
+			return it->second;
+		return cache[id] = match_ids(id, pattern);
+	}
+};
+
+template<typename T, typename F>
+static void for_matching(const dict<RTLIL::IdString, T*> &objects, IdPattern &pat, F f)
+{
+	if (pat.direct()) {
+		for (auto &name : pat.names) {
+			auto it = objects.find(name);
+			if (it != objects.end())
+				f(it->second);
+		}
+		return;
+	}
+	for (auto &it : objects)
+		if (pat.match(it.first))
+			f(it.second);
+}
+
 static bool match_attr_val(const RTLIL::Const &value, const std::string &pattern, char match_op)
 {
 	if (match_op == 0)
@@ -431,6 +499,220 @@ static int parse_comma_list(std::set<RTLIL::IdString> &tokens, const std::string
 	}
 }
 
+// Connectivity of a module for the expand operators (%x, %ci, %co, ...), with
+// wires and cells numbered densely. It only depends on the module, so it is
+// built on first use and kept until the end of the selection command.
+struct ConnIndex
+{
+	struct Port {
+		RTLIL::IdString name;
+		std::vector<int> wires;
+	};
+
+	std::vector<RTLIL::Wire*> wires;
+	std::vector<RTLIL::Cell*> cells;
+	dict<RTLIL::IdString, int> wire_ids, cell_ids;
+
+	std::vector<std::vector<Port>> cell_ports;
+	// (cell, port) pairs connected to each wire
+	std::vector<std::vector<std::pair<int, int>>> wire_ports;
+	// wires on the other side of module connections, by lhs and by rhs wire
+	std::vector<std::vector<int>> conn_rhs, conn_lhs;
+
+	ConnIndex(RTLIL::Module *mod)
+	{
+		for (auto wire : mod->wires()) {
+			wire_ids[wire->name] = GetSize(wires);
+			wires.push_back(wire);
+		}
+		wire_ports.resize(GetSize(wires));
+		conn_rhs.resize(GetSize(wires));
+		conn_lhs.resize(GetSize(wires));
+
+		for (auto &conn : mod->connections()) {
+			int last_l = -1, last_r = -1;
+			for (int i = 0; i < GetSize(conn.first); i++) {
+				RTLIL::SigBit bit_l = conn.first[i], bit_r = conn.second[i];
+				if (bit_l.wire == nullptr || bit_r.wire == nullptr)
+					continue;
+				int l = wire_ids.at(bit_l.wire->name), r = wire_ids.at(bit_r.wire->name);
+				if (l == last_l && r == last_r)
+					continue;
+				conn_rhs[l].push_back(r);
+				conn_lhs[r].push_back(l);
+				last_l = l, last_r = r;
+			}
+		}
+
+		for (auto cell : mod->cells()) {
+			int cell_id = GetSize(cells);
+			cell_ids[cell->name] = cell_id;
+			cells.push_back(cell);
+			cell_ports.emplace_back();
+			for (auto &conn : cell->connections()) {
+				Port port;
+				port.name = conn.first;
+				for (auto &chunk : conn.second.chunks())
+					if (chunk.wire != nullptr)
+						port.wires.push_back(wire_ids.at(chunk.wire->name));
+				for (int w : port.wires)
+					wire_ports[w].push_back(std::make_pair(cell_id, GetSize(cell_ports.back())));
+				cell_ports.back().push_back(std::move(port));
+			}
+		}
+	}
+};
+
+static std::map<RTLIL::Module*, ConnIndex> conn_index_cache;
+
+static ConnIndex &conn_index(RTLIL::Module *mod)
+{
+	auto it = conn_index_cache.find(mod);
+	if (it == conn_index_cache.end())
+		it = conn_index_cache.emplace(mod, ConnIndex(mod)).first;
+	return it->second;
+}
+
+// The design may change between selection commands, so the cache is dropped
+// when a command starts and when it ends.
+struct ConnIndexScope
+{
+	ConnIndexScope() { conn_index_cache.clear(); }
+	~ConnIndexScope() { conn_index_cache.clear(); }
+};
+
+// Expansion without an object limit: the selection of each module is held in
+// bit vectors over the ConnIndex numbering, and each level only visits the
+// objects added by the previous one. This selects the same objects as running
+// the generic select_op_expand() below level by level.
+static void select_op_expand_indexed(RTLIL::Design *design, RTLIL::Selection &lhs, std::vector<expand_rule_t> &rules, std::set<RTLIL::IdString> &limits, int levels, char mode, CellTypes &ct, bool eval_only)
+{
+	enum { PORT_INCLUDE = 1, PORT_INPUT = 2, PORT_OUTPUT = 4 };
+	dict<std::pair<RTLIL::IdString, RTLIL::IdString>, int> port_flags_cache;
+
+	auto port_flags = [&](RTLIL::Cell *cell, RTLIL::IdString port) {
+		auto key = std::make_pair(cell->type, port);
+		auto it = port_flags_cache.find(key);
+		if (it != port_flags_cache.end())
+			return it->second;
+
+		bool include = true;
+		if (eval_only && !yosys_celltypes.cell_evaluable(cell->type))
+			include = false;
+		else {
+			char last_mode = '-';
+			bool matched = false;
+			for (auto &rule : rules) {
+				last_mode = rule.mode;
+				if (rule.cell_types.size() > 0 && rule.cell_types.count(cell->type) == 0)
+					continue;
+				if (rule.port_names.size() > 0 && rule.port_names.count(port) == 0)
+					continue;
+				include = rule.mode == '+';
+				matched = true;
+				break;
+			}
+			if (!matched && last_mode == '+')
+				include = false;
+		}
+
+		int flags = 0;
+		if (include)
+			flags |= PORT_INCLUDE;
+		if (mode == 'x' || ct.cell_input(cell->type, port))
+			flags |= PORT_INPUT;
+		if (mode == 'x' || ct.cell_output(cell->type, port))
+			flags |= PORT_OUTPUT;
+		return port_flags_cache[key] = flags;
+	};
+
+	// port direction towards the cell when expanding from a wire, and away from it when expanding from a cell
+	int to_cell = mode == 'x' ? PORT_INCLUDE : mode == 'i' ? PORT_OUTPUT : PORT_INPUT;
+	int from_cell = mode == 'x' ? PORT_INCLUDE : mode == 'i' ? PORT_INPUT : PORT_OUTPUT;
+
+	for (auto mod : design->modules())
+	{
+		if (lhs.selected_whole_module(mod->name) || !lhs.selected_module(mod->name))
+			continue;
+
+		ConnIndex &index = conn_index(mod);
+		auto &members = lhs.selected_members[mod->name];
+
+		std::vector<bool> wire_sel(GetSize(index.wires)), cell_sel(GetSize(index.cells));
+		std::vector<int> wire_front, cell_front, wire_next, cell_next, wire_added, cell_added;
+
+		for (auto &name : members) {
+			auto it = index.wire_ids.find(name);
+			if (it != index.wire_ids.end()) {
+				wire_sel[it->second] = true;
+				wire_front.push_back(it->second);
+				continue;
+			}
+			it = index.cell_ids.find(name);
+			if (it != index.cell_ids.end()) {
+				cell_sel[it->second] = true;
+				cell_front.push_back(it->second);
+			}
+		}
+
+		auto add_wire = [&](int w) {
+			if (!wire_sel[w]) {
+				wire_sel[w] = true;
+				wire_next.push_back(w);
+				wire_added.push_back(w);
+			}
+		};
+		auto add_cell = [&](int c) {
+			if (!cell_sel[c]) {
+				cell_sel[c] = true;
+				cell_next.push_back(c);
+				cell_added.push_back(c);
+			}
+		};
+
+		for (int level = 0; level < levels && (!wire_front.empty() || !cell_front.empty()); level++)
+		{
+			for (int w : wire_front) {
+				if (limits.count(index.wires[w]->name))
+					continue;
+				if (mode != 'i')
+					for (int l : index.conn_lhs[w])
+						add_wire(l);
+				if (mode != 'o')
+					for (int r : index.conn_rhs[w])
+						add_wire(r);
+				for (auto &it : index.wire_ports[w]) {
+					int flags = port_flags(index.cells[it.first], index.cell_ports[it.first][it.second].name);
+					if ((flags & PORT_INCLUDE) && (flags & to_cell))
+						add_cell(it.first);
+				}
+			}
+
+			for (int c : cell_front) {
+				RTLIL::Cell *cell = index.cells[c];
+				if (limits.count(cell->name))
+					continue;
+				for (auto &port : index.cell_ports[c]) {
+					int flags = port_flags(cell, port.name);
+					if ((flags & PORT_INCLUDE) && (flags & from_cell))
+						for (int w : port.wires)
+							add_wire(w);
+				}
+			}
+
+			wire_front.swap(wire_next);
+			cell_front.swap(cell_next);
+			wire_next.clear();
+			cell_next.clear();
+		}
+
+		for (int w : wire_added)
+			members.insert(index.wires[w]->name);
+		for (int c : cell_added)
+			members.insert(index.cells[c]->name);
+	}
+}
+
 static int select_op_expand(RTLIL::Design *design, RTLIL::Selection &lhs, std::vector<expand_rule_t> &rules, std::set<RTLIL::IdString> &limits, int max_objects, char mode, CellTypes &ct, bool eval_only)
 {
 	int sel_objects = 0;
@@ -593,6 +875,11 @@ static void select_op_expand(RTLIL::Design *design, const std::string &arg, char
 	}
 #endif
 
+	if (rem_objects < 0) {
+		select_op_expand_indexed(design, work_stack.back(), rules, limits, levels, mode, ct, eval_only);
+		return;
+	}
+
 	while (levels-- > 0 && rem_objects != 0) {
 		int num_objects = select_op_expand(design, work_stack.back(), rules, limits, rem_objects, mode, ct, eval_only);
 		if (num_objects == 0)
@@ -804,6 +1091,14 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 		return;
 	}
 
+	// Patterns are prepared once for all modules. Cell types repeat a lot, so
+	// the result of matching a type is cached.
+	std::string memb_pat_str = arg_memb;
+	if (isprefixed(arg_memb) && strchr("wioxmctpn", arg_memb[0]))
+		memb_pat_str = arg_memb.substr(2);
+	IdPattern mod_pat(arg_mod.compare(0, 2, "N:") == 0 ? arg_mod.substr(2) : arg_mod);
+	IdPattern memb_pat(memb_pat_str, arg_memb.compare(0, 2, "t:") == 0);
+
 	sel.full_selection = false;
 	for (auto mod : design->modules())
 	{
@@ -815,10 +1110,10 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 				continue;
 		} else
 		if (arg_mod.compare(0, 2, "N:") == 0) {
-			if (!match_ids(mod->name, arg_mod.substr(2)))
+			if (!mod_pat.match(mod->name))
 				continue;
 		} else
-		if (!match_ids(mod->name, arg_mod))
+		if (!mod_pat.match(mod->name))
 			continue;
 		else
 			arg_mod_found[arg_mod] = true;
@@ -828,25 +1123,29 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 			continue;
 		}
 
+		auto &members = sel.selected_members[mod->name];
+		auto select_wire = [&](RTLIL::Wire *wire) { members.insert(wire->name); };
+
 		if (arg_memb.compare(0, 2, "w:") == 0) {
-			for (auto wire : mod->wires())
-				if (match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			for_matching(mod->wires_, memb_pat, select_wire);
 		} else
 		if (arg_memb.compare(0, 2, "i:") == 0) {
-			for (auto wire : mod->wires())
-				if (wire->port_input && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			for_matching(mod->wires_, memb_pat, [&](RTLIL::Wire *wire) {
+				if (wire->port_input)
+					members.insert(wire->name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "o:") == 0) {
-			for (auto wire : mod->wires())
-				if (wire->port_output && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			for_matching(mod->wires_, memb_pat, [&](RTLIL::Wire *wire) {
+				if (wire->port_output)
+					members.insert(wire->name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "x:") == 0) {
-			for (auto wire : mod->wires())
-				if ((wire->port_input || wire->port_output) && match_ids(wire->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+			for_matching(mod->wires_, memb_pat, [&](RTLIL::Wire *wire) {
+				if (wire->port_input || wire->port_output)
+					members.insert(wire->name);
+			});
 		} else
 		if (arg_memb.compare(0, 2, "s:") == 0) {
 			size_t delim = arg_memb.substr(2).find(':');
@@ -854,7 +1153,7 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 				int width = atoi(arg_memb.substr(2).c_str());
 				for (auto wire : mod->wires())
 					if (wire->width == width)
-						sel.selected_members[mod->name].insert(wire->name);
+						members.insert(wire->name);
 			} else {
 				std::string min_str = arg_memb.substr(2, delim);
 				std::string max_str = arg_memb.substr(2+delim+1);
@@ -862,18 +1161,14 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 				int max_width = max_str.empty() ? -1 : atoi(max_str.c_str());
 				for (auto wire : mod->wires())
 					if (min_width <= wire->width && (wire->width <= max_width || max_width == -1))
-						sel.selected_members[mod->name].insert(wire->name);
+						members.insert(wire->name);
 			}
 		} else
 		if (arg_memb.compare(0, 2, "m:") == 0) {
-			for (auto &it : mod->memories)
-				if (match_ids(it.first, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(it.first);
+			for_matching(mod->memories, memb_pat, [&](RTLIL::Memory *mem) { members.insert(mem->name); });
 		} else
 		if (arg_memb.compare(0, 2, "c:") == 0) {
-			for (auto cell : mod->cells())
-				if (match_ids(cell->name, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(cell->name);
+			for_matching(mod->cells_, memb_pat, [&](RTLIL::Cell *cell) { members.insert(cell->name); });
 		} else
 		if (arg_memb.compare(0, 2, "t:") == 0) {
 			if (arg_memb.compare(2, 1, "@") == 0) {
@@ -884,63 +1179,51 @@ static void select_stmt(RTLIL::Design *design, std::string arg, bool disable_emp
 				auto &muster = design->selection_vars[set_name];
 				for (auto cell : mod->cells())
 					if (muster.selected_modules.count(cell->type))
-						sel.selected_members[mod->name].insert(cell->name);
+						members.insert(cell->name);
 			} else {
 				for (auto cell : mod->cells())
-					if (match_ids(cell->type, arg_memb.substr(2)))
-						sel.selected_members[mod->name].insert(cell->name);
+					if (memb_pat.match(cell->type))
+						members.insert(cell->name);
 			}
 		} else
 		if (arg_memb.compare(0, 2, "p:") == 0) {
-			for (auto &it : mod->processes)
-				if (match_ids(it.first, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(it.first);
+			for_matching(mod->processes, memb_pat, [&](RTLIL::Process *proc) { members.insert(proc->name); });
 		} else
 		if (arg_memb.compare(0, 2, "a:") == 0) {
 			for (auto wire : mod->wires())
 				if (match_attr(wire->attributes, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(wire->name);
+					members.insert(wire->name);
 			for (auto &it : mod->memories)
 				if (match_attr(it.second->attributes, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(it.first);
+					members.insert(it.first);
 			for (auto cell : mod->cells())
 				if (match_attr(cell->attributes, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(cell->name);
+					members.insert(cell->name);
 			for (auto &it : mod->processes)
 				if (match_attr(it.second->attributes, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(it.first);
+					members.insert(it.first);
 		} else
 		if (arg_memb.compare(0, 2, "r:") == 0) {
 			for (auto cell : mod->cells())
 				if (match_attr(cell->parameters, arg_memb.substr(2)))
-					sel.selected_members[mod->name].insert(cell->name);
+					members.insert(cell->name);
 		} else {
 			std::string orig_arg_memb = arg_memb;
-			if (arg_memb.compare(0, 2, "n:") == 0)
-				arg_memb = arg_memb.substr(2);
-			for (auto wire : mod->wires())
-				if (match_ids(wire->name, arg_memb)) {
-					sel.selected_members[mod->name].insert(wire->name);
-					arg_memb_found[orig_arg_memb] = true;
-				}
-			for (auto &it : mod->memories)
-				if (match_ids(it.first, arg_memb)) {
-					sel.selected_members[mod->name].insert(it.first);
-					arg_memb_found[orig_arg_memb] = true;
-				}
-			for (auto cell : mod->cells())
-				if (match_ids(cell->name, arg_memb)) {
-					sel.selected_members[mod->name].insert(cell->name);
-					arg_memb_found[orig_arg_memb] = true;
-				}
-			for (auto &it : mod->processes)
-				if (match_ids(it.first, arg_memb)) {
-					sel.selected_members[mod->name].insert(it.first);
-					arg_memb_found[orig_arg_memb] = true;
-				}
+			auto select_found = [&](RTLIL::IdString name) {
+				members.insert(name);
+				arg_memb_found[orig_arg_memb] = true;
+			};
+			for_matching(mod->wires_, memb_pat, [&](RTLIL::Wire *wire) { select_found(wire->name); });
+			for_matching(mod->memories, memb_pat, [&](RTLIL::Memory *mem) { select_found(mem->name); });
+			for_matching(mod->cells_, memb_pat, [&](RTLIL::Cell *cell) { select_found(cell->name); });
+			for_matching(mod->processes, memb_pat, [&](RTLIL::Process *proc) { select_found(proc->name); });
 		}
+
+		if (members.empty())
+			sel.selected_members.erase(mod->name);
 	}
 
+
 	select_filter_active_mod(design, work_stack.back());
 
 	for (auto &it : arg_mod_found) {
@@ -986,6 +1269,7 @@ YOSYS_NAMESPACE_BEGIN
 // used in kernel/register.cc and maybe other locations, extern decl. in register.h
 void handle_extra_select_args(Pass *pass, const vector<string> &args, size_t argidx, size_t args_size, RTLIL::Design *design)
 {
+	ConnIndexScope conn_index_scope;
 	work_stack.clear();
 	for (; argidx < args_size; argidx++) {
 		if (args[argidx].compare(0, 1, "-") == 0) {
@@ -1009,6 +1293,7 @@ void handle_extra_select_args(Pass *pass, const vector<string> &args, size_t arg
 // extern decl. in register.h
 RTLIL::Selection eval_select_args(const vector<string> &args, RTLIL::Design *design)
 {
+	ConnIndexScope conn_index_scope;
 	work_stack.clear();
 	for (auto &arg : args)
 		select_stmt(design, arg);
@@ -1024,6 +1309,7 @@ RTLIL::Selection eval_select_args(const vector<string> &args, RTLIL::Design *des
 // extern decl. in register.h
 void eval_select_op(vector<RTLIL::Selection> &work, const string &op, RTLIL::Design *design)
 {
+	ConnIndexScope conn_index_scope;
 	work_stack.swap(work);
 	select_stmt(design, op);
 	work_stack.swap(work);
@@ -1289,6 +1575,7 @@ struct SelectPass : public Pass {
 		std::string write_file, read_file;
 		std::string set_name, unset_name, sel_str;
 
+		ConnIndexScope conn_index_scope;
 		work_stack.clear();
 
 		size_t argidx;
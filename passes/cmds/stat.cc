@@ -347,15 +347,12 @@ statdata_t hierarchy_worker(std::map<RTLIL::IdString, statdata_t> &mod_stat, RTL
 
 void read_liberty_cellarea(dict<IdString, cell_area_t> &cell_area, string liberty_file)
 {
-	std::ifstream f;
-	f.open(liberty_file.c_str());
 	yosys_input_files.insert(liberty_file);
-	if (f.fail())
-		log_cmd_error("Can't open liberty file `%s': %s\n", liberty_file.c_str(), strerror(errno));
-	LibertyParser libparser(f);
-	f.close();
+	std::shared_ptr<const LibertyAst> ast = LibertyCache::load(liberty_file);
+	if (ast == nullptr)
+		return;
 
-	for (auto cell : libparser.ast->children)
+	for (auto cell : ast->children)
 	{
 		if (cell->id != "cell" || cell->args.size() != 1)
 			continue;
@@ -40,11 +40,13 @@ struct EquivSimpleWorker
 
 	pool<pair<Cell*, int>> imported_cells_cache;
 
-	EquivSimpleWorker(const vector<Cell*> &equiv_cells, SigMap &sigmap, dict<SigBit, Cell*> &bit2driver, int max_seq, bool short_cones, bool verbose, bool model_undef) :
+	EquivSimpleWorker(const vector<Cell*> &equiv_cells, SigMap &sigmap, dict<SigBit, Cell*> &bit2driver, int max_seq, bool short_cones, bool verbose, bool model_undef, bool compact_cnf) :
 			module(equiv_cells.front()->module), equiv_cells(equiv_cells), equiv_cell(nullptr),
 			sigmap(sigmap), bit2driver(bit2driver), satgen(ez.get(), &sigmap), max_seq(max_seq), short_cones(short_cones), verbose(verbose)
 	{
 		satgen.model_undef = model_undef;
+		if (compact_cnf)
+			ez->compact_cnf();
 	}
 
 	bool find_input_cone(pool<SigBit> &next_seed, pool<Cell*> &cells_cone, pool<SigBit> &bits_cone, const pool<Cell*> &cells_stop, const pool<SigBit> &bits_stop, pool<SigBit> *input_bits, Cell *cell)
@@ -301,11 +303,18 @@ struct EquivSimplePass : public Pass {
 		log("    -seq <N>\n");
 		log("        the max. number of time steps to be considered (default = 1)\n");
 		log("\n");
+		log("    -compact\n");
+		log("        fold complementary and redundant subexpressions and generate only the\n");
+		log("        halves of the CNF definitions of internal signals that are actually\n");
+		log("        constrained (Plaisted-Greenbaum encoding). The total CNF size and the\n");
+		log("        number of variables eliminated by the solver are logged in any case.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, Design *design) override
 	{
-		bool verbose = false, short_cones = false, model_undef = false, nogroup = false;
+		bool verbose = false, short_cones = false, model_undef = false, nogroup = false, compact_cnf = false;
 		int success_counter = 0;
+		int cnf_variables = 0, cnf_clauses = 0, eliminated_variables = 0;
 		int max_seq = 1;
 
 		log_header(design, "Executing EQUIV_SIMPLE pass.\n");
@@ -328,6 +337,10 @@ struct EquivSimplePass : public Pass {
 				nogroup = true;
 				continue;
 			}
+			if (args[argidx] == "-compact") {
+				compact_cnf = true;
+				continue;
+			}
 			if (args[argidx] == "-seq" && argidx+1 < args.size()) {
 				max_seq = atoi(args[++argidx].c_str());
 				continue;
@@ -383,11 +396,17 @@ struct EquivSimplePass : public Pass {
 				for (auto it2 : it.second)
 					cells.push_back(it2.second);
 
-				EquivSimpleWorker worker(cells, sigmap, bit2driver, max_seq, short_cones, verbose, model_undef);
+				EquivSimpleWorker worker(cells, sigmap, bit2driver, max_seq, short_cones, verbose, model_undef, compact_cnf);
 				success_counter += worker.run();
+				cnf_variables += worker.ez->numCnfVariables();
+				cnf_clauses += worker.ez->numCnfClauses();
+				eliminated_variables += worker.ez->numEliminatedVariables();
 			}
 		}
 
+		if (cnf_variables > 0)
+			log("Generated %d CNF variables and %d clauses, %d variables were eliminated by the solver.\n",
+					cnf_variables, cnf_clauses, eliminated_variables);
 		log("Proved %d previously unproven $equiv cells.\n", success_counter);
 	}
 } EquivSimplePass;
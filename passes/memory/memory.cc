@@ -19,6 +19,7 @@
 
 #include "kernel/register.h"
 #include "kernel/log.h"
+#include "kernel/qcsat.h"
 #include <stdlib.h>
 #include <stdio.h>
 
@@ -52,6 +53,10 @@ struct MemoryPass : public Pass {
 		log("This converts memories to word-wide DFFs and address decoders\n");
 		log("or multiport memory blocks if called with the -nomap option.\n");
 		log("\n");
+		log("The SAT solvers of opt_mem_priority, memory_dff and memory_share are shared\n");
+		log("between these passes, so that input cones that do not change in between are\n");
+		log("only imported once.\n");
+		log("\n");
 	}
 	void execute(std::vector<std::string> args, RTLIL::Design *design) override
 	{
@@ -105,6 +110,8 @@ struct MemoryPass : public Pass {
 		}
 		extra_args(args, argidx, design);
 
+		QuickConeSatCache qcsat_cache(design);
+
 		Pass::call(design, "opt_mem");
 		Pass::call(design, "opt_mem_priority");
 		Pass::call(design, "opt_mem_feedback");
@@ -378,7 +378,8 @@ struct MemoryShareWorker
 
 			// Okay, time to actually run the SAT solver.
 
-			QuickConeSat qcsat(modwalker);
+			QuickConeSatRef qcsat_ref(modwalker, "memory_share");
+			QuickConeSat &qcsat = qcsat_ref.qcsat();
 
 			// create SAT representation of common input cone of all considered EN signals
 
@@ -389,7 +390,7 @@ struct MemoryShareWorker
 
 			qcsat.prepare();
 
-			log("  Common input cone for all EN signals: %d cells.\n", GetSize(qcsat.imported_cells));
+			log("  Common input cone for all EN signals: %d cells (in the solver).\n", GetSize(qcsat.imported_cells));
 
 			log("  Size of unconstrained SAT problem: %d variables, %d clauses\n", qcsat.ez->numCnfVariables(), qcsat.ez->numCnfClauses());
 
@@ -406,7 +407,7 @@ struct MemoryShareWorker
 					if (port2.removed)
 						continue;
 
-					if (qcsat.ez->solve(port_to_sat_variable.at(idx1), port_to_sat_variable.at(idx2))) {
+					if (qcsat.solve(port_to_sat_variable.at(idx1), port_to_sat_variable.at(idx2))) {
 						log("  According to SAT solver sharing of port %d with port %d is not possible.\n", idx1, idx2);
 						continue;
 					}
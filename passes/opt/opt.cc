@@ -18,13 +18,163 @@
  */
 
 #include "kernel/register.h"
+#include "kernel/sigtools.h"
 #include "kernel/log.h"
+#include "kernel/qcsat.h"
 #include <stdlib.h>
 #include <stdio.h>
 
 USING_YOSYS_NAMESPACE
 PRIVATE_NAMESPACE_BEGIN
 
+// Records the cells and nets touched by the opt_* passes, so that "opt
+// -incremental" can seed the next iteration from these changes only. Nets
+// are stored by wire name because opt_clean may delete the wires.
+struct OptFrontier : public RTLIL::Monitor
+{
+	RTLIL::Design *design;
+	dict<RTLIL::IdString, pool<RTLIL::IdString>> cells;
+	dict<RTLIL::IdString, pool<std::pair<RTLIL::IdString, int>>> nets;
+	pool<RTLIL::IdString> whole_modules;
+
+	OptFrontier(RTLIL::Design *design) : design(design)
+	{
+		design->monitors.insert(this);
+	}
+
+	~OptFrontier()
+	{
+		design->monitors.erase(this);
+	}
+
+	void add_net(RTLIL::Module *module, const RTLIL::SigSpec &sig)
+	{
+		auto &module_nets = nets[module->name];
+		for (auto bit : sig)
+			if (bit.wire)
+				module_nets.insert(std::make_pair(bit.wire->name, bit.offset));
+	}
+
+	void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString&, const RTLIL::SigSpec &old_sig, const RTLIL::SigSpec &sig) override
+	{
+		cells[cell->module->name].insert(cell->name);
+		add_net(cell->module, old_sig);
+		add_net(cell->module, sig);
+	}
+
+	void notify_connect(RTLIL::Module *module, const RTLIL::SigSig &sigsig) override
+	{
+		add_net(module, sigsig.first);
+		add_net(module, sigsig.second);
+	}
+
+	void notify_connect(RTLIL::Module *module, const std::vector<RTLIL::SigSig>&) override
+	{
+		whole_modules.insert(module->name);
+	}
+
+	void notify_blackout(RTLIL::Module *module) override
+	{
+		whole_modules.insert(module->name);
+	}
+
+	void notify_module_add(RTLIL::Module *module) override
+	{
+		whole_modules.insert(module->name);
+	}
+
+	void clear()
+	{
+		cells.clear();
+		nets.clear();
+		whole_modules.clear();
+	}
+
+	pool<RTLIL::IdString> modules() const
+	{
+		pool<RTLIL::IdString> result = whole_modules;
+		for (auto &it : cells)
+			result.insert(it.first);
+		for (auto &it : nets)
+			result.insert(it.first);
+		return result;
+	}
+
+	static void select_module(RTLIL::Selection &sel, RTLIL::Module *module)
+	{
+		if (module->design->selected_whole_module(module->name)) {
+			sel.select(module);
+			return;
+		}
+		for (auto wire : module->selected_wires())
+			sel.select(module, wire);
+		for (auto cell : module->selected_cells())
+			sel.select(module, cell);
+	}
+
+	RTLIL::Selection current_selection() const
+	{
+		RTLIL::Selection sel(false);
+		for (auto module : design->selected_modules())
+			select_module(sel, module);
+		return sel;
+	}
+
+	// The given modules, restricted to the current selection.
+	RTLIL::Selection module_selection(const pool<RTLIL::IdString> &names) const
+	{
+		RTLIL::Selection sel(false);
+		for (auto module : design->selected_modules())
+			if (names.count(module->name))
+				select_module(sel, module);
+		return sel;
+	}
+
+	// The touched cells and all cells connected to a touched net, restricted
+	// to the current selection.
+	RTLIL::Selection cell_selection() const
+	{
+		RTLIL::Selection sel(false);
+		for (auto module : design->selected_modules())
+		{
+			if (whole_modules.count(module->name)) {
+				select_module(sel, module);
+				continue;
+			}
+
+			auto cells_it = cells.find(module->name);
+			auto nets_it = nets.find(module->name);
+			if (cells_it == cells.end() && nets_it == nets.end())
+				continue;
+
+			SigMap sigmap(module);
+			pool<RTLIL::SigBit> bits;
+			if (nets_it != nets.end())
+				for (auto &it : nets_it->second) {
+					RTLIL::Wire *wire = module->wire(it.first);
+					if (wire != nullptr && it.second < GetSize(wire))
+						bits.insert(sigmap(RTLIL::SigBit(wire, it.second)));
+				}
+
+			for (auto cell : module->selected_cells()) {
+				bool touched = cells_it != cells.end() && cells_it->second.count(cell->name);
+				for (auto &conn : cell->connections()) {
+					if (touched)
+						break;
+					for (auto bit : sigmap(conn.second))
+						if (bit.wire && bits.count(bit)) {
+							touched = true;
+							break;
+						}
+				}
+				if (touched)
+					sel.select(module, cell);
+			}
+		}
+		return sel;
+	}
+};
+
 struct OptPass : public Pass {
 	OptPass() : Pass("opt", "perform simple optimizations") { }
 	void help() override
@@ -59,6 +209,17 @@ struct OptPass : public Pass {
 		log("        opt_clean [-purge]\n");
 		log("    while <changed design in opt_dff>\n");
 		log("\n");
+		log("When called with -incremental, the first iteration of the default script runs\n");
+		log("on the whole selection, and later iterations only on the modules changed in\n");
+		log("the previous iteration. Within those modules, opt_reduce, opt_dff and opt_expr\n");
+		log("only look at the cells that were changed and the cells connected to a changed\n");
+		log("net. Once this converges, the script is run once more on all modules changed\n");
+		log("since the last full iteration, to make sure the result is the same as without\n");
+		log("-incremental. This option is ignored when called with -fast.\n");
+		log("\n");
+		log("The SAT solver used by opt_dff -sat is kept from one iteration to the next, so\n");
+		log("that input cones that did not change are not imported again.\n");
+		log("\n");
 		log("Note: Options in square brackets (such as [-keepdc]) are passed through to\n");
 		log("the opt_* commands when given to 'opt'.\n");
 		log("\n");
@@ -74,6 +235,7 @@ struct OptPass : public Pass {
 		bool opt_share = false;
 		bool fast_mode = false;
 		bool noff_mode = false;
+		bool incremental = false;
 
 		log_header(design, "Executing OPT pass (performing simple optimizations).\n");
 		log_push();
@@ -141,10 +303,16 @@ struct OptPass : public Pass {
 				noff_mode = true;
 				continue;
 			}
+			if (args[argidx] == "-incremental") {
+				incremental = true;
+				continue;
+			}
 			break;
 		}
 		extra_args(args, argidx, design);
 
+		QuickConeSatCache qcsat_cache(design);
+
 		if (fast_mode)
 		{
 			while (1) {
@@ -160,6 +328,57 @@ struct OptPass : public Pass {
 			}
 			Pass::call(design, "opt_clean" + opt_clean_args);
 		}
+		else if (incremental)
+		{
+			Pass::call(design, "opt_expr" + opt_expr_args);
+			Pass::call(design, "opt_merge -nomux" + opt_merge_args);
+
+			OptFrontier frontier(design);
+			RTLIL::Selection module_sel = frontier.current_selection();
+			RTLIL::Selection cell_sel = module_sel;
+			pool<RTLIL::IdString> changed_modules;
+			bool seeded = false;
+
+			while (1) {
+				design->scratchpad_unset("opt.did_something");
+				frontier.clear();
+				Pass::call_on_selection(design, module_sel, "opt_muxtree");
+				Pass::call_on_selection(design, cell_sel, "opt_reduce" + opt_reduce_args);
+				Pass::call_on_selection(design, module_sel, "opt_merge" + opt_merge_args);
+				if (opt_share)
+					Pass::call_on_selection(design, module_sel, "opt_share");
+				if (!noff_mode)
+					Pass::call_on_selection(design, cell_sel, "opt_dff" + opt_dff_args);
+				Pass::call_on_selection(design, module_sel, "opt_clean" + opt_clean_args);
+				Pass::call_on_selection(design, cell_sel, "opt_expr" + opt_expr_args);
+
+				pool<RTLIL::IdString> modules = frontier.modules();
+				changed_modules.insert(modules.begin(), modules.end());
+
+				if (design->scratchpad_get_bool("opt.did_something")) {
+					// Seed the next iteration from the changes made in this one. Changes
+					// that are not visible to the monitor (e.g. a cell type changed in
+					// place) leave the frontier empty, rerun on the same selection then.
+					if (!modules.empty()) {
+						module_sel = frontier.module_selection(modules);
+						cell_sel = frontier.cell_selection();
+						seeded = true;
+					}
+					log_header(design, "Rerunning OPT passes on changed modules. (Maybe there is more to do..)\n");
+				} else if (seeded) {
+					// The seeded iterations converged. Run once more on everything
+					// that changed since the last full iteration to make sure.
+					module_sel = frontier.module_selection(changed_modules);
+					cell_sel = module_sel;
+					changed_modules.clear();
+					seeded = false;
+					if (module_sel.empty())
+						break;
+					log_header(design, "Rerunning OPT passes on changed modules. (Checking for fixpoint..)\n");
+				} else
+					break;
+			}
+		}
 		else
 		{
 			Pass::call(design, "opt_expr" + opt_expr_args);
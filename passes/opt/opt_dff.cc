@@ -735,8 +735,8 @@ struct OptDffWorker
 	}
 
 	bool run_constbits() {
-		ModWalker modwalker(module->design, module);
-		QuickConeSat qcsat(modwalker);
+		// only set up once a bit needs the solver, which is never the case without -sat
+		QuickConeSatRef qcsat_ref(module, "opt_dff");
 
 		// Run as a separate sub-pass, so that we don't mutate (non-FF) cells under ModWalker.
 		bool did_something = false;
@@ -770,11 +770,12 @@ struct OptDffWorker
 						if (!opt.sat)
 							continue;
 						// For each register bit, try to prove that it cannot change from the initial value. If so, remove it
-						if (!modwalker.has_drivers(ff.sig_d.extract(i)))
-							continue;
 						if (val != State::S0 && val != State::S1)
 							continue;
+						if (!qcsat_ref.modwalker().has_drivers(ff.sig_d.extract(i)))
+							continue;
 
+						QuickConeSat &qcsat = qcsat_ref.qcsat();
 						int init_sat_pi = qcsat.importSigBit(val);
 						int q_sat_pi = qcsat.importSigBit(ff.sig_q[i]);
 						int d_sat_pi = qcsat.importSigBit(ff.sig_d[i]);
@@ -782,7 +783,7 @@ struct OptDffWorker
 						qcsat.prepare();
 
 						// Try to find out whether the register bit can change under some circumstances
-						bool counter_example_found = qcsat.ez->solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
+						bool counter_example_found = qcsat.solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
 
 						// If the register bit cannot change, we can replace it with a constant
 						if (counter_example_found)
@@ -798,11 +799,12 @@ struct OptDffWorker
 						if (!opt.sat)
 							continue;
 						// For each register bit, try to prove that it cannot change from the initial value. If so, remove it
-						if (!modwalker.has_drivers(ff.sig_ad.extract(i)))
-							continue;
 						if (val != State::S0 && val != State::S1)
 							continue;
+						if (!qcsat_ref.modwalker().has_drivers(ff.sig_ad.extract(i)))
+							continue;
 
+						QuickConeSat &qcsat = qcsat_ref.qcsat();
 						int init_sat_pi = qcsat.importSigBit(val);
 						int q_sat_pi = qcsat.importSigBit(ff.sig_q[i]);
 						int d_sat_pi = qcsat.importSigBit(ff.sig_ad[i]);
@@ -810,7 +812,7 @@ struct OptDffWorker
 						qcsat.prepare();
 
 						// Try to find out whether the register bit can change under some circumstances
-						bool counter_example_found = qcsat.ez->solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
+						bool counter_example_found = qcsat.solve(qcsat.ez->IFF(q_sat_pi, init_sat_pi), qcsat.ez->NOT(qcsat.ez->IFF(d_sat_pi, init_sat_pi)));
 
 						// If the register bit cannot change, we can replace it with a constant
 						if (counter_example_found)
@@ -31,6 +31,211 @@ PRIVATE_NAMESPACE_BEGIN
 
 bool did_something;
 
+// Keeps track of the cells that need to be looked at again by the next
+// replace_const_cells() iteration: cells that were created or modified, and
+// cells reading a net that got connected to something new. The reader index
+// is only built once a module actually needs a second iteration.
+//
+// The SigMap and the map of inverted signals used by replace_const_cells()
+// are kept up to date here as well, so that an iteration only has to look at
+// the cells it revisits instead of rebuilding them from all cells.
+struct OptExprWorklist : public RTLIL::Monitor
+{
+	RTLIL::Module *module;
+	SigMap assign_map;
+	dict<RTLIL::SigSpec, RTLIL::SigSpec> invert_map;
+	dict<RTLIL::IdString, RTLIL::SigBit> inverters;
+	dict<RTLIL::SigBit, std::vector<RTLIL::IdString>> readers;
+	pool<RTLIL::IdString> pending;
+	std::vector<RTLIL::SigBit> dirty_bits;
+	bool indexed = false;
+	bool rescan = false;
+
+	OptExprWorklist(RTLIL::Module *module) : module(module), assign_map(module)
+	{
+		module->monitors.insert(this);
+	}
+
+	~OptExprWorklist()
+	{
+		module->monitors.erase(this);
+	}
+
+	void reindex()
+	{
+		readers.clear();
+		for (auto cell : module->cells())
+		for (auto &conn : cell->connections())
+		for (auto bit : assign_map(conn.second))
+			if (bit.wire)
+				readers[bit].push_back(cell->name);
+		indexed = true;
+	}
+
+	void mark_readers(RTLIL::SigBit bit)
+	{
+		if (!bit.wire)
+			return;
+		if (!indexed) {
+			dirty_bits.push_back(bit);
+			return;
+		}
+		auto it = readers.find(assign_map(bit));
+		if (it != readers.end())
+			pending.insert(it->second.begin(), it->second.end());
+	}
+
+	// Records the inversion implemented by the cell, if any.
+	void add_inverter(RTLIL::Cell *cell)
+	{
+		if (cell->type[0] != '$')
+			return;
+		RTLIL::SigSpec sig_in;
+		if (cell->type.in(ID($_NOT_), ID($not), ID($logic_not)) &&
+				GetSize(cell->getPort(ID::A)) == 1 && GetSize(cell->getPort(ID::Y)) == 1)
+			sig_in = cell->getPort(ID::A);
+		if (cell->type.in(ID($mux), ID($_MUX_)) &&
+				cell->getPort(ID::A) == SigSpec(State::S1) && cell->getPort(ID::B) == SigSpec(State::S0))
+			sig_in = cell->getPort(ID::S);
+		if (sig_in.empty())
+			return;
+		RTLIL::SigSpec sig_out = cell->getPort(ID::Y);
+		invert_map[assign_map(sig_out)] = assign_map(sig_in);
+		inverters[cell->name] = sig_out.as_bit();
+	}
+
+	// Forgets the inversion recorded for a cell that was changed or removed.
+	// Keeping it would let a later cell be replaced by a net that is no
+	// longer driven. If another cell recorded the same net it is dropped as
+	// well, which only costs an optimization opportunity.
+	void drop_inverter(RTLIL::IdString name)
+	{
+		auto it = inverters.find(name);
+		if (it == inverters.end())
+			return;
+		invert_map.erase(assign_map(it->second));
+		inverters.erase(it);
+	}
+
+	void clear_inverters()
+	{
+		invert_map.clear();
+		inverters.clear();
+	}
+
+	// Called for cells that were changed in ways that are not visible to the
+	// monitor (e.g. a type or parameter change).
+	void touch(RTLIL::IdString name)
+	{
+		pending.insert(name);
+		drop_inverter(name);
+		RTLIL::Cell *cell = module->cell(name);
+		if (cell != nullptr)
+			for (auto &conn : cell->connections())
+			for (auto bit : conn.second)
+				mark_readers(bit);
+	}
+
+	void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString &port, const RTLIL::SigSpec &old_sig, const RTLIL::SigSpec &sig) override
+	{
+		pending.insert(cell->name);
+		drop_inverter(cell->name);
+		if (!yosys_celltypes.cell_known(cell->type) || yosys_celltypes.cell_output(cell->type, port)) {
+			for (auto bit : old_sig)
+				mark_readers(bit);
+			for (auto bit : sig)
+				mark_readers(bit);
+		}
+		if (indexed)
+			for (auto bit : assign_map(sig))
+				if (bit.wire)
+					readers[bit].push_back(cell->name);
+	}
+
+	void notify_connect(RTLIL::Module*, const RTLIL::SigSig &sigsig) override
+	{
+		for (int i = 0; i < GetSize(sigsig.first); i++)
+		{
+			RTLIL::SigBit lhs = assign_map(sigsig.first[i]);
+			RTLIL::SigBit rhs = assign_map(sigsig.second[i]);
+			if (lhs == rhs)
+				continue;
+
+			mark_readers(lhs);
+			mark_readers(rhs);
+
+			std::vector<RTLIL::IdString> merged, other;
+			if (readers.count(lhs)) {
+				merged.swap(readers.at(lhs));
+				readers.erase(lhs);
+			}
+			if (readers.count(rhs)) {
+				other.swap(readers.at(rhs));
+				readers.erase(rhs);
+			}
+			if (GetSize(merged) < GetSize(other))
+				merged.swap(other);
+			merged.insert(merged.end(), other.begin(), other.end());
+
+			// Readers of a net that became constant never need to be revisited
+			// again because of it, so only keep them if the net is still a wire.
+			assign_map.add(lhs, rhs);
+			RTLIL::SigBit rep = assign_map(lhs);
+			if (rep.wire && !merged.empty())
+				readers[rep] = std::move(merged);
+
+			// Inversions are looked up by the representative of the inverted net.
+			for (auto bit : {lhs, rhs}) {
+				if (bit == rep)
+					continue;
+				auto it = invert_map.find(bit);
+				if (it == invert_map.end())
+					continue;
+				if (rep.wire && !invert_map.count(rep))
+					invert_map[rep] = it->second;
+				invert_map.erase(it);
+			}
+		}
+	}
+
+	void notify_connect(RTLIL::Module*, const std::vector<RTLIL::SigSig>&) override
+	{
+		rescan = true;
+	}
+
+	void notify_blackout(RTLIL::Module*) override
+	{
+		rescan = true;
+	}
+
+	// Moves the cells collected since the last call into `cells'. Returns
+	// false if the module was changed in a way that requires a full rescan.
+	bool harvest(pool<RTLIL::IdString> &cells)
+	{
+		if (rescan) {
+			rescan = false;
+			indexed = false;
+			assign_map.set(module);
+			clear_inverters();
+			readers.clear();
+			dirty_bits.clear();
+			pending.clear();
+			return false;
+		}
+
+		if (!indexed) {
+			reindex();
+			for (auto bit : dirty_bits)
+				mark_readers(bit);
+			dirty_bits.clear();
+		}
+
+		cells.clear();
+		cells.swap(pending);
+		return true;
+	}
+};
+
 void replace_undriven(RTLIL::Module *module, const CellTypes &ct)
 {
 	SigMap sigmap(module);
@@ -116,7 +321,7 @@ void replace_undriven(RTLIL::Module *module, const CellTypes &ct)
 	}
 }
 
-void replace_cell(SigMap &assign_map, RTLIL::Module *module, RTLIL::Cell *cell,
+void replace_cell(RTLIL::Module *module, RTLIL::Cell *cell,
 		const std::string &info, IdString out_port, RTLIL::SigSpec out_val)
 {
 	RTLIL::SigSpec Y = cell->getPort(out_port);
@@ -126,7 +331,6 @@ void replace_cell(SigMap &assign_map, RTLIL::Module *module, RTLIL::Cell *cell,
 			cell->type.c_str(), cell->name.c_str(), info.c_str(),
 			module->name.c_str(), log_signal(Y), log_signal(out_val));
 	// log_cell(cell);
-	assign_map.add(Y, out_val);
 	module->connect(Y, out_val);
 	module->remove(cell);
 	did_something = true;
@@ -393,28 +597,137 @@ int get_highest_hot_index(RTLIL::SigSpec signal)
 	return -1;
 }
 
-void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool consume_x, bool mux_undef, bool mux_bool, bool do_fine, bool keepdc, bool noclkinv)
+bool sig_to_word(const RTLIL::SigSpec &sig, uint64_t &word)
 {
-	SigMap assign_map(module);
-	dict<RTLIL::SigSpec, RTLIL::SigSpec> invert_map;
+	// keep one spare bit so that both signed and unsigned operands fit into an int64_t
+	if (GetSize(sig) > 63)
+		return false;
+
+	int i = 0;
+	word = 0;
+	for (auto &chunk : sig.chunks())
+		for (auto bit : chunk.data) {
+			if (bit == State::S1)
+				word |= uint64_t(1) << i;
+			else if (bit != State::S0)
+				return false;
+			i++;
+		}
+	return true;
+}
+
+int64_t word_extend(uint64_t word, int width, bool is_signed)
+{
+	if (is_signed && width > 0 && ((word >> (width - 1)) & 1))
+		word |= ~uint64_t(0) << width;
+	return int64_t(word);
+}
+
+bool word_parity(uint64_t word)
+{
+	for (int shift = 32; shift > 0; shift >>= 1)
+		word ^= word >> shift;
+	return word & 1;
+}
+
+// Word-level version of the RTLIL::const_* functions for the common case of
+// fully defined operands that fit into a machine word. Returns false if the
+// generic implementation must be used instead.
+bool fold_const_word(RTLIL::IdString type, const RTLIL::SigSpec &sig_a, const RTLIL::SigSpec &sig_b,
+		bool a_signed, bool b_signed, int y_width, RTLIL::Const &result)
+{
+	uint64_t a_word, b_word = 0;
+	if (y_width > 64 || !sig_to_word(sig_a, a_word) || !sig_to_word(sig_b, b_word))
+		return false;
+
+	int a_width = GetSize(sig_a), b_width = GetSize(sig_b);
+	int64_t a = word_extend(a_word, a_width, a_signed);
+	int64_t b = word_extend(b_word, b_width, b_signed);
+	uint64_t y;
+
+	if (type == ID($not))
+		y = ~a;
+	else if (type == ID($pos))
+		y = a;
+	else if (type == ID($neg))
+		y = uint64_t(0) - uint64_t(a);
+	else if (type == ID($and))
+		y = a & b;
+	else if (type == ID($or))
+		y = a | b;
+	else if (type == ID($xor))
+		y = a ^ b;
+	else if (type == ID($xnor))
+		y = ~(a ^ b);
+	else if (type == ID($reduce_and))
+		y = a_word == (uint64_t(1) << a_width) - 1;
+	else if (type.in(ID($reduce_or), ID($reduce_bool)))
+		y = a_word != 0;
+	else if (type == ID($reduce_xor))
+		y = word_parity(a_word);
+	else if (type == ID($reduce_xnor))
+		y = !word_parity(a_word);
+	else if (type == ID($logic_not))
+		y = a == 0;
+	else if (type == ID($logic_and))
+		y = a != 0 && b != 0;
+	else if (type == ID($logic_or))
+		y = a != 0 || b != 0;
+	else if (type.in(ID($eq), ID($ne), ID($eqx), ID($nex))) {
+		// equality extends both operands with the same signedness
+		bool is_signed = a_signed && b_signed;
+		bool equal = word_extend(a_word, a_width, is_signed) == word_extend(b_word, b_width, is_signed);
+		y = type.in(ID($eq), ID($eqx)) ? equal : !equal;
+	}
+	else if (type == ID($lt))
+		y = a < b;
+	else if (type == ID($le))
+		y = a <= b;
+	else if (type == ID($gt))
+		y = a > b;
+	else if (type == ID($ge))
+		y = a >= b;
+	else if (type == ID($add))
+		y = uint64_t(a) + uint64_t(b);
+	else if (type == ID($sub))
+		y = uint64_t(a) - uint64_t(b);
+	else if (type == ID($mul))
+		y = uint64_t(a) * uint64_t(b);
+	else
+		return false;
+
+	result = RTLIL::Const((long long)y, y_width);
+	return true;
+}
 
-	for (auto cell : module->cells()) {
-		if (design->selected(module, cell) && cell->type[0] == '$') {
-			if (cell->type.in(ID($_NOT_), ID($not), ID($logic_not)) &&
-					GetSize(cell->getPort(ID::A)) == 1 && GetSize(cell->getPort(ID::Y)) == 1)
-				invert_map[assign_map(cell->getPort(ID::Y))] = assign_map(cell->getPort(ID::A));
-			if (cell->type.in(ID($mux), ID($_MUX_)) &&
-					cell->getPort(ID::A) == SigSpec(State::S1) && cell->getPort(ID::B) == SigSpec(State::S0))
-				invert_map[assign_map(cell->getPort(ID::Y))] = assign_map(cell->getPort(ID::S));
+void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, const pool<RTLIL::IdString> *only_cells, OptExprWorklist &worklist,
+		bool consume_x, bool mux_undef, bool mux_bool, bool do_fine, bool keepdc, bool noclkinv)
+{
+	SigMap &assign_map = worklist.assign_map;
+	dict<RTLIL::SigSpec, RTLIL::SigSpec> &invert_map = worklist.invert_map;
+
+	std::vector<RTLIL::Cell*> candidates;
+	if (only_cells != nullptr) {
+		for (auto name : *only_cells) {
+			RTLIL::Cell *cell = module->cell(name);
+			if (cell != nullptr && design->selected(module, cell))
+				candidates.push_back(cell);
 		}
+	} else {
+		worklist.clear_inverters();
+		for (auto cell : module->cells())
+			if (design->selected(module, cell))
+				candidates.push_back(cell);
 	}
 
+	for (auto cell : candidates)
+		worklist.add_inverter(cell);
+
 	CellTypes ct_memcells;
 	ct_memcells.setup_stdcells_mem();
 
 	if (!noclkinv)
-	for (auto cell : module->cells())
-	if (design->selected(module, cell)) {
+	for (auto cell : candidates) {
 		if (cell->type.in(ID($dff), ID($dffe), ID($dffsr), ID($dffsre), ID($adff), ID($adffe), ID($aldff), ID($aldffe), ID($sdff), ID($sdffe), ID($sdffce), ID($fsm), ID($memrd), ID($memrd_v2), ID($memwr), ID($memwr_v2)))
 			handle_polarity_inv(cell, ID::CLK, ID::CLK_POLARITY, assign_map, invert_map);
 
@@ -493,8 +806,8 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 	TopoSort<RTLIL::Cell*, RTLIL::IdString::compare_ptr_by_name<RTLIL::Cell>> cells;
 	dict<RTLIL::SigBit, Cell*> outbit_to_cell;
 
-	for (auto cell : module->cells())
-	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type)) {
+	for (auto cell : candidates)
+	if (yosys_celltypes.cell_evaluable(cell->type)) {
 		for (auto &conn : cell->connections())
 		if (yosys_celltypes.cell_output(cell->type, conn.first))
 		for (auto bit : assign_map(conn.second))
@@ -502,8 +815,8 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 		cells.node(cell);
 	}
 
-	for (auto cell : module->cells())
-	if (design->selected(module, cell) && yosys_celltypes.cell_evaluable(cell->type)) {
+	for (auto cell : candidates)
+	if (yosys_celltypes.cell_evaluable(cell->type)) {
 		const int r_index = cells.node(cell);
 		for (auto &conn : cell->connections())
 		if (yosys_celltypes.cell_input(cell->type, conn.first))
@@ -520,7 +833,13 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 
 	for (auto cell : cells.sorted)
 	{
-#define ACTION_DO(_p_, _s_) do { cover("opt.opt_expr.action_" S__LINE__); replace_cell(assign_map, module, cell, input.as_string(), _p_, _s_); goto next_cell; } while (0)
+		// track changes per cell so that the worklist can pick up cells
+		// that were rewritten in place
+		bool did_something_before = did_something;
+		RTLIL::IdString cell_name = cell->name;
+		did_something = false;
+
+#define ACTION_DO(_p_, _s_) do { cover("opt.opt_expr.action_" S__LINE__); replace_cell(module, cell, input.as_string(), _p_, _s_); goto next_cell; } while (0)
 #define ACTION_DO_Y(_v_) ACTION_DO(ID::Y, RTLIL::SigSpec(RTLIL::State::S ## _v_))
 
 		bool detect_const_and = false;
@@ -568,19 +887,19 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 
 			if (detect_const_and && (found_zero || found_inv || (found_undef && consume_x))) {
 				cover("opt.opt_expr.const_and");
-				replace_cell(assign_map, module, cell, "const_and", ID::Y, RTLIL::State::S0);
+				replace_cell(module, cell, "const_and", ID::Y, RTLIL::State::S0);
 				goto next_cell;
 			}
 
 			if (detect_const_or && (found_one || found_inv || (found_undef && consume_x))) {
 				cover("opt.opt_expr.const_or");
-				replace_cell(assign_map, module, cell, "const_or", ID::Y, RTLIL::State::S1);
+				replace_cell(module, cell, "const_or", ID::Y, RTLIL::State::S1);
 				goto next_cell;
 			}
 
 			if (non_const_input != State::Sm && !found_undef) {
 				cover("opt.opt_expr.and_or_buffer");
-				replace_cell(assign_map, module, cell, "and_or_buffer", ID::Y, non_const_input);
+				replace_cell(module, cell, "and_or_buffer", ID::Y, non_const_input);
 				goto next_cell;
 			}
 		}
@@ -592,14 +911,14 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 			if (!keepdc && (sig_a == sig_b || sig_a == State::Sx || sig_a == State::Sz || sig_b == State::Sx || sig_b == State::Sz)) {
 				if (cell->type.in(ID($xor), ID($_XOR_))) {
 					cover("opt.opt_expr.const_xor");
-					replace_cell(assign_map, module, cell, "const_xor", ID::Y, RTLIL::State::S0);
+					replace_cell(module, cell, "const_xor", ID::Y, RTLIL::State::S0);
 					goto next_cell;
 				}
 				if (cell->type.in(ID($xnor), ID($_XNOR_))) {
 					cover("opt.opt_expr.const_xnor");
 					// For consistency since simplemap does $xnor -> $_XOR_ + $_NOT_
 					int width = GetSize(cell->getPort(ID::Y));
-					replace_cell(assign_map, module, cell, "const_xnor", ID::Y, SigSpec(RTLIL::State::S1, width));
+					replace_cell(module, cell, "const_xnor", ID::Y, SigSpec(RTLIL::State::S1, width));
 					goto next_cell;
 				}
 				log_abort();
@@ -616,7 +935,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 					else if (cell->type == ID($_XOR_))
 						sig_y = (sig_b == State::S1 ? module->NotGate(NEW_ID, sig_a) : sig_a);
 					else log_abort();
-					replace_cell(assign_map, module, cell, "xor_buffer", ID::Y, sig_y);
+					replace_cell(module, cell, "xor_buffer", ID::Y, sig_y);
 					goto next_cell;
 				}
 				if (cell->type.in(ID($xnor), ID($_XNOR_))) {
@@ -630,7 +949,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 					else if (cell->type == ID($_XNOR_))
 						sig_y = (sig_b == State::S1 ? sig_a : module->NotGate(NEW_ID, sig_a));
 					else log_abort();
-					replace_cell(assign_map, module, cell, "xnor_buffer", ID::Y, sig_y);
+					replace_cell(module, cell, "xnor_buffer", ID::Y, sig_y);
 					goto next_cell;
 				}
 				log_abort();
@@ -648,7 +967,7 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 				did_something = true;
 			} else {
 				cover("opt.opt_expr.unary_buffer");
-				replace_cell(assign_map, module, cell, "unary_buffer", ID::Y, cell->getPort(ID::A));
+				replace_cell(module, cell, "unary_buffer", ID::Y, cell->getPort(ID::A));
 			}
 			goto next_cell;
 		}
@@ -724,9 +1043,9 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 					log_abort();
 				}
 
-				assign_map.add(y_group_0, y_new_0); module->connect(y_group_0, y_new_0);
-				assign_map.add(y_group_1, y_new_1); module->connect(y_group_1, y_new_1);
-				assign_map.add(y_group_x, y_new_x); module->connect(y_group_x, y_new_x);
+				module->connect(y_group_0, y_new_0);
+				module->connect(y_group_1, y_new_1);
+				module->connect(y_group_x, y_new_x);
 
 				module->remove(cell);
 				did_something = true;
@@ -753,8 +1072,8 @@ void replace_const_cells(RTLIL::Design *design, RTLIL::Module *module, bool cons
 						y_group_0.append(sig_y[i]), a_group_0.append(sig_a[i]);
 				}
 
-				assign_map.add(y_group_0, a_group_0); module->connect(y_group_0, a_group_0);
-				assign_map.add(y_group_1, b_group_1); module->connect(y_group_1, b_group_1);
+				module->connect(y_group_0, a_group_0);
+				module->connect(y_group_1, b_group_1);
 
 				module->remove(cell);
 				did_something = true;
@@ -1050,9 +1369,9 @@ skip_fine_alu:
 				cover_list("opt.opt_expr.xbit", "$reduce_xor", "$reduce_xnor", "$shl", "$shr", "$sshl", "$sshr", "$shift", "$shiftx",
 						"$lt", "$le", "$ge", "$gt", "$neg", "$add", "$sub", "$mul", "$div", "$mod", "$divfloor", "$modfloor", "$pow", cell->type.str());
 				if (cell->type.in(ID($reduce_xor), ID($reduce_xnor), ID($lt), ID($le), ID($ge), ID($gt)))
-					replace_cell(assign_map, module, cell, "x-bit in input", ID::Y, RTLIL::State::Sx);
+					replace_cell(module, cell, "x-bit in input", ID::Y, RTLIL::State::Sx);
 				else
-					replace_cell(assign_map, module, cell, "x-bit in input", ID::Y, RTLIL::SigSpec(RTLIL::State::Sx, GetSize(cell->getPort(ID::Y))));
+					replace_cell(module, cell, "x-bit in input", ID::Y, RTLIL::SigSpec(RTLIL::State::Sx, GetSize(cell->getPort(ID::Y))));
 				goto next_cell;
 			}
 		}
@@ -1082,7 +1401,7 @@ skip_fine_alu:
 		if (cell->type.in(ID($_NOT_), ID($not), ID($logic_not)) && GetSize(cell->getPort(ID::Y)) == 1 &&
 				invert_map.count(assign_map(cell->getPort(ID::A))) != 0) {
 			cover_list("opt.opt_expr.invert.double", "$_NOT_", "$not", "$logic_not", cell->type.str());
-			replace_cell(assign_map, module, cell, "double_invert", ID::Y, invert_map.at(assign_map(cell->getPort(ID::A))));
+			replace_cell(module, cell, "double_invert", ID::Y, invert_map.at(assign_map(cell->getPort(ID::A))));
 			goto next_cell;
 		}
 
@@ -1090,9 +1409,10 @@ skip_fine_alu:
 			cover_list("opt.opt_expr.invert.muxsel", "$_MUX_", "$mux", cell->type.str());
 			log_debug("Optimizing away select inverter for %s cell `%s' in module `%s'.\n", log_id(cell->type), log_id(cell), log_id(module));
 			RTLIL::SigSpec tmp = cell->getPort(ID::A);
+			RTLIL::SigSpec new_s = invert_map.at(assign_map(cell->getPort(ID::S)));
 			cell->setPort(ID::A, cell->getPort(ID::B));
 			cell->setPort(ID::B, tmp);
-			cell->setPort(ID::S, invert_map.at(assign_map(cell->getPort(ID::S))));
+			cell->setPort(ID::S, new_s);
 			did_something = true;
 			goto next_cell;
 		}
@@ -1225,7 +1545,7 @@ skip_fine_alu:
 					cover_list("opt.opt_expr.eqneq.isneq", "$eq", "$ne", "$eqx", "$nex", cell->type.str());
 					RTLIL::SigSpec new_y = RTLIL::SigSpec(cell->type.in(ID($eq), ID($eqx)) ?  RTLIL::State::S0 : RTLIL::State::S1);
 					new_y.extend_u0(cell->parameters[ID::Y_WIDTH].as_int(), false);
-					replace_cell(assign_map, module, cell, "isneq", ID::Y, new_y);
+					replace_cell(module, cell, "isneq", ID::Y, new_y);
 					goto next_cell;
 				}
 				if (a[i] == b[i])
@@ -1238,7 +1558,7 @@ skip_fine_alu:
 				cover_list("opt.opt_expr.eqneq.empty", "$eq", "$ne", "$eqx", "$nex", cell->type.str());
 				RTLIL::SigSpec new_y = RTLIL::SigSpec(cell->type.in(ID($eq), ID($eqx)) ?  RTLIL::State::S1 : RTLIL::State::S0);
 				new_y.extend_u0(cell->parameters[ID::Y_WIDTH].as_int(), false);
-				replace_cell(assign_map, module, cell, "empty", ID::Y, new_y);
+				replace_cell(module, cell, "empty", ID::Y, new_y);
 				goto next_cell;
 			}
 
@@ -1458,7 +1778,7 @@ skip_identity:
 		if (mux_bool && cell->type.in(ID($mux), ID($_MUX_)) &&
 				cell->getPort(ID::A) == State::S0 && cell->getPort(ID::B) == State::S1) {
 			cover_list("opt.opt_expr.mux_bool", "$mux", "$_MUX_", cell->type.str());
-			replace_cell(assign_map, module, cell, "mux_bool", ID::Y, cell->getPort(ID::S));
+			replace_cell(module, cell, "mux_bool", ID::Y, cell->getPort(ID::S));
 			goto next_cell;
 		}
 
@@ -1528,7 +1848,7 @@ skip_identity:
 			if ((cell->getPort(ID::A).is_fully_undef() && cell->getPort(ID::B).is_fully_undef()) ||
 					cell->getPort(ID::S).is_fully_undef()) {
 				cover_list("opt.opt_expr.mux_undef", "$mux", "$pmux", cell->type.str());
-				replace_cell(assign_map, module, cell, "mux_undef", ID::Y, cell->getPort(ID::A));
+				replace_cell(module, cell, "mux_undef", ID::Y, cell->getPort(ID::A));
 				goto next_cell;
 			}
 			for (int i = 0; i < cell->getPort(ID::S).size(); i++) {
@@ -1547,12 +1867,12 @@ skip_identity:
 			}
 			if (new_s.size() == 0) {
 				cover_list("opt.opt_expr.mux_empty", "$mux", "$pmux", cell->type.str());
-				replace_cell(assign_map, module, cell, "mux_empty", ID::Y, new_a);
+				replace_cell(module, cell, "mux_empty", ID::Y, new_a);
 				goto next_cell;
 			}
 			if (new_a == RTLIL::SigSpec(RTLIL::State::S0) && new_b == RTLIL::SigSpec(RTLIL::State::S1)) {
 				cover_list("opt.opt_expr.mux_sel01", "$mux", "$pmux", cell->type.str());
-				replace_cell(assign_map, module, cell, "mux_sel01", ID::Y, new_s);
+				replace_cell(module, cell, "mux_sel01", ID::Y, new_s);
 				goto next_cell;
 			}
 			if (cell->getPort(ID::S).size() != new_s.size()) {
@@ -1578,12 +1898,13 @@ skip_identity:
 			RTLIL::SigSpec a = cell->getPort(ID::A); \
 			assign_map.apply(a); \
 			if (a.is_fully_const()) { \
-				RTLIL::Const dummy_arg(RTLIL::State::S0, 1); \
-				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), dummy_arg, \
-						cell->parameters[ID::A_SIGNED].as_bool(), false, \
-						cell->parameters[ID::Y_WIDTH].as_int())); \
+				RTLIL::Const dummy_arg(RTLIL::State::S0, 1), y_word; \
+				bool a_signed = cell->parameters[ID::A_SIGNED].as_bool(); \
+				int y_width = cell->parameters[ID::Y_WIDTH].as_int(); \
+				RTLIL::SigSpec y(fold_const_word(cell->type, a, SigSpec(), a_signed, false, y_width, y_word) ? y_word : \
+						RTLIL::const_ ## _t(a.as_const(), dummy_arg, a_signed, false, y_width)); \
 				cover("opt.opt_expr.const.$" #_t); \
-				replace_cell(assign_map, module, cell, stringf("%s", log_signal(a)), ID::Y, y); \
+				replace_cell(module, cell, stringf("%s", log_signal(a)), ID::Y, y); \
 				goto next_cell; \
 			} \
 		}
@@ -1593,12 +1914,14 @@ skip_identity:
 			RTLIL::SigSpec b = cell->getPort(ID::B); \
 			assign_map.apply(a), assign_map.apply(b); \
 			if (a.is_fully_const() && b.is_fully_const()) { \
-				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), b.as_const(), \
-						cell->parameters[ID::A_SIGNED].as_bool(), \
-						cell->parameters[ID::B_SIGNED].as_bool(), \
-						cell->parameters[ID::Y_WIDTH].as_int())); \
+				RTLIL::Const y_word; \
+				bool a_signed = cell->parameters[ID::A_SIGNED].as_bool(); \
+				bool b_signed = cell->parameters[ID::B_SIGNED].as_bool(); \
+				int y_width = cell->parameters[ID::Y_WIDTH].as_int(); \
+				RTLIL::SigSpec y(fold_const_word(cell->type, a, b, a_signed, b_signed, y_width, y_word) ? y_word : \
+						RTLIL::const_ ## _t(a.as_const(), b.as_const(), a_signed, b_signed, y_width)); \
 				cover("opt.opt_expr.const.$" #_t); \
-				replace_cell(assign_map, module, cell, stringf("%s, %s", log_signal(a), log_signal(b)), ID::Y, y); \
+				replace_cell(module, cell, stringf("%s, %s", log_signal(a), log_signal(b)), ID::Y, y); \
 				goto next_cell; \
 			} \
 		}
@@ -1610,7 +1933,7 @@ skip_identity:
 			if (a.is_fully_const() && b.is_fully_const()) { \
 				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), b.as_const())); \
 				cover("opt.opt_expr.const.$" #_t); \
-				replace_cell(assign_map, module, cell, stringf("%s, %s", log_signal(a), log_signal(b)), ID::Y, y); \
+				replace_cell(module, cell, stringf("%s, %s", log_signal(a), log_signal(b)), ID::Y, y); \
 				goto next_cell; \
 			} \
 		}
@@ -1623,7 +1946,7 @@ skip_identity:
 			if (a.is_fully_const() && b.is_fully_const() && s.is_fully_const()) { \
 				RTLIL::SigSpec y(RTLIL::const_ ## _t(a.as_const(), b.as_const(), s.as_const())); \
 				cover("opt.opt_expr.const.$" #_t); \
-				replace_cell(assign_map, module, cell, stringf("%s, %s, %s", log_signal(a), log_signal(b), log_signal(s)), ID::Y, y); \
+				replace_cell(module, cell, stringf("%s, %s, %s", log_signal(a), log_signal(b), log_signal(s)), ID::Y, y); \
 				goto next_cell; \
 			} \
 		}
@@ -2197,7 +2520,10 @@ skip_alu_split:
 			}
 		}
 
-	next_cell:;
+	next_cell:
+		if (did_something)
+			worklist.touch(cell_name);
+		did_something |= did_something_before;
 #undef ACTION_DO
 #undef ACTION_DO_Y
 #undef FOLD_1ARG_CELL
@@ -2319,15 +2645,34 @@ struct OptExprPass : public Pass {
 					design->scratchpad_set_bool("opt.did_something", true);
 			}
 
+			// The first iteration looks at all cells, later iterations only
+			// revisit the cells collected by the worklist.
+			OptExprWorklist worklist(module);
+			pool<RTLIL::IdString> cells, consume_x_cells;
+			bool full_scan = true, consume_x_full_scan = true;
+
 			do {
 				do {
 					did_something = false;
-					replace_const_cells(design, module, false /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+					if (!full_scan && !worklist.harvest(cells))
+						full_scan = consume_x_full_scan = true;
+					if (!full_scan)
+						consume_x_cells.insert(cells.begin(), cells.end());
+					replace_const_cells(design, module, full_scan ? nullptr : &cells, worklist,
+							false /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+					full_scan = false;
 					if (did_something)
 						design->scratchpad_set_bool("opt.did_something", true);
 				} while (did_something);
-				if (!keepdc)
-					replace_const_cells(design, module, true /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+				if (!keepdc) {
+					if (!worklist.harvest(cells))
+						full_scan = consume_x_full_scan = true;
+					consume_x_cells.insert(cells.begin(), cells.end());
+					replace_const_cells(design, module, consume_x_full_scan ? nullptr : &consume_x_cells, worklist,
+							true /* consume_x */, mux_undef, mux_bool, do_fine, keepdc, noclkinv);
+					consume_x_full_scan = false;
+					consume_x_cells.clear();
+				}
 				if (did_something)
 					design->scratchpad_set_bool("opt.did_something", true);
 			} while (did_something);
@@ -58,7 +58,7 @@ struct OptLutInsPass : public Pass {
 		}
 		extra_args(args, argidx, design);
 
-		if (techname != "" && techname != "xilinx" && techname != "lattice" && techname != "ecp5" && techname != "gowin" && techname != "ozixe")
+		if (techname != "" && techname != "xilinx" && techname != "lattice" && techname != "ecp5" && techname != "gowin")
 			log_cmd_error("Unsupported technology: '%s'\n", techname.c_str());
 
 		for (auto module : design->selected_modules())
@@ -193,57 +193,6 @@ struct OptLutInsPass : public Pass {
 								swz += extra;
 					}
 				} 
-				if (techname == "ozixe") {
-					// Forcer la LUT à 4 entrées
-					int orig_size = GetSize(new_inputs);
-					int target_size = 4;
-					// Si le nombre d'entrées est inférieur à 4, on complète avec S0
-					if (orig_size < target_size) {
-						int extra = target_size - orig_size;
-						for (int i = 0; i < extra; i++)
-							new_inputs.push_back(State::S0);
-					}
-					// Optionnel : si le nombre d'entrées est supérieur à 4, on peut réduire (ou lever une erreur)
-					else if (orig_size > target_size) {
-						new_inputs.resize(target_size);
-						orig_size = target_size;
-					}
-					// Recalculer la LUT pour 4 entrées (2^4 = 16 bits)
-					Const new_lut_ozixe(0, 1 << target_size);
-					// On se base sur la constante 'lut' d'origine qui a 2^(nombre d'entrées initiales) bits.
-					for (int i = 0; i < GetSize(new_lut_ozixe); i++) {
-						int lidx = 0;
-						// Pour chaque entrée d'origine (avant padding ou troncature)
-						for (int j = 0; j < orig_size; j++) {
-							int bit;
-							// Utiliser la valeur du swizzle pour déterminer la position dans 'i'
-							if (swizzle[j] == -2)
-								bit = 1;
-							else if (swizzle[j] == -1)
-								bit = 0;
-							else
-								bit = (i >> swizzle[j]) & 1;
-							lidx |= bit << j;
-						}
-						int orig_range = (orig_size > 0) ? (1 << orig_size) : 1;
-						new_lut_ozixe.bits()[i] = lut[lidx % orig_range];
-					}
-					// Mettre à jour la cellule : forcer le type LUT4, param INIT et ports I0..I3.
-					cell->type = ID(LUT4);
-					cell->setParam(ID(INIT), new_lut_ozixe);
-					// Désactiver tous les anciens ports I*
-					for (int i = 0; i < 4; i++) {
-						cell->unsetPort(stringf("\\I%d", i));
-					}
-					// Réaffecter les ports pour les 4 entrées
-					for (int i = 0; i < target_size; i++) {
-						SigSpec port = (i < GetSize(new_inputs)) ? SigSpec(new_inputs[i]) : SigSpec(State::S0);
-						cell->setPort(stringf("\\I%d", i), port);
-					}
-					// Mettre à jour le paramètre WIDTH à 4
-					cell->setParam(ID(WIDTH), Const(4));
-				}
-				
 				if (techname == "gowin") {
 					// Pad the LUT to 1 input, adding consts from the front.
 					if (new_inputs.empty()) {
@@ -51,7 +51,8 @@ struct OptMemPriorityPass : public Pass {
 			modwalker.setup(module);
 			for (auto &mem : Mem::get_selected_memories(module)) {
 				bool mem_changed = false;
-				QuickConeSat qcsat(modwalker);
+				QuickConeSatRef qcsat_ref(modwalker, "opt_mem_priority");
+				QuickConeSat &qcsat = qcsat_ref.qcsat();
 				for (int i = 0; i < GetSize(mem.wr_ports); i++) {
 					auto &wport1 = mem.wr_ports[i];
 					for (int j = 0; j < GetSize(mem.wr_ports); j++) {
@@ -81,7 +82,7 @@ struct OptMemPriorityPass : public Pass {
 							int wen1_sat = qcsat.importSigBit(wen1);
 							int wen2_sat = qcsat.importSigBit(wen2);
 							qcsat.prepare();
-							if (qcsat.ez->solve(wen1_sat, wen2_sat, addr_eq)) {
+							if (qcsat.solve(wen1_sat, wen2_sat, addr_eq)) {
 								ok = false;
 								break;
 							}
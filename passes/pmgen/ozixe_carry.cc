@@ -0,0 +1,129 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+#include "passes/pmgen/ozixe_carry_pm.h"
+
+void pack_ozixe_carry(ozixe_carry_pm &pm)
+{
+	auto &st = pm.st_ozixe_carry;
+
+	// st.AB is one of \A0, \B0, \A1, \B1
+	char half = st.AB[2];
+	bool lut_on_a = st.AB[1] == 'A';
+	IdString port_a = stringf("\\A%c", half), port_b = stringf("\\B%c", half);
+	IdString port_c = stringf("\\C%c", half), port_d = stringf("\\D%c", half);
+	IdString param_init = stringf("\\INIT%c", half), param_inject = stringf("\\INJECT1_%c", half);
+
+	SigSpec sig_c = st.carry->getPort(port_c), sig_d = st.carry->getPort(port_d);
+	if (!sig_c.is_fully_def() || !sig_d.is_fully_def())
+		return;
+	int c = sig_c.as_bool(), d = sig_d.as_bool();
+
+	Const init = st.carry->getParam(param_init);
+	Const lut_init = st.lut->getParam(ID::LUT);
+	if (!init.is_fully_def() || !lut_init.is_fully_def())
+		return;
+	bool inject = st.carry->getParam(param_inject).decode_string() == "YES";
+
+	// Old propagate (LUT4) and generate (LUT2) functions of the half, with C and
+	// D fixed to their constant values
+	auto p = [&](int a, int b) { return init[d*8 + c*4 + b*2 + a] == State::S1; };
+	auto g = [&](int a, int b) { return init[b*2 + a] == State::S1; };
+	int lut_width = st.lut->getParam(ID::WIDTH).as_int();
+	auto f = [&](int x, int y) { return lut_init[lut_width == 1 ? x : y*2 + x] == State::S1; };
+
+	// The LUT output is replaced by its first input on the A or B port and its
+	// second input on C. D is tied high so that the propagate function lives in
+	// INIT[15:8] and does not overlap with the generate function in INIT[3:0].
+	// The generate function only sees A and B, but it is only used while the
+	// propagate function is low, so it only has to be correct for those inputs.
+	std::vector<State> new_init(16, State::S0);
+	for (int x = 0; x < 2; x++)
+	for (int other = 0; other < 2; other++) {
+		State gen = State::Sx;
+		for (int y = 0; y < 2; y++) {
+			int a = lut_on_a ? f(x, y) : other;
+			int b = lut_on_a ? other : f(x, y);
+			int idx = lut_on_a ? other*2 + x : x*2 + other;
+			if (p(a, b)) {
+				new_init[8 + y*4 + idx] = State::S1;
+				continue;
+			}
+			if (inject)
+				continue;
+			State want = g(a, b) ? State::S1 : State::S0;
+			if (gen != State::Sx && gen != want)
+				return;
+			gen = want;
+		}
+		if (gen == State::S1)
+			new_init[lut_on_a ? other*2 + x : x*2 + other] = State::S1;
+	}
+
+	log("  absorbing %s into %s.%s of %s.\n", log_id(st.lut), log_id(st.carry), log_id(st.AB), log_id(pm.module));
+
+	SigSpec lut_a = st.lut->getPort(ID::A);
+	st.carry->setPort(lut_on_a ? port_a : port_b, lut_a[0]);
+	st.carry->setPort(port_c, lut_width == 1 ? SigSpec(State::S0) : SigSpec(lut_a[1]));
+	st.carry->setPort(port_d, State::S1);
+	st.carry->setParam(param_init, Const(new_init));
+
+	pm.autoremove(st.lut);
+}
+
+struct OzixeCarryPass : public Pass {
+	OzixeCarryPass() : Pass("ozixe_carry", "ozixe: absorb LUTs into CCU2C carry cells") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    ozixe_carry [options] [selection]\n");
+		log("\n");
+		log("Absorb $lut cells with one or two inputs into the CCU2C carry cell they drive,\n");
+		log("as created by techmapping $alu cells with +/ozixe/arith_map_ozixe.v and running\n");
+		log("abc afterwards. This packs the logic in front of adders, counters, accumulators\n");
+		log("and comparators (e.g. an enable or a mask on an operand) into the carry chain.\n");
+		log("\n");
+		log("A LUT is absorbed if it only drives the A or B input of one half of a CCU2C,\n");
+		log("and the C and D inputs of that half are constant. The inputs of the LUT are\n");
+		log("connected to the A (or B) and C inputs, and the INIT value of the half is\n");
+		log("recomputed. LUTs that would change the carry generate function are left alone.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		log_header(design, "Executing OZIXE_CARRY pass (absorb LUTs into carry cells).\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++)
+		{
+			break;
+		}
+		extra_args(args, argidx, design);
+
+		for (auto module : design->selected_modules())
+			ozixe_carry_pm(module, module->selected_cells()).run_ozixe_carry(pack_ozixe_carry);
+	}
+} OzixeCarryPass;
+
+PRIVATE_NAMESPACE_END
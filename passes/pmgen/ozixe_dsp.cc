@@ -0,0 +1,110 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/yosys.h"
+#include "kernel/sigtools.h"
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+#include "passes/pmgen/ozixe_dsp_pm.h"
+
+void create_ozixe_dsp(ozixe_dsp_pm &pm)
+{
+	auto &st = pm.st_ozixe_dsp;
+
+	log("Checking %s.%s for ozixe DSP register packing.\n", log_id(pm.module), log_id(st.mul));
+
+	log_debug("ffA:    %s\n", log_id(st.ffA, "--"));
+	log_debug("ffB:    %s\n", log_id(st.ffB, "--"));
+	log_debug("mul:    %s\n", log_id(st.mul, "--"));
+	log_debug("ffY:    %s\n", log_id(st.ffY, "--"));
+	log_debug("\n");
+
+	Cell *cell = st.mul;
+
+	auto clock_enable = [&](Cell *ff) -> SigSpec {
+		if (!ff->hasPort(ID::EN))
+			return State::S1;
+		if (ff->getParam(ID::EN_POLARITY).as_bool())
+			return ff->getPort(ID::EN);
+		return pm.module->Not(NEW_ID, ff->getPort(ID::EN));
+	};
+
+	if (st.ffA) {
+		log("  input A register %s.\n", log_id(st.ffA));
+		cell->setPort(ID::A, st.sigA);
+		cell->setPort(ID(CEA), clock_enable(st.ffA));
+	}
+	if (st.ffB) {
+		log("  input B register %s.\n", log_id(st.ffB));
+		cell->setPort(ID::B, st.sigB);
+		cell->setPort(ID(CEB), clock_enable(st.ffB));
+	}
+	if (st.ffY) {
+		log("  output register %s.\n", log_id(st.ffY));
+		SigSpec Y = cell->getPort(ID::Y);
+		st.ffY->connections_.at(ID::Q).replace(st.sigY, pm.module->addWire(NEW_ID, GetSize(st.sigY)));
+		Y.replace(0, st.sigY);
+		cell->setPort(ID::Y, Y);
+		cell->setPort(ID(CEY), clock_enable(st.ffY));
+	}
+
+	cell->setPort(ID::CLK, st.clock);
+	cell->setParam(ID(A_REG), st.ffA ? State::S1 : State::S0);
+	cell->setParam(ID(B_REG), st.ffB ? State::S1 : State::S0);
+	cell->setParam(ID(Y_REG), st.ffY ? State::S1 : State::S0);
+
+	pm.blacklist(cell);
+}
+
+struct OzixeDspPass : public Pass {
+	OzixeDspPass() : Pass("ozixe_dsp", "ozixe: pack registers into DSP multipliers") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    ozixe_dsp [options] [selection]\n");
+		log("\n");
+		log("Pack registers on the inputs (A, B) and on the output of $__MUL18X18 cells, as\n");
+		log("created by techmapping $mul cells with mul2dsp.v, into the multiplier. The\n");
+		log("registers are implemented by the input and output registers of MULT18X18D\n");
+		log("when the cells are mapped with +/ozixe/dsp_map_18x18.v afterwards.\n");
+		log("\n");
+		log("All packed registers of a multiplier have to share a positive edge clock. Clock\n");
+		log("enables are supported, resets and initial values other than zero are not.\n");
+		log("MULT18X18D has neither a pre-adder nor an accumulator, so adders next to the\n");
+		log("multiplier are left to the soft logic.\n");
+		log("\n");
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design *design) override
+	{
+		log_header(design, "Executing OZIXE_DSP pass (pack registers into multipliers).\n");
+
+		size_t argidx;
+		for (argidx = 1; argidx < args.size(); argidx++)
+		{
+			break;
+		}
+		extra_args(args, argidx, design);
+
+		for (auto module : design->selected_modules())
+			ozixe_dsp_pm(module, module->selected_cells()).run_ozixe_dsp(create_ozixe_dsp);
+	}
+} OzixeDspPass;
+
+PRIVATE_NAMESPACE_END
@@ -0,0 +1,311 @@
+/*
+ *  yosys -- Yosys Open SYnthesis Suite
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#include "kernel/register.h"
+#include "kernel/satgen.h"
+#include "kernel/log.h"
+#include <fstream>
+
+#if !defined(YOSYS_DISABLE_SPAWN) && !defined(_WIN32)
+#  include <chrono>
+#  include <errno.h>
+#  include <poll.h>
+#  include <signal.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+USING_YOSYS_NAMESPACE
+PRIVATE_NAMESPACE_BEGIN
+
+#if !defined(YOSYS_DISABLE_SPAWN)
+
+#if !defined(_WIN32)
+// Like run_command(), but the command runs in its own process group, which is killed once timeout seconds (if
+// non-zero) have passed. Returns the exit status of the command, or -1 if it was killed or could not be started.
+static int run_command_timeout(const std::string &command, int timeout, bool &timed_out, std::function<void(const std::string&)> process_line)
+{
+	timed_out = false;
+
+	int pipefd[2];
+	if (pipe(pipefd) < 0)
+		return -1;
+
+	pid_t pid = fork();
+	if (pid < 0) {
+		close(pipefd[0]);
+		close(pipefd[1]);
+		return -1;
+	}
+
+	if (pid == 0) {
+		setpgid(0, 0);
+		dup2(pipefd[1], STDOUT_FILENO);
+		close(pipefd[0]);
+		close(pipefd[1]);
+		execl("/bin/sh", "sh", "-c", command.c_str(), (char*)nullptr);
+		_exit(127);
+	}
+
+	setpgid(pid, pid);
+	close(pipefd[1]);
+
+	auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout);
+	std::string line;
+	char buffer[4096];
+
+	while (1) {
+		int poll_timeout = -1;
+		if (timeout > 0) {
+			auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+			if (remaining <= 0) {
+				timed_out = true;
+				break;
+			}
+			poll_timeout = remaining;
+		}
+
+		struct pollfd pfd;
+		pfd.fd = pipefd[0];
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		int ret = poll(&pfd, 1, poll_timeout);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret == 0)
+			continue;
+		if (ret < 0)
+			break;
+
+		ssize_t n = read(pipefd[0], buffer, sizeof(buffer));
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			break;
+		for (ssize_t i = 0; i < n; i++) {
+			line += buffer[i];
+			if (buffer[i] == '\n')
+				process_line(line), line.clear();
+		}
+	}
+
+	close(pipefd[0]);
+	if (timed_out)
+		kill(-pid, SIGKILL);
+	else if (!line.empty())
+		process_line(line);
+
+	int status;
+	while (waitpid(pid, &status, 0) < 0)
+		if (errno != EINTR)
+			return -1;
+	if (timed_out || !WIFEXITED(status))
+		return -1;
+	return WEXITSTATUS(status);
+}
+#endif
+
+// An ezSAT backend that runs an external solver on a DIMACS file. The solver is expected to print its result in the
+// format of the SAT competition ("s SATISFIABLE" and "v ..." lines). All clauses added so far and the assumptions of
+// the current call (as unit clauses) are written for every call, so this supports the full incremental interface
+// of ezSAT, just without sharing any work between calls.
+struct ezCmdlineSAT : public ezSAT
+{
+	std::string command;
+	std::vector<std::vector<int>> clauses;
+#ifdef _WIN32
+	bool warned_timeout = false;
+#endif
+
+	ezCmdlineSAT(const std::string &command) : command(command) { }
+
+	void clear() override
+	{
+		clauses.clear();
+		ezSAT::clear();
+	}
+
+	bool solver(const std::vector<int> &modelExpressions, std::vector<bool> &modelValues, const std::vector<int> &assumptions) override
+	{
+		preSolverCallback();
+		solverTimoutStatus = false;
+
+		std::vector<int> assumption_lits, model_lits;
+		for (auto id : assumptions)
+			assumption_lits.push_back(bind(id));
+		for (auto id : modelExpressions)
+			model_lits.push_back(bind(id));
+
+		std::vector<std::vector<int>> new_clauses;
+		consumeCnf(new_clauses);
+		clauses.insert(clauses.end(), new_clauses.begin(), new_clauses.end());
+
+		std::string filename = make_temp_file(get_base_tmpdir() + "/yosys-satsolver-XXXXXX");
+		{
+			std::ofstream f(filename);
+			if (f.fail())
+				log_error("Can't open temporary file `%s' for writing.\n", filename.c_str());
+			f << stringf("p cnf %d %d\n", numCnfVariables(), GetSize(clauses) + GetSize(assumption_lits));
+			for (auto &clause : clauses) {
+				for (auto lit : clause)
+					f << lit << " ";
+				f << "0\n";
+			}
+			for (auto lit : assumption_lits)
+				f << lit << " 0\n";
+		}
+
+#ifdef _WIN32
+		std::string cmd = command + " \"" + filename + "\"";
+#else
+		std::string cmd = command + " '";
+		for (char c : filename)
+			if (c == '\'')
+				cmd += "'\\''";
+			else
+				cmd += c;
+		cmd += "'";
+#endif
+
+		enum { UNKNOWN, SAT, UNSAT } result = UNKNOWN;
+		std::vector<bool> values(numCnfVariables() + 1);
+		auto process_line = [&](const std::string &line) {
+			if (line.rfind("s SATISFIABLE", 0) == 0)
+				result = SAT;
+			else if (line.rfind("s UNSATISFIABLE", 0) == 0)
+				result = UNSAT;
+			else if (line.rfind("v ", 0) == 0)
+				for (auto &token : split_tokens(line.substr(2))) {
+					int lit = atoi(token.c_str());
+					if (lit != 0 && abs(lit) <= numCnfVariables())
+						values[abs(lit)] = lit > 0;
+				}
+		};
+#ifdef _WIN32
+		if (solverTimeout > 0 && !warned_timeout) {
+			log_warning("The `cmdline' SAT solver does not support timeouts on this platform.\n");
+			warned_timeout = true;
+		}
+		int status = run_command(cmd, process_line);
+#else
+		bool timed_out;
+		int status = run_command_timeout(cmd, solverTimeout, timed_out, process_line);
+#endif
+		remove(filename.c_str());
+
+#ifndef _WIN32
+		if (timed_out) {
+			solverTimoutStatus = true;
+			return false;
+		}
+#endif
+		if (result == UNKNOWN) {
+			log_error("SAT solver command `%s' returned %d without a result.\n", cmd.c_str(), status);
+		}
+		if (result == UNSAT)
+			return false;
+
+		modelValues.clear();
+		for (auto lit : model_lits)
+			modelValues.push_back(values[abs(lit)] == (lit > 0));
+		return true;
+	}
+};
+
+struct CmdlineSatSolver : public SatSolver {
+	std::string command;
+	CmdlineSatSolver() : SatSolver("cmdline") { }
+	ezSAT *create() override {
+		if (command.empty())
+			log_error("No command given for the `cmdline' SAT solver, use `satsolver -cmd <command>'.\n");
+		return new ezCmdlineSAT(command);
+	}
+} CmdlineSatSolver;
+
+#endif
+
+struct SatSolverPass : public Pass {
+	SatSolverPass() : Pass("satsolver", "select the SAT solver") { }
+	void help() override
+	{
+		//   |---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|---v---|
+		log("\n");
+		log("    satsolver [<name>]\n");
+		log("\n");
+		log("Select the SAT solver used by all commands that solve SAT problems internally,\n");
+		log("such as sat, freduce, equiv_simple, equiv_induct and the SAT based optimizations\n");
+		log("of opt_dff and memory_*. When called without arguments, the available solvers\n");
+		log("are listed and the selected one is marked.\n");
+		log("\n");
+		log("The following solvers are always available:\n");
+		log("\n");
+		log("    minisat\n");
+		log("        the included copy of MiniSat (the default).\n");
+		log("\n");
+		log("    cdcl\n");
+		log("        the CDCL solver from libs/ezsat, with bounded variable elimination\n");
+		log("        and LBD based clause database reduction. Like MiniSat it keeps its\n");
+		log("        learned clauses between incremental calls.\n");
+		log("\n");
+#if !defined(YOSYS_DISABLE_SPAWN)
+		log("    cmdline\n");
+		log("        an external solver, see -cmd.\n");
+		log("\n");
+		log("    satsolver -cmd <command>\n");
+		log("\n");
+		log("Select the 'cmdline' solver, which runs the given command with the name of a\n");
+		log("DIMACS file appended for every query. The command has to print the result in\n");
+		log("the format of the SAT competition, as e.g. kissat or cadical do. The solver is\n");
+		log("run from scratch for every query, so this is most useful for a small number of\n");
+		log("hard problems. Except on Windows, a timeout (e.g. sat -timeout) kills the\n");
+		log("solver process.\n");
+		log("\n");
+#endif
+	}
+	void execute(std::vector<std::string> args, RTLIL::Design*) override
+	{
+#if !defined(YOSYS_DISABLE_SPAWN)
+		if (args.size() == 3 && args[1] == "-cmd") {
+			std::string command = args[2];
+			if (command.size() >= 2 && command.front() == '\"' && command.back() == '\"')
+				command = command.substr(1, command.size() - 2);
+			CmdlineSatSolver.command = command;
+			yosys_satsolver = &CmdlineSatSolver;
+			log("Selected SAT solver `cmdline' (`%s').\n", command.c_str());
+			return;
+		}
+#endif
+
+		if (args.size() == 2) {
+			for (auto solver = yosys_satsolver_list; solver != nullptr; solver = solver->next)
+				if (solver->name == args[1]) {
+					yosys_satsolver = solver;
+					log("Selected SAT solver `%s'.\n", solver->name.c_str());
+					return;
+				}
+			log_cmd_error("No SAT solver named `%s'.\n", args[1].c_str());
+		}
+
+		if (args.size() != 1)
+			cmd_error(args, 1, "Unexpected argument.");
+
+		for (auto solver = yosys_satsolver_list; solver != nullptr; solver = solver->next)
+			log("%s %s\n", solver == yosys_satsolver ? "*" : " ", solver->name.c_str());
+	}
+} SatSolverPass;
+
+PRIVATE_NAMESPACE_END
@@ -1175,6 +1175,20 @@ struct SimInstance
 		return did_something;
 	}
 
+	void collectFstHandles(std::vector<fstHandle> &handles)
+	{
+		for (auto &item : fst_handles)
+			if (item.second != 0)
+				handles.push_back(item.second);
+		for (auto &item : fst_inputs)
+			handles.push_back(item.second);
+		for (auto &mem : fst_memories)
+			for (auto &data : mem.second)
+				handles.push_back(data.second);
+		for (auto child : children)
+			child.second->collectFstHandles(handles);
+	}
+
 	void addAdditionalInputs()
 	{
 		for (auto cell : module->cells())
@@ -1507,6 +1521,11 @@ struct SimWorker : SimShared
 
 		top->addAdditionalInputs();
 
+		// Only the signals of the simulated hierarchy need to be decoded from the FST file.
+		std::vector<fstHandle> fst_required;
+		top->collectFstHandles(fst_required);
+		fst->setRequiredSignals(fst_required);
+
 		uint64_t startCount = 0;
 		uint64_t stopCount = 0;
 		if (start_time==0) {
@@ -2422,6 +2441,11 @@ struct FSTWriter : public OutputWriter
 
 		fstWriterSetPackType(fstfile, FST_WR_PT_FASTLZ);
 		fstWriterSetRepackOnClose(fstfile, 1);
+#ifdef FST_WRITER_PARALLEL
+		// A full value change block is compressed and written on a separate thread while the next one is being
+		// filled. Only one block is in flight at a time, so the file is the same as without the thread.
+		fstWriterSetParallelMode(fstfile, 1);
+#endif
 	   
 	   	worker->top->write_output_header(
 			[this](IdString name) { fstWriterSetScope(fstfile, FST_ST_VCD_MODULE, stringf("%s",log_id(name)).c_str(), nullptr); },
@@ -2435,27 +2459,35 @@ struct FSTWriter : public OutputWriter
 			}
 		);
 
+		std::string buf;
+		int steps = 0;
 		for(auto& d : worker->output_data)
 		{
+			// Cut the trace into blocks of a fixed number of steps, so that blocks can be compressed in parallel
+			// with emitting the following ones, and so that a reader can skip to a late part of the trace.
+			if (++steps % FST_BLOCK_STEPS == 0)
+				fstWriterFlushContext(fstfile);
 			fstWriterEmitTimeChange(fstfile, d.first);
 			for (auto &data : d.second)
 			{
 				if (!use_signal.at(data.first)) continue;
-				Const value = data.second;
-				std::stringstream ss;
+				const Const &value = data.second;
+				buf.clear();
 				for (int i = GetSize(value)-1; i >= 0; i--) {
 					switch (value[i]) {
-						case State::S0: ss << "0"; break;
-						case State::S1: ss << "1"; break;
-						case State::Sx: ss << "x"; break;
-						default: ss << "z";
+						case State::S0: buf += '0'; break;
+						case State::S1: buf += '1'; break;
+						case State::Sx: buf += 'x'; break;
+						default: buf += 'z';
 					}
 				}
-				fstWriterEmitValueChange(fstfile, mapping[data.first], ss.str().c_str());
+				fstWriterEmitValueChange(fstfile, mapping[data.first], buf.c_str());
 			}
 		}
 	}
 
+	static const int FST_BLOCK_STEPS = 16384;
+
 	struct fstContext *fstfile = nullptr;
 	std::map<int,fstHandle> mapping;
 };
@@ -2595,7 +2627,8 @@ struct SimPass : public Pass {
 		log("        write the simulation results to the given VCD file\n");
 		log("\n");
 		log("    -fst <filename>\n");
-		log("        write the simulation results to the given FST file\n");
+		log("        write the simulation results to the given FST file. blocks of the\n");
+		log("        file are compressed on a separate thread where supported.\n");
 		log("\n");
 		log("    -aiw <filename>\n");
 		log("        write the simulation results to an AIGER witness file\n");
@@ -2668,7 +2701,8 @@ struct SimPass : public Pass {
 		log("        sets start and stop time\n");
 		log("\n");
 		log("    -start <time>\n");
-		log("        start co-simulation in arbitary time (default 0)\n");
+		log("        start co-simulation in arbitary time (default 0). the FST blocks that\n");
+		log("        end before this time are skipped without being decoded.\n");
 		log("\n");
 		log("    -stop <time>\n");
 		log("        stop co-simulation in arbitary time (default END)\n");
@@ -307,15 +307,8 @@ struct ClockgatePass : public Pass {
 
 		if (!liberty_files.empty()) {
 			LibertyMergedCells merged;
-			for (auto path : liberty_files) {
-				std::ifstream f;
-				f.open(path.c_str());
-				if (f.fail())
-					log_cmd_error("Can't open liberty file `%s': %s\n", path.c_str(), strerror(errno));
-				LibertyParser p(f);
-				merged.merge(p);
-				f.close();
-			}
+			for (auto path : liberty_files)
+				merged.merge(LibertyCache::load(path));
 			std::tie(pos_icg_desc, neg_icg_desc) =
 				find_icgs(merged.cells, dont_use_cells);
 		} else {
@@ -629,15 +629,8 @@ struct DfflibmapPass : public Pass {
 			log_cmd_error("Missing `-liberty liberty_file' option!\n");
 
 		LibertyMergedCells merged;
-		for (auto path : liberty_files) {
-			std::ifstream f;
-			f.open(path.c_str());
-			if (f.fail())
-				log_cmd_error("Can't open liberty file `%s': %s\n", path.c_str(), strerror(errno));
-			LibertyParser p(f);
-			merged.merge(p);
-			f.close();
-		}
+		for (auto path : liberty_files)
+			merged.merge(LibertyCache::load(path));
 
 		find_cell(merged.cells, ID($_DFF_N_), false, false, false, false, false, false, dont_use_cells);
 		find_cell(merged.cells, ID($_DFF_P_), true, false, false, false, false, false, dont_use_cells);
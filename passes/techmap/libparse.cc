@@ -28,6 +28,14 @@
 
 #ifndef FILTERLIB
 #include "kernel/log.h"
+#include <sys/stat.h>
+#endif
+
+#if !defined(FILTERLIB) && !defined(_WIN32) && !defined(__wasm)
+#  define LIBPARSE_USE_MMAP
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
 #endif
 
 using namespace Yosys;
@@ -226,26 +234,31 @@ bool LibertyExpression::eval(dict<std::string, bool>& values) {
 }
 #endif
 
+LibertyParser::LibertyParser(std::istream &f) :
+		buffer(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>()),
+		data(buffer.data()), size(buffer.size()), pos(0), line(1), ast(parse())
+{
+}
+
 int LibertyParser::lexer(std::string &str)
 {
 	int c;
 
 	// eat whitespace
 	do {
-		c = f.get();
+		c = get();
 	} while (c == ' ' || c == '\t' || c == '\r');
 
 	// search for identifiers, numbers, plus or minus.
 	if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.') {
-		str = static_cast<char>(c);
+		size_t start = pos - 1;
 		while (1) {
-			c = f.get();
-			if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.')
-				str += c;
-			else
+			c = get();
+			if (!(('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_' || c == '-' || c == '+' || c == '.'))
 				break;
 		}
-		f.unget();
+		unget();
+		str.assign(data + start, pos - start);
 		if (str == "+" || str == "-") {
 			/* Single operator is not an identifier */
 			// fprintf(stderr, "LEX: char >>%s<<\n", str.c_str());
@@ -260,59 +273,60 @@ int LibertyParser::lexer(std::string &str)
 	// if it wasn't an identifer, number of array range,
 	// maybe it's a string?
 	if (c == '"') {
-		str = "";
 #ifdef FILTERLIB
-		str += c;
+		size_t start = pos - 1;
+#else
+		size_t start = pos;
 #endif
 		while (1) {
-			c = f.get();
+			c = get();
 			if (c == '\n')
 				line++;
-			if (c == '"') {
-#ifdef FILTERLIB
-				str += c;
-#endif
+			if (c == '"' || c == EOF)
 				break;
-			}
-			str += c;
 		}
+#ifdef FILTERLIB
+		str.assign(data + start, std::min(pos, size) - start);
+#else
+		str.assign(data + start, std::min(pos - 1, size) - start);
+#endif
 		// fprintf(stderr, "LEX: string >>%s<<\n", str.c_str());
 		return 'v';
 	}
 
 	// if it wasn't a string, perhaps it's a comment or a forward slash?
 	if (c == '/') {
-		c = f.get();
+		c = get();
 		if (c == '*') {         // start of '/*' block comment
 			int last_c = 0;
 			while (c > 0 && (last_c != '*' || c != '/')) {
 				last_c = c;
-				c = f.get();
+				c = get();
 				if (c == '\n')
 					line++;
 			}
 			return lexer(str);
 		} else if (c == '/') {  // start of '//' line comment
 			while (c > 0 && c != '\n')
-				c = f.get();
+				c = get();
 			line++;
 			return lexer(str);
 		}
-		f.unget();
+		unget();
 		// fprintf(stderr, "LEX: char >>/<<\n");
 		return '/';             // a single '/' charater.
 	}
 
 	// check for a backslash
 	if (c == '\\') {
-		c = f.get();		
+		c = get();		
 		if (c == '\r')
-			c = f.get();
+			c = get();
 		if (c == '\n') {
 			line++;
 			return lexer(str);
 		}
-		f.unget();
+		unget();
 		return '\\';
 	}
 
@@ -503,6 +517,110 @@ LibertyAst *LibertyParser::parse()
 
 #ifndef FILTERLIB
 
+struct LibertyCacheEntry
+{
+	// a file rewritten within the same second often keeps its size, so the
+	// sub-second modification time and the inode are compared as well
+	long long mtime, mtime_nsec, ctime, size, ino, dev;
+	std::shared_ptr<const LibertyAst> ast;
+
+	LibertyCacheEntry() : mtime(0), mtime_nsec(0), ctime(0), size(0), ino(0), dev(0) {}
+	LibertyCacheEntry(const struct stat &st) :
+			mtime(st.st_mtime), ctime(st.st_ctime), size(st.st_size), ino(st.st_ino), dev(st.st_dev)
+	{
+#if defined(__APPLE__)
+		mtime_nsec = st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+		mtime_nsec = 0;
+#else
+		mtime_nsec = st.st_mtim.tv_nsec;
+#endif
+	}
+
+	bool matches(const LibertyCacheEntry &other) const {
+		return mtime == other.mtime && mtime_nsec == other.mtime_nsec && ctime == other.ctime &&
+				size == other.size && ino == other.ino && dev == other.dev;
+	}
+};
+
+static dict<std::string, LibertyCacheEntry> liberty_cache;
+
+#ifdef LIBPARSE_USE_MMAP
+struct LibertyMappedFile
+{
+	void *data;
+	size_t size;
+
+	LibertyMappedFile(int fd, size_t size) : size(size) {
+		data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	}
+	~LibertyMappedFile() {
+		if (data != MAP_FAILED)
+			munmap(data, size);
+	}
+};
+#endif
+
+std::shared_ptr<const LibertyAst> LibertyCache::load(const std::string &filename)
+{
+	struct stat st;
+	if (stat(filename.c_str(), &st) != 0)
+		log_cmd_error("Can't open liberty file `%s': %s\n", filename.c_str(), strerror(errno));
+
+	LibertyCacheEntry entry(st);
+	auto it = liberty_cache.find(filename);
+	if (it != liberty_cache.end() && it->second.matches(entry)) {
+		log("Using already parsed liberty file `%s'.\n", filename.c_str());
+		return it->second.ast;
+	}
+
+	std::shared_ptr<const LibertyAst> ast;
+	bool parsed = false;
+#ifdef LIBPARSE_USE_MMAP
+	if (S_ISREG(st.st_mode) && st.st_size > 0) {
+		int fd = open(filename.c_str(), O_RDONLY);
+		if (fd < 0)
+			log_cmd_error("Can't open liberty file `%s': %s\n", filename.c_str(), strerror(errno));
+		LibertyMappedFile mapped(fd, st.st_size);
+		close(fd);
+		if (mapped.data != MAP_FAILED) {
+			LibertyParser parser(static_cast<const char*>(mapped.data), mapped.size);
+			ast.reset(parser.ast);
+			parser.ast = nullptr;
+			parsed = true;
+		}
+	}
+#endif
+	if (!parsed) {
+		std::ifstream f(filename.c_str());
+		if (f.fail())
+			log_cmd_error("Can't open liberty file `%s': %s\n", filename.c_str(), strerror(errno));
+		LibertyParser parser(f);
+		ast.reset(parser.ast);
+		parser.ast = nullptr;
+	}
+
+	entry.ast = ast;
+	liberty_cache[filename] = entry;
+	return ast;
+}
+
+void LibertyCache::clear()
+{
+	liberty_cache.clear();
+}
+
+std::shared_ptr<const LibertyAst> LibertyCache::load(std::istream &f, const std::string &filename)
+{
+	if (dynamic_cast<std::ifstream*>(&f) != nullptr)
+		return load(filename);
+
+	LibertyParser parser(f);
+	std::shared_ptr<const LibertyAst> ast(parser.ast);
+	parser.ast = nullptr;
+	return ast;
+}
+
 void LibertyParser::error() const
 {
 	log_error("Syntax error in liberty file on line %d.\n", line);
@@ -25,6 +25,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <memory>
 
 namespace Yosys
 {
@@ -95,9 +96,17 @@ namespace Yosys
 	{
 		friend class LibertyMergedCells;
 	private:
-		std::istream &f;
+		// the input is either a memory-mapped file or the contents of a
+		// stream read into buffer; pos may run past size at EOF, so that
+		// unget() after reading EOF behaves like for a stream.
+		std::string buffer;
+		const char *data;
+		size_t size, pos;
 		int line;
 
+		int get() { return pos < size ? (unsigned char)data[pos++] : (pos++, EOF); }
+		void unget() { pos--; }
+
 		/* lexer return values:
 		   'v': identifier, string, array range [...] -> str holds the token string
 		   'n': newline
@@ -112,35 +121,52 @@ namespace Yosys
 	public:
 		const LibertyAst *ast;
 
-		LibertyParser(std::istream &f) : f(f), line(1), ast(parse()) {}
+		LibertyParser(std::istream &f);
+		LibertyParser(const char *data, size_t size) : data(data), size(size), pos(0), line(1), ast(parse()) {}
 		~LibertyParser() { if (ast) delete ast; }
 	};
 
+#ifndef FILTERLIB
+	// Parsed liberty files are kept until the design is reset and shared by
+	// all commands reading the same file, as long as the file is not changed.
+	// Files are memory-mapped for parsing where possible.
+	struct LibertyCache
+	{
+		static std::shared_ptr<const LibertyAst> load(const std::string &filename);
+		// for input opened by a frontend, only plain files are cached
+		static std::shared_ptr<const LibertyAst> load(std::istream &f, const std::string &filename);
+		// drops all parsed files, called by `design -reset' and friends
+		static void clear();
+	};
+#endif
+
 	class LibertyMergedCells
 	{
-		std::vector<const LibertyAst *> asts;
+		std::vector<std::shared_ptr<const LibertyAst>> asts;
 
 	public:
 		std::vector<const LibertyAst *> cells;
 		void merge(LibertyParser &parser)
 		{
 			if (parser.ast) {
-				const LibertyAst *ast = parser.ast;
-				asts.push_back(ast);
 				// The parser no longer owns its top level ast, but we do.
-				// sketchy zone
+				std::shared_ptr<const LibertyAst> ast(parser.ast);
 				parser.ast = nullptr;
 				if (ast->id != "library")
 					parser.error("Top level entity isn't \"library\".\n");
-				for (const LibertyAst *cell : ast->children)
-					if (cell->id == "cell" && cell->args.size() == 1)
-						cells.push_back(cell);
+				merge(ast);
 			}
 		}
-		~LibertyMergedCells()
+		void merge(std::shared_ptr<const LibertyAst> ast)
 		{
-			for (auto ast : asts)
-				delete ast;
+			if (ast == nullptr)
+				return;
+			if (ast->id != "library")
+				log_error("Top level entity isn't \"library\".\n");
+			asts.push_back(ast);
+			for (const LibertyAst *cell : ast->children)
+				if (cell->id == "cell" && cell->args.size() == 1)
+					cells.push_back(cell);
 		}
 	};
 
@@ -2,84 +2,81 @@
 	CRÉATION DE OZIXE
 	Auteur : Bertolelli Mateo et son amie le C
 */
+
+// Les $alu plus larges que 4 bits sont mappés sur la chaîne de retenue CCU2C,
+// deux bits par cellule. Les plus petits restent dans les LUT, c'est plus
+// rapide que d'entrer puis sortir de la chaîne.
+//
+// Chaque moitié calcule la propagation A ^ B ^ BI dans INIT[15:8] (D = 1) et
+// la génération A dans INIT[3:0] ; C reste libre tant que BI est constant, ce
+// qui permet à ozixe_carry d'y absorber une LUT voisine après abc.
 (* techmap_celltype = "$alu" *)
-module full_adder_lut16 (
-    input  A,
-    input  B,
-    input  Cin,
-    output Sum,
-    output Cout
-);
-    // On va créer un signal de 4 bits pour la LUT, où l'on place nos 3 entrées et une constante 0.
-    // Par exemple, on peut définir : I = { 1'b0, Cin, B, A }.
-    wire [3:0] I = {1'b0, Cin, B, A};
+module _80_ozixe_alu (A, B, CI, BI, X, Y, CO);
+	parameter A_SIGNED = 0;
+	parameter B_SIGNED = 0;
+	parameter A_WIDTH = 1;
+	parameter B_WIDTH = 1;
+	parameter Y_WIDTH = 1;
 
-    // On doit construire une entrée de 16 bits pour la LUT16 du package,
-    // en plaçant nos 4 bits dans les 4 bits de poids faibles et en
-    // complétant le reste par des zéros.
-    wire [15:0] LUT_input = {12'b0, I};
+	(* force_downto *)
+	input [A_WIDTH-1:0] A;
+	(* force_downto *)
+	input [B_WIDTH-1:0] B;
+	(* force_downto *)
+	output [Y_WIDTH-1:0] X, Y;
 
-    // La table de vérité pour Sum (full adder/additionneur) pour les 8 premiers indices :
-    // A  B  Cin | Sum  Cout
-    // 0  0  0  :   0    0   -> 0
-    // 0  0  1  :   1    0   -> 1
-    // 0  1  0  :   1    0   -> 1
-    // 0  1  1  :   0    1   -> 0
-    // 1  0  0  :   1    0   -> 1
-    // 1  0  1  :   0    1   -> 0
-    // 1  1  0  :   0    1   -> 0
-    // 1  1  1  :   1    1   -> 1
-    //
-    // Pour la LUT16, on définit le paramètre INIT sur 16 bits.
-    // Pour Sum, on pourra par exemple étendre ce motif aux 16 cases (les 8
-    // cases supérieures seront identiques).
-    localparam [15:0] INIT_SUM = 16'b0110100101101001; 
+	input CI, BI;
+	(* force_downto *)
+	output [Y_WIDTH-1:0] CO;
 
-    // Pour Cout, la table (pour les 8 premières cases) est :
-    // 0:0, 1:0, 2:0, 3:1, 4:0, 5:1, 6:1, 7:1.
-    localparam [15:0] INIT_COUT = 16'b1110100011101000; 
+	wire _TECHMAP_FAIL_ = Y_WIDTH <= 4;
 
-    // On instancie deux LUT16 :
-    LUT16 lut_sum (.I(LUT_input), .O(Sum));
-    defparam lut_sum.INIT = INIT_SUM;
-    
-    LUT16 lut_cout (.I(LUT_input), .O(Cout));
-    defparam lut_cout.INIT = INIT_COUT;
-    
-endmodule
+	(* force_downto *)
+	wire [Y_WIDTH-1:0] A_buf, B_buf;
+	\$pos #(.A_SIGNED(A_SIGNED), .A_WIDTH(A_WIDTH), .Y_WIDTH(Y_WIDTH)) A_conv (.A(A), .Y(A_buf));
+	\$pos #(.A_SIGNED(B_SIGNED), .A_WIDTH(B_WIDTH), .Y_WIDTH(Y_WIDTH)) B_conv (.A(B), .Y(B_buf));
 
-module adder_16bit (
-    input  [15:0] A,
-    input  [15:0] B,
-    input         Cin,
-    output [15:0] Sum,
-    output        Cout
-);
-    wire [15:0] carry;
-    genvar i;
-    generate
-        for (i = 0; i < 16; i = i + 1) begin: full_adder_array
-            if (i == 0) begin
-                full_adder_lut16 fa (
-                    .A(A[i]),
-                    .B(B[i]),
-                    .Cin(Cin),
-                    .Sum(Sum[i]),
-                    .Cout(carry[i])
-                );
-            end else begin
-                full_adder_lut16 fa (
-                    .A(A[i]),
-                    .B(B[i]),
-                    .Cin(carry[i-1]),
-                    .Sum(Sum[i]),
-                    .Cout(carry[i])
-                );
-            end
-        end
-    endgenerate
-    assign Cout = carry[15];
-endmodule
+	function integer round_up2;
+		input integer N;
+		begin
+			round_up2 = ((N + 1) / 2) * 2;
+		end
+	endfunction
 
+	localparam Y_WIDTH2 = round_up2(Y_WIDTH);
 
+	(* force_downto *)
+	wire [Y_WIDTH2-1:0] AA = A_buf;
+	(* force_downto *)
+	wire [Y_WIDTH2-1:0] BB = BI ? ~B_buf : B_buf;
+	(* force_downto *)
+	wire [Y_WIDTH2-1:0] BX = B_buf;
+	(* force_downto *)
+	wire [Y_WIDTH2-1:0] C = {CO, CI};
+	(* force_downto *)
+	wire [Y_WIDTH2-1:0] FCO, Y1;
 
+	genvar i;
+	generate for (i = 0; i < Y_WIDTH2; i = i + 2) begin:slice
+		CCU2C #(
+			.INIT0(16'b1001011010101010),
+			.INIT1(16'b1001011010101010),
+			.INJECT1_0("NO"),
+			.INJECT1_1("NO")
+		) ccu2c_i (
+			.CIN(C[i]),
+			.A0(AA[i]), .B0(BX[i]), .C0(BI), .D0(1'b1),
+			.A1(AA[i+1]), .B1(BX[i+1]), .C1(BI), .D1(1'b1),
+			.S0(Y[i]), .S1(Y1[i]),
+			.COUT(FCO[i])
+		);
+
+		assign CO[i] = (AA[i] && BB[i]) || (C[i] && (AA[i] || BB[i]));
+		if (i+1 < Y_WIDTH) begin
+			assign CO[i+1] = FCO[i];
+			assign Y[i+1] = Y1[i];
+		end
+	end endgenerate
+
+	assign X = AA ^ BB;
+endmodule
@@ -30,6 +30,8 @@ module DP16KD (...);
     parameter CSDECODE_A = "0b000";
     parameter CSDECODE_B = "0b000";
     parameter GSR = "ENABLED";
+    parameter CLKAMUX = "CLKA";
+    parameter CLKBMUX = "CLKB";
     parameter INITVAL_00 = 320'h00000000000000000000000000000000000000000000000000000000000000000000000000000000;
     parameter INITVAL_01 = 320'h00000000000000000000000000000000000000000000000000000000000000000000000000000000;
     parameter INITVAL_02 = 320'h00000000000000000000000000000000000000000000000000000000000000000000000000000000;
@@ -211,6 +213,16 @@ module DP16KD (...);
     output DOB2;
     output DOB1;
     output DOB0;
+    specify
+        (posedge CLKA => ({DOA17, DOA16, DOA15, DOA14, DOA13, DOA12, DOA11, DOA10, DOA9, DOA8, DOA7, DOA6, DOA5, DOA4, DOA3, DOA2, DOA1, DOA0} : {DIA17, DIA16, DIA15, DIA14, DIA13, DIA12, DIA11, DIA10, DIA9, DIA8, DIA7, DIA6, DIA5, DIA4, DIA3, DIA2, DIA1, DIA0})) = 3300;
+        $setup({DIA17, DIA16, DIA15, DIA14, DIA13, DIA12, DIA11, DIA10, DIA9, DIA8, DIA7, DIA6, DIA5, DIA4, DIA3, DIA2, DIA1, DIA0}, posedge CLKA, 120);
+        $setup({ADA13, ADA12, ADA11, ADA10, ADA9, ADA8, ADA7, ADA6, ADA5, ADA4, ADA3, ADA2, ADA1, ADA0}, posedge CLKA, 120);
+        $setup({CEA, OCEA, WEA, CSA2, CSA1, CSA0, RSTA}, posedge CLKA, 120);
+        (posedge CLKB => ({DOB17, DOB16, DOB15, DOB14, DOB13, DOB12, DOB11, DOB10, DOB9, DOB8, DOB7, DOB6, DOB5, DOB4, DOB3, DOB2, DOB1, DOB0} : {DIB17, DIB16, DIB15, DIB14, DIB13, DIB12, DIB11, DIB10, DIB9, DIB8, DIB7, DIB6, DIB5, DIB4, DIB3, DIB2, DIB1, DIB0})) = 3300;
+        $setup({DIB17, DIB16, DIB15, DIB14, DIB13, DIB12, DIB11, DIB10, DIB9, DIB8, DIB7, DIB6, DIB5, DIB4, DIB3, DIB2, DIB1, DIB0}, posedge CLKB, 120);
+        $setup({ADB13, ADB12, ADB11, ADB10, ADB9, ADB8, ADB7, ADB6, ADB5, ADB4, ADB3, ADB2, ADB1, ADB0}, posedge CLKB, 120);
+        $setup({CEB, OCEB, WEB, CSB2, CSB1, CSB0, RSTB}, posedge CLKB, 120);
+    endspecify
 endmodule
 
 (* blackbox *)
@@ -399,6 +411,33 @@ module PDPW16KD (...);
     output DO2;
     output DO1;
     output DO0;
+    specify
+        (posedge CLKR => ({DO35, DO34, DO33, DO32, DO31, DO30, DO29, DO28, DO27, DO26, DO25, DO24, DO23, DO22, DO21, DO20, DO19, DO18, DO17, DO16, DO15, DO14, DO13, DO12, DO11, DO10, DO9, DO8, DO7, DO6, DO5, DO4, DO3, DO2, DO1, DO0} : {DI35, DI34, DI33, DI32, DI31, DI30, DI29, DI28, DI27, DI26, DI25, DI24, DI23, DI22, DI21, DI20, DI19, DI18, DI17, DI16, DI15, DI14, DI13, DI12, DI11, DI10, DI9, DI8, DI7, DI6, DI5, DI4, DI3, DI2, DI1, DI0})) = 3300;
+        $setup({DI35, DI34, DI33, DI32, DI31, DI30, DI29, DI28, DI27, DI26, DI25, DI24, DI23, DI22, DI21, DI20, DI19, DI18, DI17, DI16, DI15, DI14, DI13, DI12, DI11, DI10, DI9, DI8, DI7, DI6, DI5, DI4, DI3, DI2, DI1, DI0}, posedge CLKW, 120);
+        $setup({ADW8, ADW7, ADW6, ADW5, ADW4, ADW3, ADW2, ADW1, ADW0}, posedge CLKW, 120);
+        $setup({BE3, BE2, BE1, BE0, CEW, CSW2, CSW1, CSW0}, posedge CLKW, 120);
+        $setup({ADR13, ADR12, ADR11, ADR10, ADR9, ADR8, ADR7, ADR6, ADR5, ADR4, ADR3, ADR2, ADR1, ADR0}, posedge CLKR, 120);
+        $setup({CER, OCER, CSR2, CSR1, CSR0, RST}, posedge CLKR, 120);
+    endspecify
+endmodule
+
+(* blackbox *)
+module TRELLIS_DPR16X4 (...);
+    parameter WCKMUX = "WCK";
+    parameter WREMUX = "WRE";
+    parameter [63:0] INITVAL = 64'h0000000000000000;
+    input [3:0] DI;
+    input [3:0] WAD;
+    input WRE;
+    input WCK;
+    input [3:0] RAD;
+    output [3:0] DO;
+    specify
+        (RAD *> DO) = 379;
+        $setup(DI, posedge WCK, 0);
+        $setup(WAD, posedge WCK, 0);
+        $setup(WRE, posedge WCK, 0);
+    endspecify
 endmodule
 
 (* blackbox *)
@@ -213,587 +213,95 @@ endmodule
 `include "cells_io.vh"
 
 `ifndef NO_LUT
-module $lut (A, Y);
-    parameter WIDTH = 0;       // Nombre d'entrées effectives (1 à 16)
-    //parameter [0:(1<<WIDTH)-1] LUT = 0;  // Valeur d'INIT originale sur 2^(WIDTH) bits 
+// Les LUT de la cible sont des LUT4 natives (table de 16 entrées). Les LUT plus
+// petites sont complétées en répliquant leur table, les LUT de 5 à 7 entrées
+// utilisent les muxes PFUMX/L6MUX21 (sauf avec -D NO_PFUMUX).
+module \$lut (A, Y);
+    parameter WIDTH = 0;
     parameter LUT = 0;
 
     (* force_downto *)
-    input [WIDTH-1:0] A; 
+    input [WIDTH-1:0] A;
     output Y;
 
     generate
-        if (WIDTH == 1) begin 
-            assign Y = ~A[0];
+        if (WIDTH == 1) begin
+            localparam [15:0] INIT = {8{LUT[1:0]}};
+            LUT4 #(.INIT(INIT)) _TECHMAP_REPLACE_ (.O(Y),
+                .I0(A[0]), .I1(1'b0), .I2(1'b0), .I3(1'b0));
         end else
         if (WIDTH == 2) begin
-            LUT4 #(.INIT(LUT)) _TECHMAP_REPLACE_ (.O(Y),
-            .I0(A[0]), .I1(A[1]), .I2(0), .I3(0));
+            localparam [15:0] INIT = {4{LUT[3:0]}};
+            LUT4 #(.INIT(INIT)) _TECHMAP_REPLACE_ (.O(Y),
+                .I0(A[0]), .I1(A[1]), .I2(1'b0), .I3(1'b0));
         end else
         if (WIDTH == 3) begin
-            LUT4 #(.INIT(LUT)) _TECHMAP_REPLACE_ (.O(Y),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
+            localparam [15:0] INIT = {2{LUT[7:0]}};
+            LUT4 #(.INIT(INIT)) _TECHMAP_REPLACE_ (.O(Y),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(1'b0));
         end else
         if (WIDTH == 4) begin
             LUT4 #(.INIT(LUT)) _TECHMAP_REPLACE_ (.O(Y),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+        `ifndef NO_PFUMUX
         end else
         if (WIDTH == 5) begin
-            wire f0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(A[0]), .I2(0), .I3(0)); 
+            wire f0, f1;
+            LUT4 #(.INIT(LUT[15: 0])) lut0 (.O(f0),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[31:16])) lut1 (.O(f1),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            PFUMX mux5(.ALUT(f1), .BLUT(f0), .C0(A[4]), .Z(Y));
         end else
         if (WIDTH == 6) begin
-            wire f0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(A[0]), .I2(A[1]), .I3(0));
+            wire f0, f1, f2, f3, g0, g1;
+            LUT4 #(.INIT(LUT[15: 0])) lut0 (.O(f0),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[31:16])) lut1 (.O(f1),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            LUT4 #(.INIT(LUT[47:32])) lut2 (.O(f2),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[63:48])) lut3 (.O(f3),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            PFUMX mux50(.ALUT(f1), .BLUT(f0), .C0(A[4]), .Z(g0));
+            PFUMX mux51(.ALUT(f3), .BLUT(f2), .C0(A[4]), .Z(g1));
+            L6MUX21 mux6 (.D0(g0), .D1(g1), .SD(A[5]), .Z(Y));
         end else
         if (WIDTH == 7) begin
-            wire f0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(A[0]), .I2(A[1]), .I3(A[2]));
-        end else
-        if (WIDTH == 8) begin
-            wire f0, f1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 9) begin
-            wire f0, f1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(A[0]), .I3(0));
-        end else
-        if (WIDTH == 10) begin
-            wire f0, f1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(A[0]), .I3(A[1]));
-        end else
-        if (WIDTH == 11) begin
-            wire f0, f1, f2;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(0));
-        end else
-        if (WIDTH == 12) begin
-            wire f0, f1, f2;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(0));
-        end else
-        if (WIDTH == 13) begin
-            wire f0, f1, f2;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(A[0]));
-        end else
-        if (WIDTH == 14) begin
-            wire f0, f1, f2, f3;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(0), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-        end else
-        if (WIDTH == 15) begin
-            wire f0, f1, f2, f3;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-        end else
-        if (WIDTH == 16) begin
-            wire f0, f1, f2, f3;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-        end else
-        if (WIDTH == 17) begin
-            wire f0, f1, f2, f3, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) _TECHMAP_REPLACE_ (.O(Y),
-            .I0(g0), .I1(A[0]), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 18) begin
-            wire f0, f1, f2, f3, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(A[0]), .I2(A[1]), .I3(0));
-        end else
-        if (WIDTH == 19) begin
-            wire f0, f1, f2, f3, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(A[0]), .I2(A[1]), .I3(A[2]));
-        end else
-        if (WIDTH == 20) begin
-            wire f0, f1, f2, f3, d0, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 21) begin
-            wire f0, f1, f2, f3, d0, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(A[0]), .I3(0));
-        end else
-        if (WIDTH == 22) begin
-            wire f0, f1, f2, f3, d0, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(A[0]), .I3(A[1]));
-        end else
-        if (WIDTH == 23) begin
-            wire f0, f1, f2, f3, d0, d1, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(0));
-        end else
-        if (WIDTH == 24) begin
-            wire f0, f1, f2, f3, d0, d1, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(0));
-        end else
-        if (WIDTH == 25) begin
-            wire f0, f1, f2, f3, d0, d1, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(A[0]));
-        end else
-        if (WIDTH == 26) begin
-            wire f0, f1, f2, f3, d0, d1, d2, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(0), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(d2));
-        end else
-        if (WIDTH == 27) begin
-            wire f0, f1, f2, f3, d0, d1, d2, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(d2));
-        end else
-        if (WIDTH == 28) begin
-            wire f0, f1, f2, f3, d0, d1, d2, g0;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(d0), .I2(d1), .I3(d2));
-        end else
-        if (WIDTH == 29) begin
-            wire f0, f1, f2, f3, d0, d1, d2, d3, g0, g1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut7 (.O(d3),
-            .I0(A[0]), .I1(0), .I2(0), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-            LUT4 #(.INIT(LUT)) lut_int1 (.O(g1),
-            .I0(d0), .I1(d1), .I2(d2), .I3(d3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(g1), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 30) begin
-            wire f0, f1, f2, f3, d0, d1, d2, d3, g0, g1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut7 (.O(d3),
-            .I0(A[0]), .I1(A[1]), .I2(0), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-            LUT4 #(.INIT(LUT)) lut_int1 (.O(g1),
-            .I0(d0), .I1(d1), .I2(d2), .I3(d3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(g1), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 31) begin
-            wire f0, f1, f2, f3, d0, d1, d2, d3, g0, g1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut4 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(0));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-            LUT4 #(.INIT(LUT)) lut_int1 (.O(g1),
-            .I0(d0), .I1(d1), .I2(d2), .I3(d3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(g1), .I2(0), .I3(0));
-        end else
-        if (WIDTH == 32) begin
-            wire f0, f1, f2, f3, d0, d1, d2, d3, g0, g1;
-
-            LUT4 #(.INIT(LUT)) lut0 (.O(f0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut1 (.O(f1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut2 (.O(f2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut3 (.O(f3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut4 (.O(d0),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut5 (.O(d1),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut6 (.O(d2),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-            LUT4 #(.INIT(LUT)) lut7 (.O(d3),
-            .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
-
-            LUT4 #(.INIT(LUT)) lut_int0 (.O(g0),
-            .I0(f0), .I1(f1), .I2(f2), .I3(f3));
-            LUT4 #(.INIT(LUT)) lut_int1 (.O(g1),
-            .I0(d0), .I1(d1), .I2(d2), .I3(d3));
-
-            LUT4 #(.INIT(LUT)) lut_final (.O(Y),
-            .I0(g0), .I1(g1), .I2(0), .I3(0));
-        end 
+            wire f0, f1, f2, f3, f4, f5, f6, f7, g0, g1, g2, g3, h0, h1;
+            LUT4 #(.INIT(LUT[15: 0])) lut0 (.O(f0),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[31:16])) lut1 (.O(f1),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            LUT4 #(.INIT(LUT[47:32])) lut2 (.O(f2),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[63:48])) lut3 (.O(f3),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            LUT4 #(.INIT(LUT[79:64])) lut4 (.O(f4),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[95:80])) lut5 (.O(f5),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            LUT4 #(.INIT(LUT[111: 96])) lut6 (.O(f6),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+            LUT4 #(.INIT(LUT[127:112])) lut7 (.O(f7),
+                .I0(A[0]), .I1(A[1]), .I2(A[2]), .I3(A[3]));
+
+            PFUMX mux50(.ALUT(f1), .BLUT(f0), .C0(A[4]), .Z(g0));
+            PFUMX mux51(.ALUT(f3), .BLUT(f2), .C0(A[4]), .Z(g1));
+            PFUMX mux52(.ALUT(f5), .BLUT(f4), .C0(A[4]), .Z(g2));
+            PFUMX mux53(.ALUT(f7), .BLUT(f6), .C0(A[4]), .Z(g3));
+            L6MUX21 mux60 (.D0(g0), .D1(g1), .SD(A[5]), .Z(h0));
+            L6MUX21 mux61 (.D0(g2), .D1(g3), .SD(A[5]), .Z(h1));
+            L6MUX21 mux7  (.D0(h0), .D1(h1), .SD(A[6]), .Z(Y));
+        `endif
+        end else begin
+            wire _TECHMAP_FAIL_ = 1;
+        end
     endgenerate
-
-    /*
-    // Compléter à 16 bits : placer les bits d'entrée dans les bits de poids faibles
-    wire [15:0] I = { {(16-WIDTH){1'b0}}, A }; // Concaténation (si A a une largeur de 4 alors wire sera "0000 0000 0000 "4 bits de A")
-
-    // Étendre la table de vérité à 2^16 bits en répétant le motif original.
-    localparam integer REPL = (1 << (16 - WIDTH)); // on réplique l'entrée sur WIDTH bits sur tous les bits restant 
-    localparam [65535:0] INIT_EXT = { REPL { LUT } };
-
-    // Instancier le module LUT16 
-    LUT16 lut16_inst (
-        .I(I),
-        .O(Y)
-    );
-    defparam lut16_inst.INIT = INIT_EXT; */
 endmodule
 `endif
-
-//module LUT16 (input [15:0] I, output O);
-//    parameter [65535:0] INIT = 65536'b0;
-//    assign O = INIT[{I[15], I[14], I[13], I[12],
-//                     I[11], I[10], I[9],  I[8],
-//                     I[7],  I[6],  I[5],  I[4],
-//                     I[3],  I[2],  I[1],  I[0]}];
-//endmodule
-(* keep *)
-module LUT4 (input [3:0] I, output O);
-    parameter [15:0] INIT = 16'b0;
-    assign O = INIT[{I[3], I[2], I[1], I[0]}];
-endmodule
-
-module LUT2 (input [1:0] I, output O);
-    parameter [3:0] INIT = 3'b0;
-    assign O = INIT[{I[1], I[0]}];
-endmodule
@@ -1,7 +1,53 @@
-(* keep *)
+// Délais approximatifs en ps, du même ordre que ceux de la ECP5. abc9 les lit
+// via (* abc9_lut *) et les blocs specify, sta via les mêmes blocs specify.
+(* keep, abc9_lut=1 *)
 module LUT4 (input I0, I1, I2, I3, output O);
     parameter [15:0] INIT = 16'b0;
     assign O = INIT[{I3, I2, I1, I0}];
+    specify
+        (I0 => O) = 141;
+        (I1 => O) = 275;
+        (I2 => O) = 379;
+        (I3 => O) = 379;
+    endspecify
+endmodule
+
+// LUT5 à LUT7 : uniquement pour donner à abc9 le coût et les délais des LUT
+// larges (2, 4 ou 8 LUT4 avec PFUMX/L6MUX21), jamais instanciées
+(* abc9_lut=2 *)
+module \$__ABC9_LUT5 (input M0, I3, I2, I1, I0, output O);
+    specify
+        (M0 => O) = 151;
+        (I3 => O) = 239;
+        (I2 => O) = 373;
+        (I1 => O) = 477;
+        (I0 => O) = 477;
+    endspecify
+endmodule
+
+(* abc9_lut=4 *)
+module \$__ABC9_LUT6 (input M1, M0, I3, I2, I1, I0, output O);
+    specify
+        (M1 => O) = 148;
+        (M0 => O) = 292;
+        (I3 => O) = 380;
+        (I2 => O) = 514;
+        (I1 => O) = 618;
+        (I0 => O) = 618;
+    endspecify
+endmodule
+
+(* abc9_lut=8 *)
+module \$__ABC9_LUT7 (input M2, M1, M0, I3, I2, I1, I0, output O);
+    specify
+        (M2 => O) = 148;
+        (M1 => O) = 289;
+        (M0 => O) = 433;
+        (I3 => O) = 521;
+        (I2 => O) = 655;
+        (I1 => O) = 759;
+        (I0 => O) = 759;
+    endspecify
 endmodule
 
 (* keep *)
@@ -16,4 +62,84 @@ module OZIXE_FF (
             Q <= 1'b0;
         else
             Q <= D;
+    specify
+        $setup(D, posedge clk, 0);
+        (posedge clk => (Q : D)) = 395;
+        (rst => Q) = 395;
+    endspecify
+endmodule
+
+// Muxes des LUT larges (LUT5 à LUT7)
+(* keep *)
+module PFUMX (input ALUT, BLUT, C0, output Z);
+    assign Z = C0 ? ALUT : BLUT;
+    specify
+        (ALUT => Z) = 98;
+        (BLUT => Z) = 98;
+        (C0 => Z) = 151;
+    endspecify
+endmodule
+
+(* keep *)
+module L6MUX21 (input D0, D1, SD, output Z);
+    assign Z = SD ? D1 : D0;
+    specify
+        (D0 => Z) = 140;
+        (D1 => Z) = 141;
+        (SD => Z) = 148;
+    endspecify
+endmodule
+
+// Cellule de retenue : deux demi-additionneurs (LUT4 + LUT2) et leur chaîne
+(* abc9_box, lib_whitebox *)
+module CCU2C (
+    (* abc9_carry *)
+    input  CIN,
+    input  A0, B0, C0, D0, A1, B1, C1, D1,
+    output S0, S1,
+    (* abc9_carry *)
+    output COUT
+);
+    parameter [15:0] INIT0 = 16'h0000;
+    parameter [15:0] INIT1 = 16'h0000;
+    parameter INJECT1_0 = "YES";
+    parameter INJECT1_1 = "YES";
+
+    // Première moitié : la LUT2 (génération) lit INIT0[3:0]
+    wire lut4_0 = INIT0[{D0, C0, B0, A0}];
+    wire lut2_0 = (INJECT1_0 == "YES") ? 1'b0 : INIT0[{B0, A0}];
+    assign S0 = lut4_0 ^ ((INJECT1_0 == "YES") ? 1'b0 : CIN);
+    wire cout_0 = lut4_0 ? CIN : lut2_0;
+
+    // Seconde moitié
+    wire lut4_1 = INIT1[{D1, C1, B1, A1}];
+    wire lut2_1 = (INJECT1_1 == "YES") ? 1'b0 : INIT1[{B1, A1}];
+    assign S1 = lut4_1 ^ ((INJECT1_1 == "YES") ? 1'b0 : cout_0);
+    assign COUT = lut4_1 ? cout_0 : lut2_1;
+
+    specify
+        (A0 => S0) = 379;
+        (B0 => S0) = 379;
+        (C0 => S0) = 275;
+        (D0 => S0) = 141;
+        (CIN => S0) = 257;
+        (A0 => S1) = 630;
+        (B0 => S1) = 630;
+        (C0 => S1) = 526;
+        (D0 => S1) = 392;
+        (A1 => S1) = 379;
+        (B1 => S1) = 379;
+        (C1 => S1) = 275;
+        (D1 => S1) = 141;
+        (CIN => S1) = 273;
+        (A0 => COUT) = 516;
+        (B0 => COUT) = 516;
+        (C0 => COUT) = 412;
+        (D0 => COUT) = 278;
+        (A1 => COUT) = 516;
+        (B1 => COUT) = 516;
+        (C1 => COUT) = 412;
+        (D1 => COUT) = 278;
+        (CIN => COUT) = 43;
+    endspecify
 endmodule
@@ -41,8 +41,10 @@
 		 log("    synth_ozixe [options]\n");
 		 log("\n");
 		 log("This command runs synthesis for ozixe FPGAs using a custom flow that converts\n");
-		 log("all logic into LUT16 cells. Les primitives FPGA spécifiques (RAM, IO, etc.)\n");
-		 log("ne sont pas utilisées.\n");
+		 log("all logic into LUT16 cells. Memories are mapped to DP16KD/PDPW16KD block RAM\n");
+		 log("and TRELLIS_DPR16X4 LUT RAM cells, multipliers to MULT18X18D and adders and\n");
+		 log("comparators to CCU2C carry chains, the other FPGA primitives (IO, etc.) are not\n");
+		 log("used.\n");
 		 log("\n");
 		 log("    -top <module>\n");
 		 log("        use the specified module as top module\n");
@@ -78,7 +80,7 @@
 		 log("        do not use LUT RAM cells in output netlist\n");
 		 log("\n");
 		 log("    -nowidelut\n");
-		 log("        do not implement wide LUT structures (PFU muxes)\n");
+		 log("        do not use PFU muxes to implement LUTs larger than LUT4s\n");
 		 log("\n");
 		 log("    -widelut\n");
 		 log("        force use of wide LUT muxes\n");
@@ -90,7 +92,10 @@
 		 log("        run two passes of 'abc' for improved logic density\n");
 		 log("\n");
 		 log("    -abc9\n");
-		 log("        use new ABC9 flow (EXPERIMENTAL)\n");
+		 log("        use new ABC9 flow (EXPERIMENTAL). The LUT, carry, flip-flop and RAM\n");
+		 log("        cells carry specify delays, so ABC9 maps for delay. The wire delay\n");
+		 log("        passed to 'abc9 -W' is the 'synth_ozixe.abc9.W' global constant,\n");
+		 log("        unless the design scratchpad has an entry with the same name.\n");
 		 log("\n");
 		 log("    -iopad\n");
 		 log("        insert IO buffers\n");
@@ -104,6 +109,9 @@
 		 log("    -cmp2softlogic\n");
 		 log("        implement constant comparisons in soft logic\n");
 		 log("\n");
+		 log("The primitive cells in the output design keep their specify delays, so 'sta'\n");
+		 log("can be run after this command to report the critical path.\n");
+		 log("\n");
 		 log("The following commands are executed by this synthesis command:\n");
 		 help_script();
 		 log("\n");
@@ -258,9 +266,10 @@
 		 if (help_mode)
 			 no_rw_check_opt = " [-no-rw-check]";
  
-		 // NE PAS charger les primitives spécifiques (cells_sim et cells_bb)
+		 // Les primitives natives (LUT4, muxes, CCU2C, OZIXE_FF) et les boîtes noires (RAM,
+		 // DSP, ...) sont chargées comme bibliothèque
 		 if (check_label("begin")) {
-			 // Pour un flow custom, on n'inclut pas les fichiers de primitives
+			 run("read_verilog -lib -specify +/ozixe/ozixe_primitives.v +/ozixe/cells_bb_ozixe.v");
 			 run(stringf("hierarchy -check %s", help_mode ? "-top <top>" : top_opt.c_str()));
 		 }
  
@@ -285,8 +294,17 @@
 			 run("techmap -map +/cmp2lut.v -D LUT_WIDTH=4");
 			 run("opt_expr");
 			 run("opt_clean");
-			 if (!nodsp) {
-				 // On ignore le mapping DSP puisque nous n'utilisons pas de primitives DSP custom
+			 if (!nodsp || help_mode) {
+				 run("memory_dff" + no_rw_check_opt, "(unless -nodsp)"); // ozixe_dsp will merge registers, reserve memory port registers first
+				 run("techmap -map +/mul2dsp.v -D DSP_A_MAXWIDTH=18 -D DSP_B_MAXWIDTH=18 -D DSP_A_MINWIDTH=2 -D DSP_B_MINWIDTH=2 -D DSP_NAME=$__MUL18X18", "(unless -nodsp)");
+				 run("select a:mul2dsp", "              (unless -nodsp)");
+				 run("setattr -unset mul2dsp", "        (unless -nodsp)");
+				 run("opt_expr -fine", "                (unless -nodsp)");
+				 run("wreduce", "                       (unless -nodsp)");
+				 run("select -clear", "                 (unless -nodsp)");
+				 run("ozixe_dsp", "                     (unless -nodsp)");
+				 run("techmap -map +/ozixe/dsp_map_18x18.v", "(unless -nodsp)");
+				 run("chtype -set $mul t:$__soft_mul", "(unless -nodsp)");
 			 }
 			 run("alumacc");
 			 run("opt");
@@ -295,7 +313,17 @@
 		 }
  
 		 if (check_label("map_ram")) {
-			 // On ignore le mapping des RAM (pas de primitives de RAM custom)
+			 std::string args = "";
+			 if (help_mode)
+				 args += " [-no-auto-block] [-no-auto-distributed]";
+			 else {
+				 if (nobram)
+					 args += " -no-auto-block";
+				 if (nolutram)
+					 args += " -no-auto-distributed";
+			 }
+			 run("memory_libmap -lib +/ozixe/lutrams.txt -lib +/ozixe/brams_ozixe.txt" + args, "(-no-auto-block if -nobram, -no-auto-distributed if -nolutram)");
+			 run("techmap -map +/ozixe/lutrams_map.v -map +/ozixe/brams_map_ozixe.v");
 		 }
  
 		 if (check_label("map_ffram")) {
@@ -337,7 +365,6 @@
 			 if (abc9 && dff)
 				 run("zinit -all w:* t:$_DFF_?_ t:$_DFFE_??_ t:$_SDFF*");
 			 // Mapper les DFF sur vos cellules custom
-			 run("read_verilog +/ozixe/ozixe_primitives.v");
 			 run("techmap -D NO_LUT -map +/ozixe/cells_map_ozixe.v");
 			 run("opt_expr -undriven -mux_undef");
 			 run("simplemap");
@@ -351,7 +378,12 @@
 				 run("techmap -map +/ozixe/latches_map.v", "(skip if -asyncprld)");
 			 if (abc9) {
 				 std::string abc9_opts;
-				 abc9_opts += " -W 300";
+				 // Délai de fil entre deux cellules, modifiable via le scratchpad
+				 std::string k = "synth_ozixe.abc9.W";
+				 if (active_design && active_design->scratchpad.count(k))
+					 abc9_opts += stringf(" -W %s", active_design->scratchpad_get_string(k).c_str());
+				 else
+					 abc9_opts += stringf(" -W %s", RTLIL::constpad.at(k).c_str());
 				 if (nowidelut)
 					 abc9_opts += " -maxlut 4";
 				 if (dff)
@@ -367,15 +399,19 @@
 					 abc_args += " -dff";
 				 run("abc" + abc_args);
 			 }
+			 // Absorber les petites LUT devant la chaîne de retenue dans les CCU2C
+			 if (!noccu2 || help_mode)
+				 run("ozixe_carry", "(unless -noccu2)");
 			 run("clean");
 		 }
  
 		 if (check_label("map_cells")) {
-			 // Appliquer le mapping final sur vos cellules custom (par ex. LUT16)
-			 //run("read_verilog +/ozixe/ozixe_primitives.v");
-			 run("techmap -map +/ozixe/cells_map_ozixe.v");
-			 // Exécuter opt_lut_ins pour forcer l'utilisation de LUT16 dans le netlist
-			 run("opt_lut_ins -tech ozixe");
+			 // Les $lut sont directement mappées sur les LUT4 natives (LUT16), avec
+			 // PFUMX/L6MUX21 pour les LUT larges
+			 if (nowidelut)
+				 run("techmap -D NO_PFUMUX -map +/ozixe/cells_map_ozixe.v");
+			 else
+				 run("techmap -map +/ozixe/cells_map_ozixe.v", "(with -D NO_PFUMUX if -nowidelut)");
 			 run("clean");
 		 }
  
@@ -384,6 +420,9 @@
 			 run("hierarchy -check");
 			 run("stat");
 			 run("check -noinit");
+			 // Recharger les primitives comme boîtes noires en gardant les blocs
+			 // specify, pour que sta puisse encore lire les délais
+			 run("read_verilog -lib -specify -nowb -overwrite +/ozixe/ozixe_primitives.v");
 			 run("blackbox =A:whitebox");
 		 }
  
@@ -12,6 +12,40 @@ run_subtest () {
 run_subtest value
 run_subtest value_fuzz
 
+# Activity-driven evaluation must match the plain model.
+../../yosys -p "read_verilog test_activity.v; write_cxxrtl -g0 -namespace plain cxxrtl-test-activity-plain.cc; write_cxxrtl -g0 -activity -namespace active cxxrtl-test-activity-active.cc"
+${CC:-gcc} -std=c++14 -O2 -o cxxrtl-test-activity -I../../backends/cxxrtl/runtime test_activity.cc -lstdc++
+./cxxrtl-test-activity
+
+# Partitioned evaluation must match the plain model as well.
+../../yosys -p "read_verilog test_activity.v; write_cxxrtl -g0 -parallel 4 -namespace parallel cxxrtl-test-parallel.cc"
+${CC:-gcc} -std=c++11 -O2 -pthread -o cxxrtl-test-parallel -I../../backends/cxxrtl/runtime test_parallel.cc -lstdc++
+./cxxrtl-test-parallel
+
+# Effects, and the submodules running them, stay on the calling thread and keep their order.
+../../yosys -p "read_verilog test_parallel_effects.v; proc; write_cxxrtl -g0 -noflatten -namespace plain cxxrtl-test-parallel-effects-plain.cc; write_cxxrtl -g0 -noflatten -parallel 4 -namespace parallel cxxrtl-test-parallel-effects.cc"
+${CC:-gcc} -std=c++11 -O2 -pthread -o cxxrtl-test-parallel-effects -I../../backends/cxxrtl/runtime test_parallel_effects.cc -lstdc++
+./cxxrtl-test-parallel-effects
+
+# Replay logs, uncompressed and compressed (also on a separate thread), must replay and seek to the recorded states.
+${CC:-gcc} -std=c++11 -O2 -o cxxrtl-test-replay -I../../backends/cxxrtl/runtime test_replay.cc -lstdc++
+./cxxrtl-test-replay
+${CC:-gcc} -std=c++11 -O2 -pthread -DCXXRTL_REPLAY_BACKGROUND -o cxxrtl-test-replay-background \
+    -I../../backends/cxxrtl/runtime test_replay.cc -lstdc++
+./cxxrtl-test-replay-background
+
+# The VCD writer must produce the same text when formatting on a separate thread.
+${CC:-gcc} -std=c++11 -O2 -pthread -DCXXRTL_VCD_BACKGROUND -o cxxrtl-test-vcd -I../../backends/cxxrtl/runtime test_vcd.cc -lstdc++
+./cxxrtl-test-vcd
+
+# The FST writer must produce a file that the FST library can read back, also when compressing on a separate thread.
+${CC:-gcc} -std=c++11 -O2 -o cxxrtl-test-fst -I../../backends/cxxrtl/runtime -I../../libs/fst test_fst.cc \
+    ../../libs/fst/fstapi.cc ../../libs/fst/fastlz.cc ../../libs/fst/lz4.cc -lstdc++ -lz
+./cxxrtl-test-fst
+${CC:-gcc} -std=c++11 -O2 -pthread -DFST_WRITER_PARALLEL -o cxxrtl-test-fst-parallel -I../../backends/cxxrtl/runtime \
+    -I../../libs/fst test_fst.cc ../../libs/fst/fstapi.cc ../../libs/fst/fastlz.cc ../../libs/fst/lz4.cc -lstdc++ -lz
+./cxxrtl-test-fst-parallel
+
 # Compile-only test.
 ../../yosys -p "read_verilog test_unconnected_output.v; proc; clean; write_cxxrtl cxxrtl-test-unconnected_output.cc"
 ${CC:-gcc} -std=c++11 -c -o cxxrtl-test-unconnected_output -I../../backends/cxxrtl/runtime cxxrtl-test-unconnected_output.cc
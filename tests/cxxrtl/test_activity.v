@@ -0,0 +1,34 @@
+// A free-running counter next to four peripherals that only do work while
+// enabled; most of the design is idle most of the time.
+module peripheral(
+    input             clk,
+    input             en,
+    input      [31:0] din,
+    output reg [31:0] acc
+);
+    wire [31:0] mixed = (acc * 32'd31) ^ (acc >> 3) ^ (din + acc[15:0]);
+    wire [31:0] folded = {mixed[7:0], mixed[31:8]} + (mixed & din);
+
+    always @(posedge clk)
+        if (en)
+            acc <= folded - (mixed >> 5);
+endmodule
+
+module activity(
+    input         clk,
+    input  [3:0]  en,
+    input  [31:0] din,
+    output reg [31:0] count,
+    output [31:0] acc0,
+    output [31:0] acc1,
+    output [31:0] acc2,
+    output [31:0] acc3
+);
+    always @(posedge clk)
+        count <= count + 1;
+
+    peripheral p0 (.clk(clk), .en(en[0]), .din(din), .acc(acc0));
+    peripheral p1 (.clk(clk), .en(en[1]), .din(din ^ 32'h5a5a5a5a), .acc(acc1));
+    peripheral p2 (.clk(clk), .en(en[2]), .din(din + count), .acc(acc2));
+    peripheral p3 (.clk(clk), .en(en[3]), .din(~din), .acc(acc3));
+endmodule
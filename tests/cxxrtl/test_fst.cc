@@ -0,0 +1,58 @@
+#include <cassert>
+#include <cstring>
+
+#include <cxxrtl/cxxrtl.h>
+#include <cxxrtl/cxxrtl_fst.h>
+
+// Values written by the FST writer must be read back by the FST library.
+
+int main()
+{
+	cxxrtl::value<1> bit;
+	cxxrtl::wire<8> byte;
+	cxxrtl::wire<100> wide;
+	cxxrtl::memory<12> mem { 4 };
+
+	cxxrtl::debug_items items;
+	items.add("top bit", cxxrtl::debug_item(bit, 0, cxxrtl::debug_item::DRIVEN_COMB));
+	items.add("top sub byte", cxxrtl::debug_item(byte, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+	items.add("top sub byte_alias", cxxrtl::debug_item(cxxrtl::debug_alias(), byte, 0));
+	items.add("top sub wide", cxxrtl::debug_item(wide, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+	items.add("top sub mem", cxxrtl::debug_item(mem, 0));
+
+	{
+		cxxrtl::fst_writer writer("cxxrtl-test-fst.fst");
+		writer.timescale(1, "ns");
+#ifdef FST_WRITER_PARALLEL
+		writer.parallel();
+#endif
+		writer.add(items);
+		for (uint32_t step = 0; step < 1000; step++) {
+			bit.set<bool>(step & 1);
+			byte.curr.set<uint32_t>((step / 3) & 0xff);
+			wide.curr = wide.curr.shl(cxxrtl::value<1> { 1u }).bit_or(cxxrtl::value<100> { step & 1 });
+			mem[step % 4] = cxxrtl::value<12> { step & 0xfff };
+			writer.sample(step * 10);
+		}
+	}
+
+	void *reader = fstReaderOpen("cxxrtl-test-fst.fst");
+	assert(reader != nullptr);
+	// bit, byte, byte_alias, mem[0..3], wide; handles are assigned in order starting from 1, except that byte_alias
+	// is an alias of byte and has no handle of its own.
+	assert(fstReaderGetVarCount(reader) == 8);
+	assert(fstReaderGetEndTime(reader) == 9990);
+	assert(fstReaderGetTimescale(reader) == -9);
+	fstReaderSetFacProcessMaskAll(reader);
+	char buf[128];
+	// At step 31, `bit` is 1, `byte` is 10, `mem[3]` is 31.
+	assert(strcmp(fstReaderGetValueFromHandleAtTime(reader, 310, 1, buf), "1") == 0);
+	assert(strcmp(fstReaderGetValueFromHandleAtTime(reader, 310, 2, buf), "00001010") == 0);
+	assert(strcmp(fstReaderGetValueFromHandleAtTime(reader, 310, 6, buf), "000000011111") == 0);
+	// `wide` shifts in the low bit of every step, so its low bits alternate.
+	const char *wide_value = fstReaderGetValueFromHandleAtTime(reader, 310, 7, buf);
+	assert(strlen(wide_value) == 100);
+	assert(strcmp(wide_value + 96, "0101") == 0);
+	fstReaderClose(reader);
+	return 0;
+}
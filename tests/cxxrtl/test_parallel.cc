@@ -0,0 +1,32 @@
+#include <cassert>
+
+#include "cxxrtl-test-activity-plain.cc"
+#include "cxxrtl-test-parallel.cc"
+
+template<class T>
+void drive(T &top, unsigned cycle)
+{
+	top.p_en.set(cycle % 7 == 0 ? 0xfu : (cycle >> 4) & 0xfu);
+	top.p_din.set(cycle * 0x9e3779b9u);
+	top.p_clk.set(false);
+	top.step();
+	top.p_clk.set(true);
+	top.step();
+}
+
+int main()
+{
+	plain::p_activity plain_top;
+	parallel::p_activity parallel_top;
+
+	for (unsigned cycle = 0; cycle < 20000; cycle++) {
+		drive(plain_top, cycle);
+		drive(parallel_top, cycle);
+		assert(plain_top.p_count.get<uint32_t>() == parallel_top.p_count.get<uint32_t>());
+		assert(plain_top.p_acc0.get<uint32_t>() == parallel_top.p_acc0.get<uint32_t>());
+		assert(plain_top.p_acc1.get<uint32_t>() == parallel_top.p_acc1.get<uint32_t>());
+		assert(plain_top.p_acc2.get<uint32_t>() == parallel_top.p_acc2.get<uint32_t>());
+		assert(plain_top.p_acc3.get<uint32_t>() == parallel_top.p_acc3.get<uint32_t>());
+	}
+	return 0;
+}
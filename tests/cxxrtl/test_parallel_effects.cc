@@ -0,0 +1,40 @@
+#include <cassert>
+
+#include "cxxrtl-test-parallel-effects-plain.cc"
+#include "cxxrtl-test-parallel-effects.cc"
+
+struct recorder : cxxrtl::performer {
+	std::string text;
+
+	void on_print(const cxxrtl::lazy_fmt &formatter, const cxxrtl::metadata_map &) override {
+		text += formatter();
+	}
+};
+
+template<class T>
+void drive(T &top, recorder &performer, unsigned cycle)
+{
+	top.p_din.set(cycle * 0x9e3779b9u);
+	top.p_clk.set(false);
+	top.step(&performer);
+	top.p_clk.set(true);
+	top.step(&performer);
+}
+
+int main()
+{
+	plain::p_effects plain_top;
+	parallel::p_effects parallel_top;
+	recorder plain_performer, parallel_performer;
+
+	for (unsigned cycle = 0; cycle < 2000; cycle++) {
+		drive(plain_top, plain_performer, cycle);
+		drive(parallel_top, parallel_performer, cycle);
+		assert(plain_top.p_a.get<uint32_t>() == parallel_top.p_a.get<uint32_t>());
+		assert(plain_top.p_b.get<uint32_t>() == parallel_top.p_b.get<uint32_t>());
+		assert(plain_top.p_c.get<uint32_t>() == parallel_top.p_c.get<uint32_t>());
+	}
+	assert(plain_performer.text == parallel_performer.text);
+	assert(!plain_performer.text.empty());
+	return 0;
+}
@@ -0,0 +1,32 @@
+// A submodule with an effect is evaluated on the calling thread, and so is the logic reading its results.
+module logger(
+    input         clk,
+    input  [31:0] value,
+    output [31:0] checksum
+);
+    assign checksum = value ^ {value[15:0], value[31:16]};
+
+    always @(posedge clk)
+        $display("%08x", value);
+endmodule
+
+module effects(
+    input             clk,
+    input      [31:0] din,
+    output reg [31:0] a,
+    output reg [31:0] b,
+    output reg [31:0] c
+);
+    wire [31:0] checksum;
+
+    always @(posedge clk)
+        a <= (a * 32'd5) + din;
+
+    always @(posedge clk)
+        b <= (b >> 1) ^ (din * 32'd3);
+
+    logger l (.clk(clk), .value(a), .checksum(checksum));
+
+    always @(posedge clk)
+        c <= c + (checksum ^ b);
+endmodule
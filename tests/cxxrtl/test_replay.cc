@@ -0,0 +1,162 @@
+#include <cassert>
+#include <cstdio>
+#include <sys/stat.h>
+
+#include <cxxrtl/cxxrtl.h>
+#include <cxxrtl/cxxrtl_replay.h>
+
+// A small hand-written design with an input, registers (one of them wider than a chunk), and a memory.
+struct top : cxxrtl::module {
+	cxxrtl::value<32> p_in;
+	cxxrtl::wire<32> p_acc;
+	cxxrtl::wire<96> p_wide;
+	cxxrtl::memory<16> m_mem { 64 };
+
+	void reset() override {}
+
+	bool eval(cxxrtl::performer *performer = nullptr) override {
+		p_acc.next = p_acc.curr.add(p_in);
+		p_wide.next = p_wide.curr.shl(cxxrtl::value<8> { 1u }).bit_or(p_acc.curr.zext<96>());
+		if (p_in.get<uint32_t>() % 3 == 0)
+			m_mem.update(p_in.get<uint32_t>() % 64, p_acc.curr.trunc<16>(), cxxrtl::value<16> { 0xffffu });
+		return true;
+	}
+
+	template<class ObserverT>
+	bool commit(ObserverT &observer) {
+		bool changed = false;
+		if (p_acc.commit(observer)) changed = true;
+		if (p_wide.commit(observer)) changed = true;
+		if (m_mem.commit(observer)) changed = true;
+		return changed;
+	}
+
+	bool commit() override {
+		cxxrtl::observer observer;
+		return commit<>(observer);
+	}
+
+	void debug_info(cxxrtl::debug_items *items, cxxrtl::debug_scopes *scopes, std::string path, cxxrtl::metadata_map &&cell_attrs = {}) override {
+		items->add(path + "in", cxxrtl::debug_item(p_in, 0, cxxrtl::debug_item::INPUT | cxxrtl::debug_item::UNDRIVEN));
+		items->add(path + "acc", cxxrtl::debug_item(p_acc, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+		items->add(path + "wide", cxxrtl::debug_item(p_wide, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+		items->add(path + "mem", cxxrtl::debug_item(m_mem, 0));
+	}
+};
+
+struct snapshot {
+	cxxrtl::time timestamp;
+	uint32_t acc;
+	cxxrtl::value<96> wide;
+	uint16_t mem[64];
+
+	explicit snapshot(const cxxrtl::time &timestamp, const top &design) : timestamp(timestamp) {
+		acc = design.p_acc.get<uint32_t>();
+		wide = design.p_wide.curr;
+		for (size_t index = 0; index < 64; index++)
+			mem[index] = design.m_mem[index].get<uint16_t>();
+	}
+
+	bool operator==(const snapshot &other) const {
+		if (timestamp != other.timestamp || acc != other.acc || wide != other.wide)
+			return false;
+		for (size_t index = 0; index < 64; index++)
+			if (mem[index] != other.mem[index])
+				return false;
+		return true;
+	}
+};
+
+static const unsigned steps = 5000;
+
+std::vector<snapshot> record(const char *filename, unsigned flags, size_t frame_words)
+{
+	std::vector<snapshot> history;
+	top design;
+	cxxrtl::spool spool(filename);
+	cxxrtl::recorder recorder(spool, flags, frame_words);
+	recorder.start(design);
+	recorder.record_complete();
+	history.emplace_back(recorder.latest_time(), design);
+	for (unsigned step = 0; step < steps; step++) {
+		design.p_in.set<uint32_t>((step * 7) % 13 == 0 ? step : 1);
+		// Several delta cycles share a timestamp.
+		if (step % 4 == 0)
+			recorder.advance_time(cxxrtl::time(0, 1000));
+		design.eval();
+		recorder.record_incremental(design);
+		history.emplace_back(recorder.latest_time(), design);
+		if (step == steps / 2)
+			recorder.record_diagnostic(cxxrtl::diagnostic(cxxrtl::diagnostic::BREAK, "halfway", __FILE__, __LINE__));
+	}
+	return history;
+}
+
+void check(const char *filename, const std::vector<snapshot> &history)
+{
+	top design;
+	cxxrtl::spool spool(filename);
+	cxxrtl::player player(spool);
+	player.start(design);
+
+	// Read the samples in order. The diagnostic sample repeats the state of the previous one.
+	size_t index = 0;
+	assert(snapshot(player.current_time(), design) == history[index]);
+	std::vector<cxxrtl::diagnostic> diagnostics;
+	while (player.replay(&diagnostics)) {
+		if (!diagnostics.empty()) {
+			assert(diagnostics.size() == 1 && diagnostics[0].message == "halfway");
+			diagnostics.clear();
+			continue;
+		}
+		assert(snapshot(player.current_time(), design) == history[++index]);
+	}
+	assert(index + 1 == history.size());
+
+	// Seek to samples in a scrambled order, both by pointer and by time. Pointers are assigned consecutively by
+	// the recorder; the sample with the diagnostic comes right after `steps / 2 + 1` samples.
+	for (unsigned trial = 0; trial < 200; trial++) {
+		size_t target = (trial * 7919) % history.size();
+		cxxrtl::spool::pointer_t pointer = target + (target > steps / 2 + 1 ? 1 : 0);
+		assert(player.rewind_to(pointer, nullptr));
+		assert(snapshot(player.current_time(), design) == history[target]);
+
+		cxxrtl::time timestamp = history[target].timestamp;
+		assert(player.rewind_to_or_before(timestamp, nullptr));
+		size_t first = target;
+		while (first > 0 && history[first - 1].timestamp == timestamp)
+			first--;
+		assert(snapshot(player.current_time(), design) == history[first]);
+	}
+}
+
+off_t file_size(const char *filename)
+{
+	struct stat info;
+	int result = stat(filename, &info);
+	assert(result == 0);
+	return info.st_size;
+}
+
+int main()
+{
+	std::vector<snapshot> raw = record("cxxrtl-test-replay-raw.log", 0, cxxrtl::spool::DEFAULT_FRAME_WORDS);
+	check("cxxrtl-test-replay-raw.log", raw);
+
+	std::vector<snapshot> compressed = record("cxxrtl-test-replay-compressed.log",
+		cxxrtl::spool::COMPRESSED, 4096);
+	assert(compressed.size() == raw.size());
+	check("cxxrtl-test-replay-compressed.log", compressed);
+
+#ifdef CXXRTL_REPLAY_BACKGROUND
+	std::vector<snapshot> background = record("cxxrtl-test-replay-background.log",
+		cxxrtl::spool::COMPRESSED | cxxrtl::spool::BACKGROUND, 4096);
+	check("cxxrtl-test-replay-background.log", background);
+#endif
+
+	printf("raw: %lld bytes, compressed: %lld bytes\n",
+		(long long)file_size("cxxrtl-test-replay-raw.log"),
+		(long long)file_size("cxxrtl-test-replay-compressed.log"));
+	assert(file_size("cxxrtl-test-replay-compressed.log") < file_size("cxxrtl-test-replay-raw.log"));
+	return 0;
+}
@@ -0,0 +1,57 @@
+#include <cassert>
+#include <utility>
+
+#include <cxxrtl/cxxrtl.h>
+#include <cxxrtl/cxxrtl_vcd.h>
+
+// The background mode of the VCD writer must produce exactly the same text as the foreground one.
+
+int main()
+{
+	cxxrtl::value<1> bit;
+	cxxrtl::wire<8> byte;
+	cxxrtl::wire<100> wide;
+	cxxrtl::memory<12> mem { 16 };
+	cxxrtl::value<4> other;
+
+	cxxrtl::debug_items items;
+	items.add("top bit", cxxrtl::debug_item(bit, 0, cxxrtl::debug_item::DRIVEN_COMB));
+	items.add("top sub byte", cxxrtl::debug_item(byte, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+	items.add("top sub wide", cxxrtl::debug_item(wide, 0, cxxrtl::debug_item::DRIVEN_SYNC));
+	items.add("top sub mem", cxxrtl::debug_item(mem, 0));
+	items.add("top subother", cxxrtl::debug_item(other, 0, cxxrtl::debug_item::DRIVEN_COMB));
+
+	cxxrtl::vcd_writer foreground;
+	foreground.timescale(1, "ns");
+	foreground.add_scope(items, "top sub");
+
+	std::string background_text;
+	cxxrtl::vcd_writer background;
+	background.timescale(1, "ns");
+	background.add_scope(items, "top sub");
+	// A tiny ring buffer makes the simulation thread wait for the formatting thread.
+	background.start_background([&](const std::string &text) { background_text += text; }, 16);
+
+	std::string foreground_text;
+	for (uint32_t step = 0; step < 2000; step++) {
+		bit.set<bool>(step & 1);
+		byte.curr.set<uint32_t>((step / 3) & 0xff);
+		wide.curr = wide.curr.shl(cxxrtl::value<1> { 1u }).bit_or(cxxrtl::value<100> { step & 1 });
+		mem[step % 16] = cxxrtl::value<12> { step & 0xfff };
+		other.set<uint32_t>(step & 0xf);
+		foreground.sample(step);
+		foreground_text += foreground.buffer;
+		foreground.buffer.clear();
+		background.sample(step);
+		if (step % 500 == 0)
+			background.flush_background();
+	}
+	// Replacing a writer stops its formatting thread once all of the text has reached the sink.
+	cxxrtl::vcd_writer moved(std::move(background));
+	moved = cxxrtl::vcd_writer();
+
+	assert(foreground_text.find("subother") == std::string::npos);
+	assert(foreground_text.find("$var reg 8 ! byte $end") != std::string::npos);
+	assert(foreground_text == background_text);
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <vector>
+
+#include "my_module_functional_cxx.cc"
+#include "vcd_file.h"
+#include "yw.h"
+
+constexpr size_t lanes = 8;
+
+struct Collect {
+	std::vector<std::string> &values;
+	Collect(std::vector<std::string> &values) : values(values) {}
+
+	template <size_t n> void operator()(const char *, Signal<n> &signal) { values.push_back(signal.as_string()); }
+	template <size_t a, size_t d> void operator()(const char *, Memory<a, d> &) {}
+};
+
+template <typename T> std::vector<std::string> collect(T value)
+{
+	std::vector<std::string> values;
+	value.visit(Collect(values));
+	return values;
+}
+
+// Writes the stimulus of a single instance as a witness trace, in the format read by `yw.h`.
+struct WitnessWriter {
+	std::vector<std::pair<std::string, size_t>> signals;
+	std::vector<std::string> steps;
+
+	template <size_t n> void operator()(const char *name, Signal<n> &) { signals.emplace_back(name, n); }
+
+	struct Step {
+		std::string bits;
+		template <size_t n> void operator()(const char *, Signal<n> &signal)
+		{
+			// The first signal is at the end of the string.
+			std::string signal_bits;
+			for (size_t i = n; i-- > 0;)
+				signal_bits += signal[i] ? '1' : '0';
+			bits = signal_bits + bits;
+		}
+	};
+	template <typename Inputs> void step(Inputs inputs)
+	{
+		Step s;
+		inputs.visit(s);
+		steps.push_back(s.bits);
+	}
+
+	std::string str() const
+	{
+		std::stringstream ss;
+		ss << "{\"format\": \"Yosys Witness Trace\", \"clocks\": [], \"signals\": [";
+		for (size_t i = 0; i < signals.size(); i++)
+			ss << (i ? ", " : "") << "{\"path\": [\"\\\\" << signals[i].first << "\"], \"offset\": 0, \"width\": "
+				<< signals[i].second << ", \"init_only\": false}";
+		ss << "], \"steps\": [";
+		for (size_t i = 0; i < steps.size(); i++)
+			ss << (i ? ", " : "") << "{\"bits\": \"" << steps[i] << "\"}";
+		ss << "]}\n";
+		return ss.str();
+	}
+};
+
+int main(int argc, char **argv)
+{
+	if (argc != 4) {
+		std::cerr << "Usage: " << argv[0] << " <functional_vcd_filename> <steps> <seed>\n";
+		return 1;
+	}
+
+	const std::string functional_vcd_filename = argv[1];
+	const int steps = atoi(argv[2]);
+	const uint32_t seed = atoi(argv[3]);
+
+	using Batch = gold::Batch<lanes>;
+	Batch::Inputs inputs;
+	Batch::Outputs outputs;
+	Batch::State state;
+	Batch::State next_state;
+
+	gold::State reference_state[lanes];
+	for (size_t lane = 0; lane < lanes; lane++)
+		gold::initialize(reference_state[lane]);
+	Batch::initialize(state);
+
+	std::ofstream vcd_file(functional_vcd_filename);
+	VcdFile vcd(vcd_file);
+	vcd.header(inputs.get(0), outputs.get(0), state.get(0));
+
+	std::mt19937 gen(seed);
+	WitnessWriter witness_writer;
+	gold::Inputs{}.visit(witness_writer);
+	std::vector<std::vector<std::string>> lane0_outputs;
+
+	for (int step = 0; step < steps; ++step) {
+		for (size_t lane = 0; lane < lanes; lane++) {
+			gold::Inputs lane_inputs;
+			lane_inputs.visit(Randomize(gen));
+			inputs.set(lane, lane_inputs);
+		}
+		witness_writer.step(inputs.get(0));
+
+		Batch::eval(inputs, outputs, state, next_state);
+		vcd.data(step, inputs.get(0), outputs.get(0), state.get(0));
+		lane0_outputs.push_back(collect(outputs.get(0)));
+
+		// Every lane must behave exactly like a separate instance.
+		for (size_t lane = 0; lane < lanes; lane++) {
+			gold::Outputs reference_outputs;
+			gold::State reference_next_state;
+			gold::eval(inputs.get(lane), reference_outputs, reference_state[lane], reference_next_state);
+			if (collect(reference_outputs) != collect(outputs.get(lane)) ||
+					collect(reference_next_state) != collect(next_state.get(lane))) {
+				std::cerr << "Mismatch in lane " << lane << " at step " << step << "\n";
+				return 1;
+			}
+			reference_state[lane] = reference_next_state;
+		}
+
+		state = next_state;
+	}
+
+	// Replaying the stimulus of the first lane from a witness trace must reproduce its outputs.
+	YwWitness witness;
+	std::stringstream witness_text(witness_writer.str());
+	std::string error;
+	if (!witness.read(witness_text, error)) {
+		std::cerr << "Cannot read witness: " << error << "\n";
+		return 1;
+	}
+	if (witness.size() != (size_t)steps) {
+		std::cerr << "Witness has " << witness.size() << " steps instead of " << steps << "\n";
+		return 1;
+	}
+	gold::State replay_state;
+	gold::initialize(replay_state);
+	witness.apply_initial(replay_state);
+	for (int step = 0; step < steps; ++step) {
+		gold::Inputs replay_inputs;
+		gold::Outputs replay_outputs;
+		gold::State replay_next_state;
+		witness.apply_inputs(step, replay_inputs);
+		gold::eval(replay_inputs, replay_outputs, replay_state, replay_next_state);
+		if (collect(replay_outputs) != lane0_outputs[step]) {
+			std::cerr << "Witness replay mismatch at step " << step << "\n";
+			return 1;
+		}
+		replay_state = replay_next_state;
+	}
+
+	return 0;
+}
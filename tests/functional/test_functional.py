@@ -55,6 +55,21 @@ def test_cxx(cell, parameters, tmp_path, num_steps, rnd):
     run([str(vcdharness_exe_file.resolve()), str(vcd_functional_file), str(num_steps), str(seed)])
     yosys_sim(rtlil_file, vcd_functional_file, vcd_yosys_sim_file, getattr(cell, 'sim_preprocessing', ''))
 
+def test_cxx_batch(cell, parameters, tmp_path, num_steps, rnd):
+    rtlil_file = tmp_path / 'rtlil.il'
+    batchharness_cc_file = base_path / 'tests/functional/batch_harness.cc'
+    cc_file = tmp_path / 'my_module_functional_cxx.cc'
+    batchharness_exe_file = tmp_path / 'a.out'
+    vcd_functional_file = tmp_path / 'functional.vcd'
+    vcd_yosys_sim_file = tmp_path / 'yosys.vcd'
+
+    cell.write_rtlil_file(rtlil_file, parameters)
+    yosys(f"read_rtlil {quote(rtlil_file)} ; clk2fflogic ; write_functional_cxx -batch {quote(cc_file)}")
+    compile_cpp(batchharness_cc_file, batchharness_exe_file, ['-I', tmp_path, '-I', str(base_path / 'tests/functional'), '-I', str(base_path / 'backends/functional/cxx_runtime')])
+    seed = str(rnd(cell.name + "-cxx-batch").getrandbits(32))
+    run([str(batchharness_exe_file.resolve()), str(vcd_functional_file), str(num_steps), str(seed)])
+    yosys_sim(rtlil_file, vcd_functional_file, vcd_yosys_sim_file, getattr(cell, 'sim_preprocessing', ''))
+
 @pytest.mark.smt
 def test_smt(cell, parameters, tmp_path, num_steps, rnd):
     import smt_vcd
@@ -92,3 +107,17 @@ def test_print_graph(tmp_path):
     cpu_file = base_path / 'tests/functional/picorv32.v'
     # currently we only check that we can print the graph without getting an error, not that it prints anything sensibl
     yosys(f"read_verilog {quote(tb_file)} {quote(cpu_file)}; prep -top gold; flatten; clk2fflogic; test_generic")
+
+def test_ir_optimization(tmp_path):
+    tb_file = base_path / 'tests/functional/picorv32_tb.v'
+    cpu_file = base_path / 'tests/functional/picorv32.v'
+    cc_file = tmp_path / 'picorv32_functional_cxx.cc'
+    # the IR optimizer must not grow the design, and on picorv32 it has redundant slices to remove
+    status = subprocess.run([base_path / 'yosys', '-Q', '-p',
+        f"read_verilog {quote(tb_file)} {quote(cpu_file)}; prep -top gold; flatten; clk2fflogic; write_functional_cxx {quote(cc_file)}"],
+        capture_output=True, text=True, check=True)
+    import re
+    counts = re.findall(r'has (\d+) nodes \((\d+) before optimization\)', status.stdout)
+    assert counts
+    for after, before in counts:
+        assert int(after) < int(before)
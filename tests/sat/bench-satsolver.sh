@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+# Compares the built-in SAT solvers on the scripts in this directory. Every script is run <runs> times with each
+# solver selected by `satsolver <name>' and the fastest wall clock time is reported in milliseconds.
+#
+# Usage: ./bench-satsolver.sh [<runs> [<solver>...]]    (defaults: 3 runs, minisat and cdcl)
+set -eu
+cd "$(dirname "$0")"
+
+yosys=../../yosys
+runs=${1:-3}
+shift || true
+solvers=${*:-minisat cdcl}
+
+printf "%-28s" "script"
+for solver in $solvers; do
+	printf " %10s" "$solver"
+done
+printf "\n"
+
+for ys in *.ys; do
+	# selects solvers on its own
+	[ "$ys" = satsolver.ys ] && continue
+	printf "%-28s" "$ys"
+	for solver in $solvers; do
+		best=
+		for ((i = 0; i < runs; i++)); do
+			start=$(date +%s%N)
+			if ! "$yosys" -q -p "satsolver $solver; script $ys" >/dev/null 2>&1 </dev/null; then
+				printf " %10s\n" "FAILED"
+				exit 1
+			fi
+			elapsed=$((($(date +%s%N) - start) / 1000000))
+			if [ -z "$best" ] || [ "$elapsed" -lt "$best" ]; then
+				best=$elapsed
+			fi
+		done
+		printf " %10s" "$best"
+	done
+	printf "\n"
+done
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+# A minimal DPLL solver with SAT competition output, used to test `satsolver -cmd'.
+# With --sleep <seconds> it waits before solving, to test timeouts.
+import sys, time
+
+def solve(clauses, assignment):
+    while True:
+        unit = None
+        remaining = []
+        for clause in clauses:
+            if any(assignment.get(abs(l)) == (l > 0) for l in clause):
+                continue
+            free = [l for l in clause if abs(l) not in assignment]
+            if not free:
+                return None
+            if len(free) == 1:
+                unit = free[0]
+            remaining.append(free)
+        if unit is None:
+            break
+        assignment[abs(unit)] = unit > 0
+        clauses = remaining
+    if not remaining:
+        return assignment
+    var = abs(remaining[0][0])
+    for value in (True, False):
+        result = solve(remaining, {**assignment, var: value})
+        if result is not None:
+            return result
+    return None
+
+if sys.argv[1] == "--sleep":
+    time.sleep(float(sys.argv[2]))
+    del sys.argv[1:3]
+
+clauses, num_vars = [], 0
+with open(sys.argv[1]) as f:
+    for line in f:
+        tokens = line.split()
+        if not tokens or tokens[0] in ("c", "p"):
+            if tokens and tokens[0] == "p":
+                num_vars = int(tokens[2])
+            continue
+        clauses.append([int(t) for t in tokens[:-1]])
+
+sys.setrecursionlimit(100000)
+result = solve(clauses, {})
+if result is None:
+    print("s UNSATISFIABLE")
+    sys.exit(20)
+print("s SATISFIABLE")
+print("v " + " ".join(str(v if result.get(v, False) else -v) for v in range(1, num_vars + 1)) + " 0")
+sys.exit(10)